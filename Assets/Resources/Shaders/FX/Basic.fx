@@ -17,6 +17,15 @@ struct VS_IN
     float3 position : POSITION;
 };
 
+struct VS_INSTANCE_IN
+{
+    float3 position : POSITION;
+    float4 world0 : INSTANCEWORLD0;     //Per-instance world matrix rows
+    float4 world1 : INSTANCEWORLD1;
+    float4 world2 : INSTANCEWORLD2;
+    float4 world3 : INSTANCEWORLD3;
+};
+
 struct VS_OUT
 {
     float4 position : SV_Position; 
@@ -29,6 +38,15 @@ VS_OUT vs_main(VS_IN input)
     return output;
 }
 
+//Instances are transformed by their own world matrix, then by WorldViewProj
+VS_OUT vs_instanced(VS_INSTANCE_IN input)
+{
+    VS_OUT output = (VS_OUT) 0;
+    float4x4 instanceWorld = float4x4(input.world0, input.world1, input.world2, input.world3);
+    output.position = mul(mul(float4(input.position, 1.0f), instanceWorld), WorldViewProj);
+    return output;
+}
+
 float4 ps_main(VS_OUT input) : SV_Target
 {
     return (Colour);
@@ -44,5 +62,18 @@ technique11 main
 
         SetRasterizerState(DisableCulling);
 
+    }
+}
+
+technique11 mainInstanced
+{
+    pass p0
+    {
+        SetVertexShader(CompileShader(vs_5_0, vs_instanced()));
+        SetGeometryShader(NULL);
+        SetPixelShader(CompileShader(ps_5_0, ps_main()));
+
+        SetRasterizerState(DisableCulling);
+
     }
 }
\ No newline at end of file
@@ -61,6 +61,19 @@ struct VS_IN
     float3 binormal : BINORMAL;
 };
 
+struct VS_INSTANCE_IN
+{
+    float3 objPos : POSITION;
+    float2 texCoord : TEXCOORD;
+    float3 normal : NORMAL;
+    float3 tangent : TANGENT;
+    float3 binormal : BINORMAL;
+    float4 world0 : INSTANCEWORLD0;     //Per-instance world matrix rows
+    float4 world1 : INSTANCEWORLD1;
+    float4 world2 : INSTANCEWORLD2;
+    float4 world3 : INSTANCEWORLD3;
+};
+
 struct VS_OUT
 {
     float4 pos : SV_Position;
@@ -90,6 +103,28 @@ VS_OUT vs_main(VS_IN input)
     return output;
 }
 
+//Instances are transformed by their own world matrix, then by World and WorldViewProj
+VS_OUT vs_instanced(VS_INSTANCE_IN input)
+{
+    VS_OUT output = (VS_OUT)0;
+
+    float4x4 instanceWorld = float4x4(input.world0, input.world1, input.world2, input.world3);
+    float4 instancePos = mul(float4(input.objPos, 1.0f), instanceWorld);
+
+    output.pos = mul(instancePos, WorldViewProj);
+    output.texCoord = input.texCoord;
+    output.normal = normalize(mul(mul(float4(input.normal, 0), instanceWorld), World).xyz);
+    output.tangent = normalize(mul(mul(float4(input.tangent, 0), instanceWorld), World).xyz);
+    output.binormal = normalize(mul(mul(float4(input.binormal, 0), instanceWorld), World).xyz);
+    output.lightDir = normalize(lightDirection);
+
+    //Compute the view direction of the camera
+    float3 worldPos = mul(instancePos, World).xyz;
+    output.viewDir = normalize(cameraPosition - worldPos);
+
+    return output;
+}
+
 float4 ps_main(VS_OUT input) : SV_Target
 {
     float4 output = (float4) 0;
@@ -273,3 +308,51 @@ technique11 Specular
     }
 }
 
+technique11 mainInstanced
+{
+    pass p0
+    {
+        SetVertexShader(CompileShader(vs_5_0, vs_instanced()));
+        SetGeometryShader(NULL);
+        SetPixelShader(CompileShader(ps_5_0, ps_main()));
+		
+        SetRasterizerState(DisableCulling);
+    }
+}
+
+technique11 TexturedInstanced
+{
+    pass p0
+    {
+        SetVertexShader(CompileShader(vs_5_0, vs_instanced()));
+        SetGeometryShader(NULL);
+        SetPixelShader(CompileShader(ps_5_0, ps_diffuse()));
+		
+        SetRasterizerState(DisableCulling);
+    }
+}
+
+technique11 AlphaInstanced
+{
+    pass p0
+    {
+        SetVertexShader(CompileShader(vs_5_0, vs_instanced()));
+        SetGeometryShader(NULL);
+        SetPixelShader(CompileShader(ps_5_0, ps_diffuse_normal()));
+		
+        SetRasterizerState(DisableCulling);
+    }
+}
+
+technique11 SpecularInstanced
+{
+    pass p0
+    {
+        SetVertexShader(CompileShader(vs_5_0, vs_instanced()));
+        SetGeometryShader(NULL);
+        SetPixelShader(CompileShader(ps_5_0, ps_diffuse_normal_spec()));
+		
+        SetRasterizerState(DisableCulling);
+        SetBlendState(EnableAlphaBlending, float4(0.0f, 0.0f, 0.0f, 0.0f), 0xFFFFFFFF);
+    }
+}
@@ -0,0 +1,175 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#if defined(_M_X64) || defined(_M_IX86)
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+//Profiler
+//Scoped CPU timing zones. Each thread records its zones' begin and end timestamps into its own buffer without locking,
+//and EndFrame() gathers every thread's zones into a tree of inclusive and exclusive times for the frame.
+//Ewan Burnett - 2022
+
+constexpr bool ENABLE_PROFILING = true;
+
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+
+//Times the rest of the enclosing scope. The name must outlive the profiler, e.g. a string literal.
+#define PROFILE_SCOPE(name) static const Engine::Profiler::Zone PROFILE_CONCAT(profileZone, __LINE__) = { name }; const Engine::Profiler::Scope PROFILE_CONCAT(profileScope, __LINE__)(PROFILE_CONCAT(profileZone, __LINE__))
+#define PROFILE_FUNCTION() PROFILE_SCOPE(__FUNCTION__)
+
+namespace Engine::Profiler
+{
+    /**
+     * \brief A named zone. Declared once per call site by PROFILE_SCOPE().
+     */
+    struct Zone
+    {
+        const char* Name;
+    };
+
+    /**
+     * \brief A zone's time within one frame, at one position in the tree.
+     */
+    struct ZoneStats
+    {
+        const char* Name;
+        uint32_t Depth;         //0 for zones with no parent
+        uint32_t Calls;         //Calls which ended this frame, across every thread
+        double Inclusive;       //Milliseconds, including child zones
+        double Exclusive;       //Milliseconds, excluding child zones
+    };
+
+    /**
+     * \brief Reads the profiler's clock. The time stamp counter where available, as it's the cheapest to read.
+     */
+    inline uint64_t ReadTicks()
+    {
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#else
+        return (uint64_t)std::chrono::steady_clock::now().time_since_epoch().count();
+#endif
+    }
+
+    /**
+     * \brief A thread's zone events. Only the thread writes to it, and only EndFrame() reads from it.
+     */
+    class ThreadBuffer
+    {
+    public:
+        static constexpr uint64_t CAPACITY = 1 << 16;   //Events. Must be a power of two.
+
+        struct Event
+        {
+            const Zone* Opened;     //Null for the end of the innermost open zone
+            uint64_t Ticks;
+        };
+
+        ThreadBuffer() : m_Events(new Event[CAPACITY]) {}
+
+        /**
+         * \brief Records the beginning of a zone.
+         * \return False if the buffer is full, and the zone wasn't recorded.
+         */
+        bool Begin(const Zone* zone)
+        {
+            //Space is kept for the end of every open zone, so that ends are never dropped
+            const uint64_t write = m_Write.load(std::memory_order_relaxed);
+            if (write - m_Read.load(std::memory_order_acquire) + m_Open + 2 > CAPACITY)
+            {
+                return false;
+            }
+
+            m_Events[write & (CAPACITY - 1)] = { zone, ReadTicks() };
+            m_Write.store(write + 1, std::memory_order_release);
+            m_Open++;
+            return true;
+        }
+
+        void End()
+        {
+            const uint64_t ticks = ReadTicks();
+            const uint64_t write = m_Write.load(std::memory_order_relaxed);
+
+            m_Events[write & (CAPACITY - 1)] = { nullptr, ticks };
+            m_Write.store(write + 1, std::memory_order_release);
+            m_Open--;
+        }
+
+    private:
+        friend void EndFrame();
+
+        std::unique_ptr<Event[]> m_Events;
+        alignas(64) std::atomic<uint64_t> m_Write = 0;
+        uint64_t m_Open = 0;
+        alignas(64) std::atomic<uint64_t> m_Read = 0;
+    };
+
+    inline std::atomic<bool> Enabled = true;
+    inline constinit thread_local ThreadBuffer* LocalBuffer = nullptr;
+
+    /**
+     * \brief Creates the calling thread's buffer, on its first zone.
+     */
+    ThreadBuffer* RegisterThread();
+
+    /**
+     * \brief Records a zone for the lifetime of the scope.
+     */
+    class Scope
+    {
+    public:
+        explicit Scope(const Zone& zone)
+        {
+            if (ENABLE_PROFILING && Enabled.load(std::memory_order_relaxed))
+            {
+                ThreadBuffer* buffer = LocalBuffer != nullptr ? LocalBuffer : RegisterThread();
+                m_Buffer = buffer->Begin(&zone) ? buffer : nullptr;
+            }
+        }
+
+        ~Scope()
+        {
+            if (m_Buffer != nullptr)
+            {
+                m_Buffer->End();
+            }
+        }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        ThreadBuffer* m_Buffer = nullptr;
+    };
+
+    /**
+     * \brief Enables or disables recording. Zones which are open keep recording until they end.
+     */
+    void SetEnabled(bool enabled);
+
+    /**
+     * \brief Gathers the zones which ended since the last call into the frame's statistics. Call once per frame.
+     * Zones still open are counted in the frame they end in.
+     */
+    void EndFrame();
+
+    /**
+     * \brief Gets the last frame's zones, in tree order.
+     * Zones are merged across threads by their position in the tree, so inclusive times may exceed the frame's time.
+     */
+    [[nodiscard]]
+    std::vector<ZoneStats> GetFrameStats();
+
+    /**
+     * \brief Logs the last frame's zones, indented by depth.
+     */
+    void LogFrame();
+}
@@ -0,0 +1,143 @@
+#pragma once
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+//Slot Map
+//Stores values in a dense array, addressed by generational handles. Looking a handle up costs an index and a
+//generation check, and handles to removed values are detected rather than aliasing whatever reuses their slot.
+//Ewan Burnett - 2022
+
+namespace Engine
+{
+    /**
+     * \brief A generational index into a SlotMap. The tag makes handles to different resources distinct types.
+     * Default constructed handles are null, and never resolve.
+     */
+    template<typename Tag>
+    struct Handle
+    {
+        uint32_t Index = 0;
+        uint32_t Generation = 0;    //Slots start at generation 1, so 0 is never issued
+
+        [[nodiscard]]
+        bool IsNull() const { return Generation == 0; }
+
+        bool operator==(const Handle& other) const = default;
+    };
+
+    template<typename T, typename Tag>
+    class SlotMap
+    {
+    public:
+        /**
+         * \brief Stores a value, reusing a free slot if there is one.
+         */
+        Handle<Tag> Add(T value)
+        {
+            uint32_t index;
+            if (!m_Free.empty())
+            {
+                index = m_Free.back();
+                m_Free.pop_back();
+            }
+            else
+            {
+                index = (uint32_t)m_Slots.size();
+                m_Slots.emplace_back();
+            }
+
+            Slot& slot = m_Slots[index];
+            slot.Value = std::move(value);
+            slot.Occupied = true;
+            m_Count++;
+
+            return { index, slot.Generation };
+        }
+
+        /**
+         * \brief Resolves a handle.
+         * \return The value, or nullptr if the handle is null or its value has been removed.
+         * The pointer is invalidated by the next call to Add().
+         */
+        [[nodiscard]]
+        T* Get(Handle<Tag> handle)
+        {
+            if (handle.Index >= m_Slots.size() || m_Slots[handle.Index].Generation != handle.Generation || !m_Slots[handle.Index].Occupied)
+            {
+                return nullptr;
+            }
+            return &m_Slots[handle.Index].Value;
+        }
+
+        [[nodiscard]]
+        const T* Get(Handle<Tag> handle) const
+        {
+            return const_cast<SlotMap*>(this)->Get(handle);
+        }
+
+        /**
+         * \brief Removes a value. Handles to it no longer resolve, even once its slot is reused.
+         * \return False if the handle was already stale.
+         */
+        bool Remove(Handle<Tag> handle)
+        {
+            if (Get(handle) == nullptr)
+            {
+                return false;
+            }
+
+            Slot& slot = m_Slots[handle.Index];
+            slot.Value = T{};
+            slot.Occupied = false;
+
+            //Skip 0 when the generation wraps, so that null handles never resolve
+            slot.Generation = slot.Generation == UINT32_MAX ? 1 : slot.Generation + 1;
+
+            m_Free.push_back(handle.Index);
+            m_Count--;
+            return true;
+        }
+
+        /**
+         * \brief Removes every value, invalidating every handle.
+         */
+        void Clear()
+        {
+            for (uint32_t i = 0; i < (uint32_t)m_Slots.size(); i++)
+            {
+                Remove({ i, m_Slots[i].Generation });
+            }
+        }
+
+        /**
+         * \brief Invokes a function on every stored value, with its handle.
+         */
+        template<typename Func>
+        void ForEach(Func&& func)
+        {
+            for (uint32_t i = 0; i < (uint32_t)m_Slots.size(); i++)
+            {
+                if (m_Slots[i].Occupied)
+                {
+                    func(Handle<Tag>{ i, m_Slots[i].Generation }, m_Slots[i].Value);
+                }
+            }
+        }
+
+        [[nodiscard]]
+        uint32_t Count() const { return m_Count; }
+
+    private:
+        struct Slot
+        {
+            T Value = {};
+            uint32_t Generation = 1;
+            bool Occupied = false;
+        };
+
+        std::vector<Slot> m_Slots;
+        std::vector<uint32_t> m_Free;
+        uint32_t m_Count = 0;
+    };
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include "../IO/Logger.h"
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//Worker Pool
+//Persistent threads which run a set of tasks in parallel, and block the caller until all of them have finished.
+//Threads are kept between calls, so short per-frame jobs don't pay for thread creation.
+//Ewan Burnett - 2022
+
+namespace Engine
+{
+    class WorkerPool
+    {
+    public:
+        /**
+         * \brief Starts the pool's threads.
+         * \param threadCount The number of threads which run tasks, including the thread which calls Run().
+         */
+        explicit WorkerPool(uint32_t threadCount);
+        ~WorkerPool();
+
+        WorkerPool(const WorkerPool&) = delete;
+        WorkerPool& operator=(const WorkerPool&) = delete;
+
+        /**
+         * \brief Runs tasks in parallel. The calling thread runs tasks too, and returns once every task has finished.
+         * \param taskCount The number of tasks.
+         * \param task Invoked once per task, with the task's index. Tasks may run in any order, on any thread.
+         */
+        void Run(uint32_t taskCount, const std::function<void(uint32_t task)>& task);
+
+        [[nodiscard]]
+        uint32_t GetThreadCount() const { return (uint32_t)m_Workers.size() + 1; }
+
+    private:
+        void WorkerMain();
+        void RunTasks();
+
+        std::mutex m_Mutex;
+        std::condition_variable m_WorkAvailable;
+        std::condition_variable m_WorkFinished;
+        std::vector<std::thread> m_Workers;
+
+        const std::function<void(uint32_t)>* m_Task = nullptr;
+        uint32_t m_TaskCount = 0;
+        std::atomic<uint32_t> m_NextTask = 0;
+        uint32_t m_Busy = 0;            //Workers which have yet to finish the current job
+        uint64_t m_Job = 0;             //Incremented whenever Run() is called
+        bool m_Stopping = false;
+    };
+}
@@ -1,36 +1,144 @@
 #pragma once
 #include "..\..\Framework.h"
 #include "..\Graphics.h"
+#include "..\Window.h"
+#include "..\VertexLayout.h"
+#include "..\UploadRing.h"
 #include "..\..\Core\Math.h"
+#include "..\..\Core\Time.h"
 #include "..\..\IO\ResourcePool.h"
+#include "..\..\IO\HotReload.h"
 #include "..\..\IO\Logger.h"
 #include "..\..\IO\TypeConversion.h"
 
 #include <d3d11_1.h>
+#include <DirectXMath.h>
 #include <d3dcompiler.h>
 #include <d3dx11effect.h>
 #include <DDSTextureLoader.h>
 #include <WICTextureLoader.h>
 #include <wrl/client.h>
 
+#include <array>
 #include <bitset>
+#include <deque>
+#include <string>
+#include <unordered_map>
 
 namespace Engine
 {
+ /**
+  * \brief Effect variables, resolved from their semantics when a shader is loaded.
+  */
+ enum class EShaderVariable
+ {
+     World = 0,
+     WorldViewProjection,
+     Colour,
+     Ambient,
+     Diffuse,
+     Specular,
+     SpecularPower,
+     Direction,
+     CameraPosition,
+     DiffuseMap,
+     NormalMap,
+     SpecularMap,
+     Atlas,
+     Count
+ };
+
+ /**
+  * \brief A loaded effect, with handles to its variables and techniques, so that draws don't look them up by name.
+  */
+ struct DX11ShaderReflection
+ {
+     Microsoft::WRL::ComPtr<ID3DX11Effect> Effect;
+     std::array<ID3DX11EffectVariable*, (size_t)EShaderVariable::Count> Variables = {};  //nullptr where the effect lacks the variable
+     std::vector<std::pair<std::basic_string<char>, ID3DX11EffectPass*>> Passes;        //The pass of each technique, by technique name
+     Microsoft::WRL::ComPtr<ID3D11InputLayout> InstancedLayout;                          //Created on the shader's first instanced draw
+ };
+
+ /**
+  * \brief Shadows the state bound to a device context, so that redundant binds can be skipped.
+  */
+ struct DX11StateCache
+ {
+     ID3D11Buffer* VertexBuffer = nullptr;
+     UINT VertexStride = 0;
+     ID3D11Buffer* InstanceBuffer = nullptr;
+     ID3D11Buffer* IndexBuffer = nullptr;
+     ID3D11InputLayout* InputLayout = nullptr;
+     D3D11_PRIMITIVE_TOPOLOGY Topology = D3D11_PRIMITIVE_TOPOLOGY_UNDEFINED;
+
+     ID3DX11Effect* Effect = nullptr;
+     std::basic_string<char> Technique;
+     ID3DX11EffectPass* Pass = nullptr;
+     bool PassDirty = true;     //Whether effect variables have changed since the pass was last applied
+
+     //Effect variables persist until they're next set, so the last values set on the current effect are kept
+     const MaterialData* Material = nullptr;    //Forgotten each frame, as materials may be edited between frames
+     bool ObjectSet = false;                    //Whether the per-object matrices below have been set
+     Matrix4x4 World;
+     Matrix4x4 WorldViewProjection;
+
+     std::unordered_map<ID3DX11EffectVariable*, TextureHandle> Textures;   //The texture last set on each effect variable
+
+     RenderStats Stats;
+ };
+
+ /**
+  * \brief The state of a thread which records into a deferred context.
+  */
+ struct DX11Recorder
+ {
+     DX11StateCache State;
+     std::unordered_map<EShaderType, DX11ShaderReflection> Shaders;   //Clones of the backend's shaders, as effects can't be shared between threads
+     Microsoft::WRL::ComPtr<ID3D11CommandList> CommandList;
+ };
+
+ /**
+  * \brief A persistent dynamic buffer, which geometry that only lives for one frame is sub-allocated from.
+  */
+ struct DX11UploadBuffer
+ {
+     Microsoft::WRL::ComPtr<ID3D11Buffer> Buffer;   //Created on first use
+     UploadRing Ring;
+     UINT BindFlags;
+     bool Fresh = true;     //Whether the buffer has yet to be mapped
+ };
+
  class DX11_GFX : public Graphics
  {
  public:
      friend class Engine::Window; 
      friend class Camera;
 
+     ~DX11_GFX();
+
      bool Init(Engine::Window& window, Engine::GraphicsMode mode = {}) override;
      void Draw(Matrix4x4& worldMatrix, const MeshFilter& mesh, const MeshRenderer& renderer, Camera& camera) override;
-     void Draw(Matrix4x4& worldMatrix, const Sprite& sprite, Camera& camera) override;  //TODO: Use a Dynamic Buffer / Sprite Batching to eliminate draw call overheads
+     void Draw(Matrix4x4& worldMatrix, const Sprite& sprite, Camera& camera) override;  //NOTE: Prefer a SpriteBatch when drawing many sprites
+     void Draw(Matrix4x4& worldMatrix, const Text& text, Camera& camera) override;
+     void Draw(const SpriteBatch& batch, Camera& camera) override;
+     void Draw(const RenderQueue& queue, Camera& camera) override;
+     void DrawInstanced(const MeshFilter& mesh, const MeshRenderer& renderer, std::span<const Matrix4x4> worlds, Camera& camera) override;
+     void Draw(const InstanceBatch& batch, Camera& camera) override;
      void Clear(uint8_t r = 0x00, uint8_t g = 0x00, uint8_t b = 0x00, uint8_t a = 0x00) override;
      void Present() override;
      void SetGraphicsMode(const Window& window, GraphicsMode mode) override;
+     void SetSubmissionThreads(uint32_t threadCount) override;
 
  private:
+     void DrawInstances(const MeshFilter& mesh, const MeshRenderer& renderer, UINT firstInstance, UINT instanceCount, Camera& camera);
+     void PrepareCommands(const RenderQueue& queue);
+     void DrawTransient(Matrix4x4& worldMatrix, const MeshFilter& mesh, const MeshRenderer& renderer, Camera& camera);
+     UINT WriteTransient(DX11UploadBuffer& upload, const void* data, UINT size, UINT alignment);
+     void RetireFrames(bool wait);
+     std::function<void()> ReloadAsset(const std::basic_string<wchar_t>& path);
+     void InvalidateState();
+
+     static constexpr UINT TRANSIENT_BUFFER_SIZE = 1 << 20;    //The initial size of each upload ring, in bytes
      
      Microsoft::WRL::ComPtr<ID3D11Device> m_pDevice;
      Microsoft::WRL::ComPtr<ID3D11DeviceContext> m_pContext;
@@ -39,6 +147,27 @@ namespace Engine
      Microsoft::WRL::ComPtr<ID3D11DepthStencilView> m_pDepthStencilView;
 
      std::vector <Microsoft::WRL::ComPtr<ID3D11DeviceContext>> m_DeferredContexts;
+     std::vector<DX11Recorder> m_Recorders;     //One per deferred context
+
+     DX11StateCache m_State;     //Immediate context state
+     std::unordered_map<EShaderType, DX11ShaderReflection> m_Shaders;
+
+     //Dynamic buffers which sprite batches are streamed into
+     Microsoft::WRL::ComPtr<ID3D11Buffer> m_pSpriteVertexBuffer;
+     Microsoft::WRL::ComPtr<ID3D11Buffer> m_pSpriteIndexBuffer;
+
+     //Dynamic buffer which per-instance world matrices are streamed into
+     Microsoft::WRL::ComPtr<ID3D11Buffer> m_pInstanceBuffer;
+
+     //Rings which sprites and text are streamed into, and the fences of the frames which use them
+     DX11UploadBuffer m_TransientVertices = { nullptr, UploadRing(), D3D11_BIND_VERTEX_BUFFER };
+     DX11UploadBuffer m_TransientIndices = { nullptr, UploadRing(), D3D11_BIND_INDEX_BUFFER };
+     std::deque<std::pair<uint64_t, Microsoft::WRL::ComPtr<ID3D11Query>>> m_FrameFences;
+     std::vector<Microsoft::WRL::ComPtr<ID3D11Query>> m_FreeFences;
+     std::vector<float> m_TransientScratch;     //Scratch space for interleaving
+     uint64_t m_Frame = 0;
+
+     uint32_t m_Reloader = 0;    //Swaps changed shaders and textures in, when hot reloading
 
      D3D_FEATURE_LEVEL m_FeatureLevel = {};
      UINT m_MSAAQuality = {0};
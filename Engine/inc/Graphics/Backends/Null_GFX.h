@@ -0,0 +1,129 @@
+#pragma once
+#include "../Graphics.h"
+#include "../VertexLayout.h"
+#include "../UploadRing.h"
+#include "../../Core/Math.h"
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+//Null Graphics
+//A headless backend. Does the same CPU-side work as a device backend - interleaving vertices, caching buffers
+//and tracking bound state - but submits nothing, so render preparation can be measured without a GPU.
+//Ewan Burnett - 2022
+
+namespace Engine
+{
+ class Null_GFX : public Graphics
+ {
+ public:
+     bool Init(Engine::Window& window, Engine::GraphicsMode mode = {}) override;
+
+     /**
+      * \brief Initializes the backend without a window, e.g. in tests and benchmarks.
+      */
+     bool Init(Engine::GraphicsMode mode = {});
+
+     void Draw(Matrix4x4& worldMatrix, const MeshFilter& mesh, const MeshRenderer& renderer, Camera& camera) override;
+     void Draw(Matrix4x4& worldMatrix, const Sprite& sprite, Camera& camera) override;
+     void Draw(Matrix4x4& worldMatrix, const Text& text, Camera& camera) override;
+     void Draw(const SpriteBatch& batch, Camera& camera) override;
+     void Draw(const RenderQueue& queue, Camera& camera) override;
+     void DrawInstanced(const MeshFilter& mesh, const MeshRenderer& renderer, std::span<const Matrix4x4> worlds, Camera& camera) override;
+     void Draw(const InstanceBatch& batch, Camera& camera) override;
+     void Clear(uint8_t r = 0x00, uint8_t g = 0x00, uint8_t b = 0x00, uint8_t a = 0x00) override;
+     void Present() override;
+     void SetGraphicsMode(const Window& window, GraphicsMode mode) override;
+     void SetSubmissionThreads(uint32_t threadCount) override;
+
+     /**
+      * \brief Retrieves the statistics of the frame in progress.
+      */
+     [[nodiscard]]
+     const RenderStats& GetCurrentStats() const { return m_State.Stats; }
+
+     /**
+      * \brief Discards every cached buffer, as though the device had been recreated.
+      * Mesh buffers are shared between instances, so every instance's are discarded.
+      */
+     void ReleaseResources();
+
+ private:
+     //Buffers are identified by ID, as a device would identify them by address. 0 is unbound.
+     static constexpr uint32_t SPRITE_VERTEX_BUFFER = 1;
+     static constexpr uint32_t SPRITE_INDEX_BUFFER = 2;
+     static constexpr uint32_t INSTANCE_BUFFER = 3;
+     static constexpr uint32_t TRANSIENT_VERTEX_BUFFER = 4;
+     static constexpr uint32_t TRANSIENT_INDEX_BUFFER = 5;
+
+     static constexpr uint32_t TRANSIENT_BUFFER_SIZE = 1 << 20;    //Matches DX11_GFX
+     static constexpr uint64_t FRAMES_IN_FLIGHT = 3;
+
+     struct MeshBuffers
+     {
+         uint32_t VertexBuffer;
+         uint32_t IndexBuffer;
+     };
+
+     /**
+      * \brief Shadows the state a device would have bound.
+      */
+     struct NullState
+     {
+         uint32_t VertexBuffer = 0;
+         uint32_t VertexStride = 0;
+         uint32_t InstanceBuffer = 0;
+         uint32_t IndexBuffer = 0;
+         uint32_t InputLayout = UINT32_MAX;
+         uint32_t Topology = UINT32_MAX;
+
+         uint32_t Shader = UINT32_MAX;
+         std::basic_string<char> Technique;
+         bool PassDirty = true;
+
+         //The material and per-object constants last written to the device
+         const MaterialData* Material = nullptr;    //Forgotten each frame, as materials may be edited between frames
+         bool ObjectSet = false;
+         Matrix4x4 World;
+         Matrix4x4 WorldViewProjection;
+
+         std::unordered_map<uint32_t, ResourceID> Textures;     //The texture last set on each shader's texture slots
+
+         RenderStats Stats;
+     };
+
+     static void ResetState(NullState& state);
+     static bool MaterialChanged(const NullState& state, const MeshRenderer& renderer);
+
+     //State is passed explicitly, so that recording threads can each track their own
+     MeshBuffers LoadMesh(NullState& state, const MeshFilter& mesh, EShaderType type);
+     void BindMesh(NullState& state, const MeshFilter& mesh, EShaderType type);
+     void BindVertexBuffer(NullState& state, uint32_t buffer, uint32_t stride);
+     void BindIndexBuffer(NullState& state, uint32_t buffer);
+     void BindInstanceBuffer(NullState& state, uint32_t buffer);
+     void BindTopology(NullState& state, EPrimitiveTopology topology);
+     void BindTexture(NullState& state, EShaderType type, uint32_t slot, const ResourceID& texture);
+     void SetShaderState(NullState& state, const MeshRenderer& renderer, const Matrix4x4& world, Camera& camera, bool materialChanged = true, bool instanced = false);
+     void DrawInstances(const MeshFilter& mesh, const MeshRenderer& renderer, uint32_t instanceCount, Camera& camera);
+     void DrawMesh(NullState& state, const MeshFilter& mesh);
+
+     void PrepareCommands(const RenderQueue& queue);
+     void DrawTransient(Matrix4x4& worldMatrix, const MeshFilter& mesh, const MeshRenderer& renderer, Camera& camera);
+     uint32_t WriteTransient(UploadRing& ring, uint32_t size, uint32_t alignment);
+     void RecordCommands(NullState& state, std::span<const RenderCommand> commands, Camera& camera);
+
+     NullState m_State;
+     std::vector<NullState> m_Recorders;     //One per recording thread
+     std::vector<float> m_Vertices;          //Scratch space for interleaving
+
+     //Meshes find their buffers through MeshFilter::Buffers, so copied and moved meshes keep them.
+     //Shared by every instance, as a device's buffers would be, so that a handle can't resolve to another instance's mesh.
+     static inline SlotMap<MeshBuffers, MeshTag> s_MeshBuffers;
+     static inline uint32_t s_NextBuffer = TRANSIENT_INDEX_BUFFER + 1;
+
+     UploadRing m_TransientVertices;
+     UploadRing m_TransientIndices;
+     uint64_t m_Frame = 0;
+ };
+}
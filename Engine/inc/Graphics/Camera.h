@@ -1,6 +1,7 @@
 #pragma once
-#include "..\Core\Types.h"
-#include <DirectXMath.h>    //TODO: remove this dependency
+#include "../Core/Types.h"
+#include "../Core/Math.h"
+#include "VideoMode.h"
 
 namespace Engine {
     class Camera
@@ -1,7 +1,10 @@
 #pragma once
+#include "../Core/Types.h"
+#include <bitset>
 #include <cstdint>
-#include <map>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 struct Glyph
 {
@@ -9,14 +12,102 @@ struct Glyph
     float y;    //y position (normalized)
     float width;    //Width (normalized)
     float height;   //Height (normalized)
-    uint16_t offsetX;   //Cursor offset X (px)
-    uint16_t offsetY;   //Cursor offset Y (px)
-    uint16_t advanceX;  //Cursor advance X (px)
+    int16_t offsetX;   //Cursor offset X (px)
+    int16_t offsetY;   //Cursor offset Y (px)
+    int16_t advanceX;  //Cursor advance X (px)
 };
 
 struct Font
 {
+    static constexpr uint32_t DENSE_GLYPH_COUNT = 256;  //Glyphs below this ID are stored in a flat array
+
+    /**
+     * \brief Retrieves a glyph by character ID.
+     * \return The glyph, or nullptr if the font doesn't contain it.
+     */
+    const Glyph* GetGlyph(uint32_t id) const
+    {
+        if (id < DENSE_GLYPH_COUNT)
+        {
+            return m_HasGlyph[id] ? &m_Glyphs[id] : nullptr;
+        }
+
+        auto it = m_ExtendedGlyphs.find(id);
+        return it == m_ExtendedGlyphs.end() ? nullptr : &it->second;
+    }
+
+    void AddGlyph(uint32_t id, const Glyph& glyph)
+    {
+        //Track whether every glyph shares the same advance
+        if (m_Glyphs.empty() && m_ExtendedGlyphs.empty())
+        {
+            m_Advance = glyph.advanceX;
+        }
+        else if (glyph.advanceX != m_Advance)
+        {
+            m_FixedAdvance = false;
+        }
+
+        if (id < DENSE_GLYPH_COUNT)
+        {
+            if (m_Glyphs.empty())
+            {
+                m_Glyphs.resize(DENSE_GLYPH_COUNT);
+            }
+            m_Glyphs[id] = glyph;
+            m_HasGlyph[id] = true;
+        }
+        else
+        {
+            m_ExtendedGlyphs[id] = glyph;
+        }
+    }
+
+    /**
+     * \brief Retrieves the horizontal adjustment between two consecutive characters.
+     * \return The adjustment in pixels, or 0 if the pair isn't kerned.
+     */
+    int16_t GetKerning(uint32_t first, uint32_t second) const
+    {
+        //Most characters begin no kerning pairs, so skip the lookup for them
+        if (first < DENSE_GLYPH_COUNT && !m_HasKerning[first])
+        {
+            return 0;
+        }
+
+        auto it = m_Kerning.find(KerningKey(first, second));
+        return it == m_Kerning.end() ? 0 : it->second;
+    }
+
+    void AddKerning(uint32_t first, uint32_t second, int16_t amount)
+    {
+        if (first < DENSE_GLYPH_COUNT)
+        {
+            m_HasKerning[first] = true;
+        }
+        m_Kerning[KerningKey(first, second)] = amount;
+    }
+
+    /**
+     * \brief Returns whether every glyph shares the same advance, with no kerning, so that glyph positions depend only on their index.
+     */
+    bool IsFixedAdvance() const
+    {
+        return m_FixedAdvance && m_Kerning.empty();
+    }
+
+    static uint64_t KerningKey(uint32_t first, uint32_t second)
+    {
+        return ((uint64_t)first << 32) | second;
+    }
+
     std::basic_string<wchar_t> m_Bitmap;
-    std::map<char, Glyph> m_Glyphs;
+    std::vector<Glyph> m_Glyphs;                                //Dense glyphs, indexed by character ID
+    std::bitset<DENSE_GLYPH_COUNT> m_HasGlyph;
+    std::unordered_map<uint32_t, Glyph> m_ExtendedGlyphs;       //Glyphs outside of the dense range
+    std::unordered_map<uint64_t, int16_t> m_Kerning;            //Kerning amounts, keyed by character pair
+    std::bitset<DENSE_GLYPH_COUNT> m_HasKerning;                //Whether a dense glyph begins any kerning pair
+    int16_t m_Advance = 0;
+    bool m_FixedAdvance = true;
     Engine::Vector2f Size;
-};
\ No newline at end of file
+};
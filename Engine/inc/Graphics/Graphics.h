@@ -1,12 +1,19 @@
 #pragma once
-#include "..\Framework.h"
-#include "Window.h"
 #include "Model.h"
 #include "Camera.h"
-#include "../Sprite.h"
+#include "Sprite.h"
+#include "Text.h"
+#include "SpriteBatch.h"
+#include "RenderQueue.h"
+#include "InstanceBatch.h"
+#include "../Core/WorkerPool.h"
+#include <memory>
+#include <span>
 
 namespace Engine
 {
+    class Window;
+
     struct GraphicsMode
     {
         uint16_t xResolution{ 1280 };
@@ -17,6 +24,27 @@ namespace Engine
         bool enableDepthStencil{ true };
         bool isFullscreen{ false };
     };
+
+    /**
+     * \brief Counts the work a backend submitted over one frame.
+     */
+    struct RenderStats
+    {
+        uint32_t DrawCalls = 0;
+        uint32_t Binds = 0;         //State changes sent to the device
+        uint32_t SkippedBinds = 0;  //State changes skipped, as the state was already bound
+        uint64_t BytesUploaded = 0; //Vertex, index and instance data sent to the device
+
+        RenderStats& operator+=(const RenderStats& other)
+        {
+            DrawCalls += other.DrawCalls;
+            Binds += other.Binds;
+            SkippedBinds += other.SkippedBinds;
+            BytesUploaded += other.BytesUploaded;
+            return *this;
+        }
+    };
+
     class Graphics
     {
     public:
@@ -25,12 +53,39 @@ namespace Engine
         virtual bool Init(Window& window, GraphicsMode mode = {}) = 0;
         virtual void Draw(Matrix4x4& worldMatrix, const MeshFilter& mesh, const MeshRenderer& renderer, Camera& camera) = 0;
         virtual void Draw(Matrix4x4& worldMatrix, const Sprite& sprite, Camera& camera) = 0;
+        virtual void Draw(Matrix4x4& worldMatrix, const Text& text, Camera& camera) = 0;
+        virtual void Draw(const SpriteBatch& batch, Camera& camera) = 0;
+        virtual void Draw(const RenderQueue& queue, Camera& camera) = 0;
+        virtual void DrawInstanced(const MeshFilter& mesh, const MeshRenderer& renderer, std::span<const Matrix4x4> worlds, Camera& camera) = 0;
+        virtual void Draw(const InstanceBatch& batch, Camera& camera) = 0;
         virtual void Clear(uint8_t r = 0x00, uint8_t g = 0x00, uint8_t b = 0x00, uint8_t a = 0x00) = 0;
         virtual void Present() = 0;
 
         virtual void SetGraphicsMode(const Window& window, GraphicsMode mode = {}) = 0;
 
+        /**
+         * \brief Sets how many threads record render queues. Large queues are split between the threads, and replayed in order.
+         * \param threadCount The number of recording threads, including the calling thread. 1 records on the calling thread alone.
+         */
+        virtual void SetSubmissionThreads(uint32_t threadCount)
+        {
+            m_Workers = threadCount > 1 ? std::make_unique<WorkerPool>(threadCount) : nullptr;
+        }
+
+        /**
+         * \brief Retrieves the statistics of the last presented frame.
+         */
+        [[nodiscard]]
+        const RenderStats& GetFrameStats() const { return m_FrameStats; }
+
     protected:
         GraphicsMode m_gMode;
+        RenderStats m_FrameStats;
+
+        //Queues are only split once each thread would record at least this many commands
+        static constexpr uint32_t MIN_COMMANDS_PER_THREAD = 128;
+
+        std::unique_ptr<WorkerPool> m_Workers;      //nullptr when recording on the calling thread alone
+        std::vector<CommandRange> m_Ranges;         //Scratch space for partitioning queues
     };
 }
\ No newline at end of file
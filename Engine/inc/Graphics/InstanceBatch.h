@@ -0,0 +1,82 @@
+#pragma once
+#include "Model.h"
+#include <unordered_map>
+#include <vector>
+
+//Instance Batch
+//Collects a frame's repeated meshes, and groups their world matrices by mesh and renderer into a single
+//instance stream. Backends draw each group with one instanced draw call.
+//Ewan Burnett - 2022
+
+namespace Engine
+{
+    /**
+     * \brief A run of instances which share a mesh and renderer.
+     */
+    struct InstanceGroup
+    {
+        const MeshFilter* Mesh;
+        const MeshRenderer* Renderer;
+        uint32_t FirstInstance;     //Index into the batch's instances
+        uint32_t InstanceCount;
+    };
+
+    class InstanceBatch
+    {
+    public:
+        /**
+         * \brief Discards the previous frame's instances. Storage is kept for reuse.
+         */
+        void Begin();
+
+        /**
+         * \brief Adds an instance of a mesh. The mesh and renderer must outlive the frame.
+         */
+        void Add(const MeshFilter& mesh, const MeshRenderer& renderer, const Matrix4x4& world);
+
+        /**
+         * \brief Groups the frame's instances by mesh and renderer.
+         * Groups are ordered by their first instance, and instances within a group keep the order they were added in.
+         */
+        void End();
+
+        [[nodiscard]]
+        const std::vector<Matrix4x4>& GetInstances() const { return m_Instances; }
+
+        [[nodiscard]]
+        const std::vector<InstanceGroup>& GetGroups() const { return m_Groups; }
+
+        [[nodiscard]]
+        uint32_t GetInstanceCount() const { return (uint32_t)m_Queued.size(); }
+
+    private:
+        struct GroupKey
+        {
+            const MeshFilter* Mesh;
+            const MeshRenderer* Renderer;
+
+            bool operator==(const GroupKey& other) const
+            {
+                return Mesh == other.Mesh && Renderer == other.Renderer;
+            }
+        };
+
+        struct GroupKeyHash
+        {
+            size_t operator()(const GroupKey& key) const
+            {
+                return std::hash<const void*>()(key.Mesh) ^ (std::hash<const void*>()(key.Renderer) * 31);
+            }
+        };
+
+        std::vector<Matrix4x4> m_Queued;        //World matrices in the order they were added
+        std::vector<uint32_t> m_QueuedGroups;   //The group of each queued instance
+        std::vector<uint32_t> m_NextInstance;   //Scatter cursor of each group
+
+        std::vector<Matrix4x4> m_Instances;
+        std::vector<InstanceGroup> m_Groups;
+
+        std::unordered_map<GroupKey, uint32_t, GroupKeyHash> m_GroupIDs;
+        uint32_t m_LastGroup = UINT32_MAX;
+    };
+}
@@ -1,6 +1,9 @@
 #pragma once
-#include "..\Core\Types.h"
-#include "..\Core\Math.h"
+#include "../Core/Types.h"
+#include "../Core/Math.h"
+#include "../Core/SlotMap.h"
+#include "../Core/Profiler.h"
+#include "../IO/ResourceID.h"
 #include <string>
 #include <vector>
 
@@ -29,6 +32,36 @@ namespace Engine {
         SpriteRenderer,
     };
 
+    //Handles to resources held by the graphics backend
+    typedef Handle<struct MeshTag> MeshHandle;
+    typedef Handle<struct TextureTag> TextureHandle;
+    typedef Handle<struct ShaderTag> ShaderHandle;
+
+
+    /**
+     * \brief A simplified level of detail of a MeshFilter. LODs share the vertices of their parent mesh.
+     */
+    struct MeshLOD
+    {
+        std::vector<uint32_t> Indices;
+        float Error = 0.0f;     //Object-space geometric error introduced by simplification
+    };
+
+    /**
+     * \brief A cluster of up to 64 vertices and 124 triangles, with bounds for fine-grained culling.
+     */
+    struct Meshlet
+    {
+        uint32_t VertexOffset = 0;      //First entry in MeshFilter::MeshletVertices
+        uint32_t TriangleOffset = 0;    //First entry in MeshFilter::MeshletTriangles
+        uint32_t VertexCount = 0;
+        uint32_t TriangleCount = 0;
+
+        Sphere Bounds = {};             //Object-space bounding sphere
+        Vector3f ConeApex = {};         //Backface culling cone. The cluster is back-facing when
+        Vector3f ConeAxis = {};         //dot(normalize(ConeApex - camera), ConeAxis) >= ConeCutoff
+        float ConeCutoff = 1.0f;
+    };
 
     struct MeshFilter
     {
@@ -41,9 +74,18 @@ namespace Engine {
         std::vector<Vector2f> TexCoords;
         std::vector<Vector4f> VertexColours;
         std::vector<uint32_t> Indices;
+        std::vector<MeshLOD> LODs;      //Simplified index lists, from most to least detailed
+
+        std::vector<Meshlet> Meshlets;
+        std::vector<uint32_t> MeshletVertices;  //Indices into the mesh's vertices
+        std::vector<uint8_t> MeshletTriangles;  //Triangles, as triplets of meshlet-local vertex indices
 
         uint32_t FaceCount = 0;
         uint32_t MaterialIndex = 0;
+
+        //The mesh's device buffers, assigned on first draw. Copies of the mesh share them.
+        //Reset the handle after changing the mesh's geometry, so that new buffers are created.
+        mutable MeshHandle Buffers;
     };
 
     struct MaterialData {};
@@ -71,15 +113,21 @@ namespace Engine {
         Engine::Colour Diffuse = { 0xff, 0xff, 0xff, 0xff };
         Engine::Colour Specular = { 0xff, 0xff, 0xff, 0xff };
         float SpecularPower = 255.0f;
-        std::basic_string<wchar_t> DiffuseMap;
-        std::basic_string<wchar_t> NormalMap;
-        std::basic_string<wchar_t> SpecularMap;
+        ResourceID DiffuseMap;
+        ResourceID NormalMap;
+        ResourceID SpecularMap;
+
+        //Resolved from the IDs on first draw. Reset a handle after changing its map.
+        mutable TextureHandle DiffuseTexture;
+        mutable TextureHandle NormalTexture;
+        mutable TextureHandle SpecularTexture;
     };
 
     struct SpriteRenderer : public Engine::MaterialData
     {
         Engine::Colour Diffuse = { 0xff, 0xff, 0xff, 0xff };
-        std::basic_string<wchar_t> TextureAtlas;
+        ResourceID TextureAtlas;
+        mutable TextureHandle AtlasTexture;     //Resolved from the ID on first draw. Reset it after changing the atlas.
     };
 
     class Model
@@ -91,6 +139,7 @@ namespace Engine {
         std::basic_string<char> source;
         void ComputeWorld(const Vector3f& position = {}, const Vector3f& rotation = {}, const Vector3f& scale = {1.0f, 1.0f, 1.0f})
         {
+            PROFILE_SCOPE("ComputeWorld");
             const Matrix4x4 translation = Math::MatrixTranslation(position);
             const Matrix4x4 eulerRotation = Math::MatrixRotation(rotation);
             const Matrix4x4 scaling = Math::MatrixScaling(scale);
@@ -0,0 +1,127 @@
+#pragma once
+#include "Model.h"
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+//Render Queue
+//Records a frame's draws as compact commands, each with a 64-bit sort key, rather than drawing them
+//immediately. Commands are sorted so that backends can replay them while skipping redundant state changes.
+//Ewan Burnett - 2022
+
+namespace Engine
+{
+    /**
+     * \brief Layers are drawn in order. Each sorts its commands differently.
+     */
+    enum class ERenderLayer : uint8_t
+    {
+        Opaque = 0,     //Sorted by state, then front-to-back
+        Transparent,    //Sorted back-to-front, then by state
+        Overlay,        //Drawn in submission order
+    };
+
+    /**
+     * \brief A recorded draw. The mesh and renderer must outlive the frame the command is submitted in.
+     */
+    struct RenderCommand
+    {
+        uint64_t Key;
+        const MeshFilter* Mesh;
+        const MeshRenderer* Renderer;
+        uint32_t Material;      //Interned material, unique for the frame
+        uint32_t Technique;     //Interned technique
+        Matrix4x4 World;
+    };
+
+    /**
+     * \brief A contiguous run of a queue's sorted commands.
+     */
+    struct CommandRange
+    {
+        uint32_t FirstCommand;
+        uint32_t CommandCount;
+    };
+
+    class RenderQueue
+    {
+    public:
+        //Sort key layout, from most to least significant bit
+        static constexpr uint32_t LAYER_BITS = 4;
+        static constexpr uint32_t SHADER_BITS = 4;
+        static constexpr uint32_t TECHNIQUE_BITS = 8;
+        static constexpr uint32_t MATERIAL_BITS = 24;
+        static constexpr uint32_t DEPTH_BITS = 24;
+
+        /**
+         * \brief Discards the previous frame's commands.
+         * \param viewPosition The position commands are depth-sorted from, e.g. the camera's position.
+         * \param viewForward The direction depth is measured along.
+         */
+        void Begin(const Vector3f& viewPosition, const Vector3f& viewForward);
+
+        /**
+         * \brief Records a draw.
+         * \param world The mesh's world matrix.
+         * \param mesh The mesh to draw.
+         * \param renderer How to draw the mesh.
+         * \param layer The layer to draw the mesh in.
+         */
+        void Submit(const Matrix4x4& world, const MeshFilter& mesh, const MeshRenderer& renderer, ERenderLayer layer = ERenderLayer::Opaque);
+
+        /**
+         * \brief Sorts the frame's commands by key. Commands with equal keys keep their submission order.
+         */
+        void End();
+
+        /**
+         * \brief Retrieves the frame's commands, in draw order. End() must have been called.
+         */
+        [[nodiscard]]
+        const std::vector<RenderCommand>& GetCommands() const { return m_Sorted; }
+
+        [[nodiscard]]
+        uint32_t GetCommandCount() const { return (uint32_t)m_Commands.size(); }
+
+        /**
+         * \brief Splits the sorted commands into contiguous ranges, e.g. to record each on its own thread.
+         * Replaying the ranges in order replays the queue in order. Boundaries are moved onto nearby state changes,
+         * so that a range rarely starts by rebinding the state its predecessor ended with.
+         * \param maxRanges The maximum number of ranges.
+         * \param minCommands The fewest commands worth giving a range of its own.
+         * \param ranges Receives the ranges. Its contents are replaced.
+         */
+        void Partition(uint32_t maxRanges, uint32_t minCommands, std::vector<CommandRange>& ranges) const;
+
+        /**
+         * \brief Builds a sort key.
+         * \param depth The distance along the view direction. Negative depths are clamped to 0.
+         * \param sequence The command's submission index, which orders the Overlay layer.
+         */
+        static uint64_t MakeKey(ERenderLayer layer, EShaderType shader, uint32_t technique, uint32_t material, float depth, uint32_t sequence);
+
+    private:
+        struct SortEntry
+        {
+            uint64_t Key;
+            uint32_t Command;
+        };
+
+        void Sort();
+
+        uint32_t GetMaterialID(const MaterialData* material);
+        uint32_t GetTechniqueID(const std::basic_string<char>& technique);
+
+        std::vector<RenderCommand> m_Commands;      //Commands in submission order
+        std::vector<RenderCommand> m_Sorted;
+        std::vector<SortEntry> m_Entries;
+        std::vector<SortEntry> m_SortScratch;
+
+        Vector3f m_ViewPosition;
+        Vector3f m_ViewForward;
+
+        //Materials are only interned for one frame, as they may be freed between frames
+        std::unordered_map<const MaterialData*, uint32_t> m_MaterialIDs;
+        std::unordered_map<std::basic_string<char>, uint32_t> m_TechniqueIDs;
+    };
+}
@@ -1,6 +1,6 @@
 #pragma once
 #include "Model.h"
-#include "..\Entity/Components.h"
+#include "../Entity/Components.h"
 
 namespace Engine {
     //TODO: Sprite Scaling to Screen, Texture Rects
@@ -0,0 +1,113 @@
+#pragma once
+#include "Sprite.h"
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+//Sprite Batch
+//Collects a frame's sprites, sorts them by texture atlas and technique, and writes their quads into
+//a single vertex stream. Backends draw each batched range with one call.
+//Ewan Burnett - 2022
+
+namespace Engine
+{
+    /**
+     * \brief A sprite vertex. Matches the SpriteRenderer input layout.
+     */
+    struct SpriteVertex
+    {
+        Vector3f Position;
+        Vector2f TexCoord;
+    };
+
+    /**
+     * \brief A run of sprites which share a texture atlas and technique.
+     */
+    struct SpriteBatchRange
+    {
+        uint32_t Texture;       //Index into the batch's textures
+        uint32_t Technique;     //Index into the batch's techniques
+        uint32_t FirstIndex;
+        uint32_t IndexCount;
+    };
+
+    class SpriteBatch
+    {
+    public:
+        /**
+         * \brief Discards the previous frame's sprites. Storage is kept for reuse.
+         */
+        void Begin();
+
+        /**
+         * \brief Adds a sprite, positioned by its own transform.
+         */
+        void Add(const Sprite& sprite);
+
+        /**
+         * \brief Adds a sprite, positioned by a world matrix.
+         */
+        void Add(const Matrix4x4& world, const Sprite& sprite);
+
+        /**
+         * \brief Sorts the frame's sprites and builds the vertex stream and draw ranges.
+         * Sprites which share a texture and technique keep the order they were added in.
+         */
+        void End();
+
+        [[nodiscard]]
+        const std::vector<SpriteVertex>& GetVertices() const { return m_Vertices; }
+
+        [[nodiscard]]
+        const std::vector<uint32_t>& GetIndices() const { return m_Indices; }
+
+        [[nodiscard]]
+        const std::vector<SpriteBatchRange>& GetRanges() const { return m_Ranges; }
+
+        [[nodiscard]]
+        const ResourceID& GetTexture(uint32_t texture) const { return m_Textures[texture]; }
+
+        [[nodiscard]]
+        const std::basic_string<char>& GetTechnique(uint32_t technique) const { return m_Techniques[technique]; }
+
+        [[nodiscard]]
+        uint32_t GetSpriteCount() const { return (uint32_t)m_Keys.size(); }
+
+    private:
+        struct SpriteKey
+        {
+            uint32_t Texture;
+            uint32_t Technique;
+        };
+
+        struct SortEntry
+        {
+            uint32_t Key;       //Texture-major, technique-minor
+            uint32_t Sprite;
+        };
+
+        SpriteVertex* Queue(const Sprite& sprite);
+        void Sort();
+
+        uint32_t GetTextureID(const ResourceID& texture);
+        uint32_t GetTechniqueID(const std::basic_string<char>& technique);
+
+        std::vector<SpriteVertex> m_Queued;     //Quads in the order they were added
+        std::vector<SpriteKey> m_Keys;
+        std::vector<SortEntry> m_Entries;
+        std::vector<SortEntry> m_SortScratch;
+        bool m_InOrder = true;                  //Whether sprites were added already sorted
+
+        std::vector<SpriteVertex> m_Vertices;
+        std::vector<uint32_t> m_Indices;
+        std::vector<SpriteBatchRange> m_Ranges;
+
+        //Textures and techniques are interned, and persist between frames
+        std::vector<ResourceID> m_Textures;
+        std::vector<std::basic_string<char>> m_Techniques;
+        std::unordered_map<ResourceID, uint32_t> m_TextureIDs;
+        std::unordered_map<std::basic_string<char>, uint32_t> m_TechniqueIDs;
+        uint32_t m_LastTexture = UINT32_MAX;
+        uint32_t m_LastTechnique = UINT32_MAX;
+    };
+}
@@ -1,6 +1,6 @@
 #pragma once
 #include "Font.h"
-#include "Sprite.h"
+#include "Model.h"
 #include <string>
 #include <vector>
 
@@ -11,50 +11,289 @@ struct Text
         pFont = &font;
         position = pos;
 
+        auto spr = new Engine::SpriteRenderer;
+        spr->TextureAtlas = font.m_Bitmap;
+
+        m_Renderer = {
+            Engine::EPrimitiveTopology::TriangleList,
+            Engine::EShaderType::SpriteRenderer,
+            spr,
+            "Text"
+        };
+
         SetText(text);
     }
     
+    /**
+     * \brief Records where a glyph came from, so that layout can be resumed from it.
+     */
+    struct GlyphLayout
+    {
+        uint32_t Offset;    //Byte offset of the glyph's character within the string
+        uint32_t Id;        //Character ID
+        float Pen;          //Pen position before the glyph was kerned and placed
+    };
+
+    /**
+     * \brief Changes the displayed string. Only glyphs from the first changed character onwards are laid out again,
+     * and only the changed glyphs are rewritten if the font has a fixed advance. Setting an unchanged string does nothing,
+     * unless the position has changed, in which case the whole string is laid out again.
+     */
     void SetText(std::basic_string<char> text)
     {
-        Engine::Vector2f pos = position;
+        //Cached glyphs were placed relative to the old origin
+        if (position.x != m_Origin.x || position.y != m_Origin.y)
+        {
+            m_Layout.clear();
+            m_Origin = position;
+        }
+
+        if (text == string && !m_Layout.empty())
+        {
+            return;
+        }
 
-        m_Glyphs.clear();
-        m_Glyphs.resize(text.length());
+        //Find the first changed byte, and back up to the start of its character. Nothing is kept if there's no layout to resume from.
+        const size_t common = m_Layout.empty() ? 0 : (text.length() < string.length() ? text.length() : string.length());
+        size_t first = 0;
+        while (first < common && text[first] == string[first])
+        {
+            first++;
+        }
+        while (first > 0 && (IsContinuation(text, first) || IsContinuation(string, first)))
+        {
+            first--;
+        }
 
-        for (auto i = 0; i < text.length(); i++)
+        //Fixed-advance strings of the same length only need their changed glyphs rewritten
+        if (pFont->IsFixedAdvance() && text.length() == string.length() && m_Layout.size() == string.length())
         {
-            auto glyph = text.data()[i];
-            const auto& g = pFont->m_Glyphs.at(glyph);
+            first = ReplaceGlyphs(text, first);
+        }
 
-            Engine::Vector2f size = { (float)g.width, (float)g.height };
-            Engine::Vector2f glyphPos = { pos.x + g.offsetX, pos.y + g.offsetY };
-            Engine::Rect texRect = 
+        if (first < text.length() || text.length() != string.length() || m_Layout.empty())
+        {
+            //Resume layout from the first glyph at or after the change
+            size_t glyph = 0;
+            while (glyph < m_Layout.size() && m_Layout[glyph].Offset < first)
             {
-                (float)g.x,
-                (float)g.y,
-                (float)(g.x + (g.width / pFont->Size.x)),
-                (float)(g.y + (g.height / pFont->Size.x))
-            };
+                glyph++;
+            }
 
-            Engine::Sprite spr(pFont->m_Bitmap, size, glyphPos, texRect);
-            //spr.SetTextureRect(texRect);
-            spr.m_Sprite.Name = glyph;
-            spr.m_Renderer.technique = "Text";
-            m_Glyphs.push_back(spr);
+            Engine::Vector2f pen = position;
+            pen.x = glyph < m_Layout.size() ? m_Layout[glyph].Pen : (glyph > 0 ? m_EndPen : position.x);
+            const uint32_t previous = glyph > 0 ? m_Layout[glyph - 1].Id : 0;
 
+            m_Layout.resize(glyph);
+            m_Mesh.Vertices.resize(glyph * 4);
+            m_Mesh.TexCoords.resize(glyph * 4);
+            m_Mesh.Indices.resize(glyph * 6);
 
-            pos.x += g.advanceX;
+            m_EndPen = Layout(*pFont, text, first, pen, previous, m_Mesh, &m_Layout);
         }
 
-        m_Glyphs.shrink_to_fit();
-
         string = text;
+    }
+
+    /**
+     * \brief Lays out a string as a list of textured quads, two triangles per glyph.
+     * The mesh's existing storage is reused, so rebuilding a string of similar length doesn't allocate.
+     * \param font The font to lay the string out with.
+     * \param text The UTF-8 string to lay out.
+     * \param origin The position of the pen at the start of the string, in pixels.
+     * \param mesh Receives the string's positions, atlas coordinates and indices.
+     * \return The number of glyphs written.
+     */
+    static uint32_t BuildMesh(const Font& font, const std::basic_string<char>& text, Engine::Vector2f origin, Engine::MeshFilter& mesh)
+    {
+        mesh.Vertices.clear();
+        mesh.TexCoords.clear();
+        mesh.Indices.clear();
 
+        Layout(font, text, 0, origin, 0, mesh);
+        return (uint32_t)(mesh.Indices.size() / 6);
     }
 
-    
+    /**
+     * \brief Appends the glyphs of a string, from a byte offset onwards, to a mesh.
+     * \param font The font to lay the string out with.
+     * \param text The UTF-8 string to lay out.
+     * \param offset The byte offset to start from. Must be the start of a character.
+     * \param pen The position of the pen at the offset.
+     * \param previous The ID of the glyph before the offset, for kerning. 0 if there is none.
+     * \param mesh The mesh to append to.
+     * \param layout (Optional) Receives a record of each glyph appended.
+     * \return The position of the pen after the last glyph.
+     */
+    static float Layout(const Font& font, const std::basic_string<char>& text, size_t offset, Engine::Vector2f pen, uint32_t previous, Engine::MeshFilter& mesh, std::vector<GlyphLayout>* layout = nullptr)
+    {
+        //Each byte produces at most one glyph
+        const size_t remaining = text.length() - offset;
+        mesh.Vertices.reserve(mesh.Vertices.size() + remaining * 4);
+        mesh.TexCoords.reserve(mesh.TexCoords.size() + remaining * 4);
+        mesh.Indices.reserve(mesh.Indices.size() + remaining * 6);
+
+        for (size_t i = offset; i < text.length();)
+        {
+            const uint32_t characterOffset = (uint32_t)i;
+            const uint32_t id = NextCharacter(text, i);
+            const Glyph* g = font.GetGlyph(id);
+            if (g == nullptr)
+            {
+                continue;
+            }
+
+            if (layout != nullptr)
+            {
+                layout->push_back({ characterOffset, id, pen.x });
+            }
+
+            pen.x += font.GetKerning(previous, id);
+            previous = id;
+
+            const size_t glyph = mesh.Vertices.size() / 4;
+            mesh.Vertices.resize(mesh.Vertices.size() + 4);
+            mesh.TexCoords.resize(mesh.TexCoords.size() + 4);
+            WriteGlyph(font, *g, pen, mesh, glyph);
+
+            const uint32_t base = (uint32_t)glyph * 4;
+            mesh.Indices.push_back(base);
+            mesh.Indices.push_back(base + 1);
+            mesh.Indices.push_back(base + 2);
+            mesh.Indices.push_back(base);
+            mesh.Indices.push_back(base + 2);
+            mesh.Indices.push_back(base + 3);
+
+            pen.x += g->advanceX;
+        }
+
+        return pen.x;
+    }
+
+    /**
+     * \brief Writes the positions and atlas coordinates of a glyph's quad.
+     * \param font The glyph's font.
+     * \param g The glyph.
+     * \param pen The position of the pen, after kerning.
+     * \param mesh The mesh to write to. Must already hold the quad's vertices.
+     * \param glyph The index of the quad within the mesh.
+     */
+    static void WriteGlyph(const Font& font, const Glyph& g, Engine::Vector2f pen, Engine::MeshFilter& mesh, size_t glyph)
+    {
+        const float left = pen.x + g.offsetX;
+        const float top = pen.y + g.offsetY;
+        const float right = left + g.width;
+        const float bottom = top + g.height;
+
+        //Atlas coordinates
+        const float u0 = g.x;
+        const float v0 = g.y;
+        const float u1 = g.x + (g.width / font.Size.x);
+        const float v1 = g.y + (g.height / font.Size.y);
+
+        Engine::Vector3f* v = &mesh.Vertices[glyph * 4];
+        v[0] = { left, top, 0.0f };
+        v[1] = { right, top, 0.0f };
+        v[2] = { right, bottom, 0.0f };
+        v[3] = { left, bottom, 0.0f };
+
+        Engine::Vector2f* t = &mesh.TexCoords[glyph * 4];
+        t[0] = { u0, v0 };
+        t[1] = { u1, v0 };
+        t[2] = { u1, v1 };
+        t[3] = { u0, v1 };
+    }
+
+    /**
+     * \brief Decodes the next UTF-8 character from a string.
+     * \param text The string to decode.
+     * \param i The index of the character's first byte. Advanced past the character.
+     * \return The character ID.
+     */
+    static uint32_t NextCharacter(const std::basic_string<char>& text, size_t& i)
+    {
+        const uint8_t lead = (uint8_t)text[i++];
+        if (lead < 0x80)
+        {
+            return lead;
+        }
+
+        //Determine the length of the sequence from its lead byte
+        uint32_t id = 0;
+        size_t continuation = 0;
+        if ((lead & 0xE0) == 0xC0)
+        {
+            id = lead & 0x1F;
+            continuation = 1;
+        }
+        else if ((lead & 0xF0) == 0xE0)
+        {
+            id = lead & 0x0F;
+            continuation = 2;
+        }
+        else if ((lead & 0xF8) == 0xF0)
+        {
+            id = lead & 0x07;
+            continuation = 3;
+        }
+        else
+        {
+            //Treat stray bytes as Latin-1
+            return lead;
+        }
+
+        for (; continuation > 0 && i < text.length() && ((uint8_t)text[i] & 0xC0) == 0x80; continuation--)
+        {
+            id = (id << 6) | ((uint8_t)text[i++] & 0x3F);
+        }
+
+        return id;
+    }
+
+private:
+    static bool IsContinuation(const std::basic_string<char>& text, size_t i)
+    {
+        return i < text.length() && ((uint8_t)text[i] & 0xC0) == 0x80;
+    }
+
+    /**
+     * \brief Rewrites the glyphs which differ from the current string in place. Requires a fixed-advance font,
+     * a string of the same length, and a layout with one glyph per byte.
+     * \return The byte offset from which the string must be laid out normally, or the string's length if every glyph was replaced.
+     */
+    size_t ReplaceGlyphs(const std::basic_string<char>& text, size_t first)
+    {
+        for (size_t i = first; i < text.length(); i++)
+        {
+            if (text[i] == string[i])
+            {
+                continue;
+            }
+
+            //Multi-byte and missing characters change the number of glyphs
+            const uint8_t id = (uint8_t)text[i];
+            const Glyph* g = id < 0x80 ? pFont->GetGlyph(id) : nullptr;
+            if (g == nullptr)
+            {
+                return i;
+            }
+
+            m_Layout[i].Id = id;
+            WriteGlyph(*pFont, *g, { m_Layout[i].Pen, position.y }, m_Mesh, i);
+        }
+
+        return text.length();
+    }
+
+public:
     Font* pFont;
     std::basic_string<char> string;
     Engine::Vector2f position;
-    std::vector<Engine::Sprite> m_Glyphs;
+    Engine::MeshFilter m_Mesh;          //Every glyph in the string, as one quad list
+    Engine::MeshRenderer m_Renderer;
+
+private:
+    std::vector<GlyphLayout> m_Layout;  //One record per glyph in m_Mesh
+    Engine::Vector2f m_Origin = {};     //The position m_Layout was laid out from
+    float m_EndPen = 0.0f;              //Position of the pen after the last glyph
 };
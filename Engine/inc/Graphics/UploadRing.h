@@ -0,0 +1,81 @@
+#pragma once
+#include <cstdint>
+#include <deque>
+
+//Upload Ring
+//Sub-allocates a persistent buffer as a ring, for geometry which only lives for one frame.
+//Each frame's allocations are fenced together, and their space is reused once the frame is retired.
+//The ring only tracks offsets, so backends decide what the buffer is, and when a frame has finished on the device.
+//Ewan Burnett - 2022
+
+namespace Engine
+{
+    class UploadRing
+    {
+    public:
+        explicit UploadRing(uint32_t capacity = 0) { Reset(capacity); }
+
+        /**
+         * \brief Discards every allocation, e.g. once the buffer has been recreated.
+         * \param capacity The size of the buffer, in bytes.
+         */
+        void Reset(uint32_t capacity);
+
+        /**
+         * \brief Allocates space in the current frame.
+         * \param size The size of the allocation, in bytes.
+         * \param alignment The allocation's offset is a multiple of this. Needn't be a power of two, e.g. a vertex stride.
+         * \param offset Receives the allocation's offset into the buffer.
+         * \return False if there isn't enough free space. Retiring frames may free some.
+         */
+        bool Allocate(uint32_t size, uint32_t alignment, uint32_t& offset);
+
+        /**
+         * \brief Closes the current frame. Its allocations remain in use until the fence is retired.
+         * \param fence Identifies the frame. Fences must increase from frame to frame.
+         */
+        void EndFrame(uint64_t fence);
+
+        /**
+         * \brief Frees the allocations of every frame up to, and including, a fence.
+         */
+        void Retire(uint64_t fence);
+
+        /**
+         * \brief Whether any closed frames are still in use.
+         */
+        [[nodiscard]]
+        bool HasFramesInFlight() const { return !m_Frames.empty(); }
+
+        /**
+         * \brief The fence of the oldest frame still in use. HasFramesInFlight() must be true.
+         */
+        [[nodiscard]]
+        uint64_t GetOldestFence() const { return m_Frames.front().Fence; }
+
+        [[nodiscard]]
+        uint32_t GetCapacity() const { return m_Capacity; }
+
+        /**
+         * \brief The bytes in use, including padding and space skipped when wrapping.
+         */
+        [[nodiscard]]
+        uint32_t GetUsed() const { return m_Used; }
+
+    private:
+        struct Frame
+        {
+            uint64_t Fence;
+            uint32_t End;       //The head when the frame was closed
+            uint32_t Size;      //Bytes the frame consumed
+        };
+
+        std::deque<Frame> m_Frames;
+
+        uint32_t m_Capacity = 0;
+        uint32_t m_Head = 0;        //Where the next allocation starts
+        uint32_t m_Tail = 0;        //The start of the oldest allocation still in use
+        uint32_t m_Used = 0;
+        uint32_t m_FrameSize = 0;   //Bytes consumed by the current frame
+    };
+}
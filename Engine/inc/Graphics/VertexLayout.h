@@ -0,0 +1,35 @@
+#pragma once
+#include "Model.h"
+#include <bitset>
+#include <vector>
+
+//Vertex Layout
+//Describes the vertex attributes each shader reads, and interleaves meshes into that layout.
+//Shared by the graphics backends, so that every backend uploads identical vertex data.
+//Ewan Burnett - 2022
+
+namespace Engine
+{
+    namespace VertexLayout
+    {
+        /**
+         * \brief Retrieves the attributes a shader reads from each vertex, indexed by EVertexAttributes.
+         */
+        [[nodiscard]]
+        std::bitset<10> GetAttributes(EShaderType type);
+
+        /**
+         * \brief Retrieves the size of a shader's vertices, in floats.
+         */
+        [[nodiscard]]
+        uint32_t GetVertexSize(EShaderType type);
+
+        /**
+         * \brief Interleaves a mesh's vertex attributes into the layout a shader expects.
+         * \param mesh The mesh to interleave. Attributes the mesh lacks are zeroed.
+         * \param type The shader the vertices are for.
+         * \param vertices Receives the interleaved vertices. Its contents are replaced.
+         */
+        void Interleave(const MeshFilter& mesh, EShaderType type, std::vector<float>& vertices);
+    }
+}
@@ -0,0 +1,33 @@
+#pragma once
+#include <cstdint>
+
+//Video Mode
+//Describes the application window's display mode. Kept apart from the window itself, so that code which only
+//needs the window's dimensions, such as cameras and headless backends, doesn't depend on the platform.
+//Ewan Burnett - 2022
+
+namespace Engine {
+    //Describes the window display mode of the application.
+    enum class EDisplayModes
+    {
+        Windowed = 0x00,
+        Borderless,
+        Fullscreen,
+    };
+
+    /**
+     * \brief VideoMode describes the attributes of the application window:
+     * \param width The width of the window (in pixels)
+     * \param height The height of the window (in pixels)
+     * \param refreshRate The window's refresh rate (in Hz)
+     * \param adapterIndex Which display adapter to target
+     * \param isFullscreen Whether the window is in fullscreen mode or not.
+     */
+    struct VideoMode {
+        uint16_t width{ 1280 };     //Horizontal width of the window, in pixels
+        uint16_t height{ 720 };     //Vertical height of the window, in pixels
+        uint8_t refreshRate{ 60 };  //Window Refresh Rate (Hz)
+        uint8_t adapterIndex{ 0 };  //Which adapter to target
+        EDisplayModes displayMode{ EDisplayModes::Windowed };
+    };
+}
@@ -0,0 +1,124 @@
+#pragma once
+#include <cstdint>
+#include <span>
+#include <streambuf>
+#include <istream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+//Archive
+//Pack files, which concatenate cooked assets behind a hashed central directory.
+//Mounted packs are memory-mapped once, and files within them are resolved by path hash.
+//Ewan Burnett - 2022
+
+namespace Engine::Archive
+{
+    constexpr uint32_t ARCHIVE_MAGIC = 0x4B415043;     //"CPAK"
+    constexpr uint16_t ARCHIVE_VERSION = 1;
+    constexpr uint64_t ARCHIVE_ALIGNMENT = 16;          //Alignment of each file's data within the pack
+    constexpr uint64_t DIRECTORY_ALIGNMENT = 64;        //Alignment of the central directory
+
+    /**
+     * \brief The header at the start of every pack file.
+     */
+    struct Header
+    {
+        uint32_t Magic;
+        uint16_t Version;
+        uint16_t Reserved;
+        uint32_t FileCount;
+        uint32_t SlotCount;         //Number of directory slots. Always a power of two.
+        uint64_t DirectoryOffset;
+        uint64_t PathsOffset;
+        uint64_t PathsSize;
+    };
+
+    /**
+     * \brief A slot in the central directory. Slots with a Hash of 0 are empty.
+     */
+    struct DirectoryEntry
+    {
+        uint64_t Hash;
+        uint64_t Offset;
+        uint64_t Size;
+        uint32_t PathOffset;        //Offset of the normalized path, relative to the path table
+        uint32_t PathLength;
+    };
+
+    /**
+     * \brief Normalizes a path for lookup: lowercase, with '\\' separators and no leading ".\\".
+     */
+    [[nodiscard]]
+    std::basic_string<char> NormalizePath(std::string_view path);
+
+    [[nodiscard]]
+    std::basic_string<char> NormalizePath(std::wstring_view path);
+
+    /**
+     * \brief Hashes a path, using 64-bit FNV-1a over its normalized form.
+     * \return The path's hash. Never 0.
+     */
+    [[nodiscard]]
+    uint64_t HashPath(std::string_view path);
+
+    [[nodiscard]]
+    uint64_t HashPath(std::wstring_view path);
+
+    /**
+     * \brief Packs a set of files into a new pack file.
+     * \param files The paths of the files to pack. Files are stored under the path they are read from.
+     * \param archivePath The path of the pack to write.
+     * \return True if every file was packed.
+     */
+    bool Build(const std::vector<std::basic_string<char>>& files, const std::basic_string<char>& archivePath);
+
+    /**
+     * \brief Memory-maps a pack file, and makes its files available to Find().
+     * Packs mounted later take priority over earlier packs. Packs may be mounted while other threads find files.
+     * \param archivePath The path of the pack to mount.
+     * \return True if the pack was mounted.
+     */
+    bool Mount(const std::basic_string<char>& archivePath);
+
+    /**
+     * \brief Unmaps every mounted pack. Spans returned by Find() are invalidated, so no other thread may still be using them.
+     */
+    void UnmountAll();
+
+    /**
+     * \brief Looks up a file within the mounted packs.
+     * \param path The path of the file.
+     * \return A view of the file's data, which remains valid until the pack is unmounted. Empty if the file was not found.
+     */
+    [[nodiscard]]
+    std::span<const uint8_t> Find(std::string_view path);
+
+    [[nodiscard]]
+    std::span<const uint8_t> Find(std::wstring_view path);
+
+    /**
+     * \brief A read-only, seekable stream buffer over a block of memory.
+     */
+    class MemoryStreamBuf : public std::streambuf
+    {
+    public:
+        MemoryStreamBuf(std::span<const uint8_t> data);
+
+    protected:
+        pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) override;
+        pos_type seekpos(pos_type pos, std::ios_base::openmode which) override;
+    };
+
+    /**
+     * \brief An input stream over a file within a mounted pack.
+     */
+    class MemoryStream : public std::istream
+    {
+    public:
+        MemoryStream(std::span<const uint8_t> data);
+
+    private:
+        MemoryStreamBuf m_Buffer;
+    };
+}
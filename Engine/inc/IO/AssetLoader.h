@@ -0,0 +1,134 @@
+#pragma once
+#include "../Graphics/Model.h"
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+//Asset Loader
+//Streams models in on background threads. Requests are serviced in priority order, and finished
+//models are handed back to the main thread when Poll() is called, once per frame.
+//Ewan Burnett - 2022
+
+namespace Engine
+{
+    typedef uint64_t LoadHandle;
+    constexpr LoadHandle INVALID_LOAD_HANDLE = 0;
+
+    /**
+     * \brief Invoked on the main thread, from Poll(), once a model has finished loading.
+     */
+    typedef std::function<void(LoadHandle handle, Model& model)> LoadCallback;
+
+    class AssetLoader
+    {
+    public:
+        /**
+         * \brief Starts the loader's worker threads.
+         * \param workerCount The number of worker threads.
+         * \param maxInFlight The maximum number of loads which may be in progress, or awaiting Poll(), at once.
+         */
+        AssetLoader(uint32_t workerCount = 2, uint32_t maxInFlight = 4);
+        ~AssetLoader();
+
+        AssetLoader(const AssetLoader&) = delete;
+        AssetLoader& operator=(const AssetLoader&) = delete;
+
+        /**
+         * \brief Queues a model to be loaded in the background.
+         * \param filePath The path to the model, or its serialized .Asset.
+         * \param priority Higher priority requests are loaded first.
+         * \param callback Receives the loaded model on the main thread.
+         * \return A handle to the request.
+         */
+        LoadHandle Load(const std::basic_string<char>& filePath, float priority, LoadCallback callback);
+
+        /**
+         * \brief Cancels a request. Its callback will not be invoked.
+         * Loads which are already in progress finish in the background, and their result is discarded.
+         * \return True if the request was still pending.
+         */
+        bool Cancel(LoadHandle handle);
+
+        /**
+         * \brief Changes the priority of a queued request, e.g. as the camera approaches the model.
+         * \return True if the request was still queued.
+         */
+        bool SetPriority(LoadHandle handle, float priority);
+
+        /**
+         * \brief Invokes the callbacks of finished loads. Call once per frame, from the main thread.
+         * \param maxCompletions The maximum number of callbacks to invoke this frame.
+         * \return The number of callbacks invoked.
+         */
+        uint32_t Poll(uint32_t maxCompletions = UINT32_MAX);
+
+        /**
+         * \brief Returns the number of requests which are queued, loading, or awaiting Poll().
+         */
+        [[nodiscard]]
+        uint32_t Pending();
+
+    private:
+        enum class ERequestState
+        {
+            Queued,
+            Loading,
+            Complete,
+        };
+
+        struct Request
+        {
+            std::basic_string<char> FilePath;
+            LoadCallback Callback;
+            Model Result;
+            float Priority = 0.0f;
+            uint64_t Sequence = 0;
+            uint32_t Version = 0;       //Incremented whenever the request is re-queued
+            ERequestState State = ERequestState::Queued;
+            bool Cancelled = false;
+        };
+
+        /**
+         * \brief A queued request. Entries are invalidated lazily, when their version no longer matches the request.
+         */
+        struct QueueEntry
+        {
+            float Priority;
+            uint64_t Sequence;          //Orders equal priorities first-come, first-served
+            LoadHandle Handle;
+            uint32_t Version;
+
+            bool operator<(const QueueEntry& other) const
+            {
+                if (Priority != other.Priority)
+                {
+                    return Priority < other.Priority;
+                }
+                return Sequence > other.Sequence;
+            }
+        };
+
+        void WorkerMain();
+        void Push(LoadHandle handle, const Request& request);
+        bool PopValid(LoadHandle& handle);
+
+        std::mutex m_Mutex;
+        std::condition_variable m_WorkAvailable;
+        std::vector<std::thread> m_Workers;
+
+        std::unordered_map<LoadHandle, Request> m_Requests;
+        std::priority_queue<QueueEntry> m_Queue;
+        std::vector<LoadHandle> m_Completed;
+
+        LoadHandle m_NextHandle;
+        uint64_t m_NextSequence;
+        uint32_t m_InFlight;
+        uint32_t m_MaxInFlight;
+        bool m_Stopping;
+    };
+}
@@ -0,0 +1,64 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+
+//Compression
+//Block compression used by cooked .Asset sections. The LZ codec follows the LZ4 block format:
+//a sequence of (literal run, back-reference) pairs, which decodes without any entropy stage.
+//Ewan Burnett - 2022
+
+namespace Engine::Compression
+{
+    enum class ECodec : uint8_t
+    {
+        None = 0,
+        LZ,
+    };
+
+    enum class EFilter : uint8_t
+    {
+        None = 0,
+        Shuffle,    //Groups the n-th byte of every element together. Improves the ratio of float streams.
+    };
+
+    /**
+     * \brief Returns the largest possible compressed size of a block.
+     * \param size The uncompressed size, in bytes.
+     */
+    [[nodiscard]]
+    size_t CompressBound(size_t size);
+
+    /**
+     * \brief Compresses a block using the LZ codec.
+     * \param src The data to compress.
+     * \param srcSize The size of the data, in bytes.
+     * \param dst The output buffer. Must hold at least CompressBound(srcSize) bytes.
+     * \param dstCapacity The size of the output buffer.
+     * \return The compressed size, or 0 if the output buffer was too small.
+     */
+    size_t Compress(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstCapacity);
+
+    /**
+     * \brief Decompresses an LZ block directly into its destination.
+     * \param src The compressed block.
+     * \param srcSize The size of the compressed block, in bytes.
+     * \param dst The output buffer.
+     * \param dstSize The exact uncompressed size of the block.
+     * \return True if the block was valid and filled the output buffer exactly.
+     */
+    bool Decompress(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstSize);
+
+    /**
+     * \brief Transposes the bytes of a stream of fixed-width elements.
+     * \param src The source stream.
+     * \param dst The shuffled stream. Must not overlap src.
+     * \param size The size of the stream, in bytes. Trailing bytes of a partial element are copied as-is.
+     * \param elementWidth The width of each element, in bytes.
+     */
+    void Shuffle(const uint8_t* src, uint8_t* dst, size_t size, size_t elementWidth);
+
+    /**
+     * \brief Reverses Shuffle().
+     */
+    void Unshuffle(const uint8_t* src, uint8_t* dst, size_t size, size_t elementWidth);
+}
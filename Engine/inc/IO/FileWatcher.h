@@ -0,0 +1,55 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+//File Watcher
+//Watches a directory tree for modified files on a background thread.
+//Editors often save a file in several writes, so a change is only reported once the file has been quiet for a moment.
+//Ewan Burnett - 2022
+
+namespace Engine
+{
+    class FileWatcher
+    {
+    public:
+        typedef std::function<void(const std::basic_string<wchar_t>& path)> Callback;
+
+        /**
+         * \brief Starts watching a directory, and its subdirectories.
+         * \param directory The directory to watch. Reported paths start with it.
+         * \param onChanged Invoked on the watcher's thread, once per modified file.
+         */
+        FileWatcher(const std::basic_string<wchar_t>& directory, Callback onChanged);
+        ~FileWatcher();
+
+        FileWatcher(const FileWatcher&) = delete;
+        FileWatcher& operator=(const FileWatcher&) = delete;
+
+    private:
+        void WatchMain();
+
+        /**
+         * \brief Notes that a file was written. Repeated writes restart its quiet period.
+         */
+        void Record(const std::basic_string<wchar_t>& path);
+
+        /**
+         * \brief Reports the files which have been quiet for long enough.
+         */
+        void Flush();
+
+        static constexpr std::chrono::milliseconds SETTLE_TIME{ 100 };  //How long a file must go unwritten before it's reported
+        static constexpr int POLL_INTERVAL_MS = 50;                     //How often the thread checks whether it should stop
+
+        std::basic_string<wchar_t> m_Directory;
+        Callback m_OnChanged;
+        std::unordered_map<std::basic_string<wchar_t>, std::chrono::steady_clock::time_point> m_Pending;    //Only used by the watcher's thread
+
+        std::atomic<bool> m_Stopping = false;
+        std::thread m_Thread;
+    };
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <string>
+
+//Hot Reload
+//Reloads assets as they change on disk. Changed files are reloaded on a background thread, and the
+//results are swapped in at a frame boundary, so that the resources in use never change mid-frame.
+//Ewan Burnett - 2022
+
+namespace Engine::HotReload
+{
+    /**
+     * \brief Reloads a changed file. Invoked on the watcher's thread, so should do the slow work, e.g. reading and compiling.
+     * \param path The changed file's path.
+     * \return Swaps the reloaded asset in. Invoked by Apply(). Return an empty function to ignore the file.
+     */
+    typedef std::function<std::function<void()>(const std::basic_string<wchar_t>& path)> Reloader;
+
+    /**
+     * \brief Starts watching a directory for changes.
+     * \param directory The directory to watch, including its subdirectories.
+     */
+    void Start(const std::basic_string<wchar_t>& directory = L"Resources");
+    void Stop();
+
+    /**
+     * \brief Registers a reloader, which is offered every changed file.
+     * \return An ID for unregistering the reloader.
+     */
+    uint32_t Register(Reloader reloader);
+
+    /**
+     * \brief Unregisters a reloader, and discards any of its reloads which have yet to be applied.
+     * Waits for the reloader to return, if it's running.
+     */
+    void Unregister(uint32_t id);
+
+    /**
+     * \brief Swaps reloaded assets in. Call at a frame boundary, on the thread which draws.
+     * \return The number of assets swapped in.
+     */
+    uint32_t Apply();
+}
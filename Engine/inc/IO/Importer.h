@@ -1,14 +1,18 @@
 #pragma once
-#include "..\Graphics\Model.h"
-#include "..\Graphics/Font.h"
+#include "../Graphics/Model.h"
+#include "../Graphics/Font.h"
 #include <iostream>
 #include <fstream>
-#include <direct.h>
 #include <string>
 #include "TypeConversion.h"
 #include "Logger.h"
+#include "MeshOptimizer.h"
+#include "Compression.h"
+#include "Archive.h"
+#include <memory>
 
-constexpr uint16_t ASSET_VERSION = 1;
+constexpr uint16_t ASSET_VERSION = 4;
+constexpr uint16_t ASSET_MIN_VERSION = 1;  //Oldest asset version which can still be loaded
 
 namespace Engine {
     class Texture;
@@ -19,7 +23,7 @@ namespace Engine {
         void LoadFromFile(Model& model, const std::basic_string<char>& filePath);
         void LoadFromFile(Font& font, const std::basic_string<char> filePath);
 
-        void ImportModelFromMemory(Model& model, std::basic_string<char> destPath);
-        Model ImportModelFromFile(const std::basic_string<char>& filePath, std::basic_string<char> destPath = "");
+        void ImportModelFromMemory(Model& model, std::basic_string<char> destPath, Compression::ECodec codec = Compression::ECodec::LZ);
+        Model ImportModelFromFile(const std::basic_string<char>& filePath, std::basic_string<char> destPath = "", Compression::ECodec codec = Compression::ECodec::LZ);
     };
 }
\ No newline at end of file
@@ -0,0 +1,134 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+//Log Format
+//Encodes the arguments of deferred log calls as bytes, and formats them later, on the log's thread or in the log decoder.
+//Also describes the binary log: a header, then a stream of records, each starting with an EBinaryRecord tag.
+//Only depends on the standard library, so that tools can build it alone.
+//Ewan Burnett - 2022
+
+namespace Engine::LogFormat
+{
+    /**
+     * \brief How an argument is stored. Arguments are widened as printf would, so each type has one C type to format with.
+     */
+    enum class EArgType : uint8_t
+    {
+        Int32 = 0,
+        Int64,
+        UInt32,
+        UInt64,
+        Double,
+        Pointer,
+        String,     //A 16-bit length, then the characters
+    };
+
+    enum class EBinaryRecord : uint8_t
+    {
+        Format = 1,     //uint32 ID, uint16 length, characters. Precedes the first message using the format.
+        Message,        //uint32 format ID, uint16 size, encoded arguments
+        Text,           //uint16 length, characters. Messages which were formatted by the caller.
+        Time,           //int64 seconds since the epoch
+    };
+
+    static constexpr char BINARY_MAGIC[4] = { 'C', 'L', 'O', 'G' };
+    static constexpr uint32_t BINARY_VERSION = 1;
+
+    template<typename T>
+    uint32_t EncodeValue(uint8_t* out, uint32_t capacity, EArgType type, T value)
+    {
+        if (capacity < 1 + sizeof(T))
+        {
+            return 0;
+        }
+
+        out[0] = (uint8_t)type;
+        memcpy(out + 1, &value, sizeof(T));
+        return 1 + sizeof(T);
+    }
+
+    uint32_t EncodeString(uint8_t* out, uint32_t capacity, const char* value);
+
+    /**
+     * \brief Encodes a single argument.
+     * \return The bytes written, or 0 if the argument doesn't fit.
+     */
+    template<typename T>
+    uint32_t EncodeArg(uint8_t* out, uint32_t capacity, const T& value)
+    {
+        using Type = std::decay_t<T>;
+
+        if constexpr (std::is_same_v<Type, const char*> || std::is_same_v<Type, char*>)
+        {
+            return EncodeString(out, capacity, value);
+        }
+        else if constexpr (std::is_floating_point_v<Type>)
+        {
+            return EncodeValue(out, capacity, EArgType::Double, (double)value);
+        }
+        else if constexpr (std::is_pointer_v<Type>)
+        {
+            return EncodeValue(out, capacity, EArgType::Pointer, (uint64_t)(uintptr_t)value);
+        }
+        else if constexpr (std::is_integral_v<Type> && std::is_signed_v<Type>)
+        {
+            return sizeof(Type) <= 4 ? EncodeValue(out, capacity, EArgType::Int32, (int32_t)value) : EncodeValue(out, capacity, EArgType::Int64, (int64_t)value);
+        }
+        else if constexpr (std::is_integral_v<Type>)
+        {
+            return sizeof(Type) <= 4 ? EncodeValue(out, capacity, EArgType::UInt32, (uint32_t)value) : EncodeValue(out, capacity, EArgType::UInt64, (uint64_t)value);
+        }
+        else
+        {
+            static_assert(sizeof(Type) == 0, "Deferred log arguments must be numbers, pointers or C strings.");
+            return 0;
+        }
+    }
+
+    /**
+     * \brief Encodes a log call's arguments.
+     * Stops at the first argument which doesn't fit, so that a later, smaller argument can't take its place.
+     * The arguments left out are formatted as missing.
+     * \return The bytes written.
+     */
+    template<typename... Args>
+    uint32_t Encode(uint8_t* out, uint32_t capacity, const Args&... args)
+    {
+        uint32_t size = 0;
+        auto append = [&](const auto& arg)
+        {
+            const uint32_t written = EncodeArg(out + size, capacity - size, arg);
+            size += written;
+            return written != 0;
+        };
+        (append(args) && ...);
+        return size;
+    }
+
+    /**
+     * \brief Formats encoded arguments, as printf would have.
+     * Length modifiers are taken from the arguments' types rather than the format, so mismatches can't misread the arguments.
+     */
+    [[nodiscard]]
+    std::basic_string<char> Format(std::string_view format, const uint8_t* args, size_t size);
+
+    /**
+     * \brief Formats a timestamp, as written by Engine::LogTime().
+     * \return An empty string if the time can't be represented as a local time.
+     */
+    [[nodiscard]]
+    std::basic_string<char> FormatTime(std::time_t time);
+
+    /**
+     * \brief Converts a binary log to text.
+     * \return False if the log is invalid. Text decoded before the error is still written.
+     */
+    bool Decode(std::istream& in, std::ostream& out);
+}
@@ -1,21 +1,168 @@
 #pragma once
 #define _CRT_SECURE_NO_WARNINGS
+#include <atomic>
 #include <cstdarg>
 #include <stdio.h>
 #include <fstream>
-#include "..\Framework.h"
-#include "..\Core\Time.h"
+#include <cassert>
+#include <cstdint>
+#ifdef _WIN32
+#include "../Framework.h"
+#endif
+#include "LogFormat.h"
 
-#define HR(x, msg) {HRESULT hr; if(FAILED(hr = (x))){ Engine::LogTime(); Engine::Log("\nError: "); Engine::Log(msg); Engine::Log("\nFILE:\t%s\nLINE:\t%d\n", __FILE__, __LINE__); assert(false && msg);}}
-#define HR_WARN(x, msg) {HRESULT hr; if(FAILED(hr = (x))){ Engine::LogTime(); Engine::Log("\nError: "); Engine::Log(msg); Engine::Log("\nFILE:\t%s\nLINE:\t%d\n", __FILE__, __LINE__);}}
-#define ERR(x, msg) {if((x)){ Engine::LogTime(); Engine::Log("\nError: "); Engine::Log(msg); Engine::Log("\nFILE:\t%s\nLINE:\t%d\n", __FILE__, __LINE__); assert(false && msg);}}
-#define WARN(x, msg) {if((x)){ Engine::LogTime(); Engine::Log("\Warning: "); Engine::Log(msg); Engine::Log("\nFILE:\t%s\nLINE:\t%d\n", __FILE__, __LINE__);}}
+//The category a source file logs under. Define it before including any headers, e.g. #define LOG_CATEGORY Graphics
+#ifndef LOG_CATEGORY
+#define LOG_CATEGORY General
+#endif
+
+//The lowest level which is compiled in. Messages below it compile to nothing, including their arguments.
+#ifndef LOG_MIN_LEVEL
+#if defined(DEBUG) || defined(_DEBUG)
+#define LOG_MIN_LEVEL Trace
+#else
+#define LOG_MIN_LEVEL Info
+#endif
+#endif
+
+//Logs a message if its level is compiled in, and enabled at runtime for its category
+#define LOG_AT(level, category, ...) { if constexpr (Engine::IsLogCompiled(Engine::ELogLevel::level)) { if (Engine::IsLogEnabled(Engine::ELogLevel::level, Engine::ELogCategory::category)) { Engine::Log(__VA_ARGS__); } } }
+#define LOG_TRACE(...) LOG_AT(Trace, LOG_CATEGORY, __VA_ARGS__)
+#define LOG_INFO(...) LOG_AT(Info, LOG_CATEGORY, __VA_ARGS__)
+#define LOG_WARNING(...) LOG_AT(Warning, LOG_CATEGORY, __VA_ARGS__)
+#define LOG_ERROR(...) LOG_AT(Error, LOG_CATEGORY, __VA_ARGS__)
+
+//Reports a failure. The condition is always evaluated, even if the report is compiled out.
+#define LOG_REPORT(level, msg) { if constexpr (Engine::IsLogCompiled(Engine::ELogLevel::level)) { if (Engine::IsLogEnabled(Engine::ELogLevel::level, Engine::ELogCategory::LOG_CATEGORY)) { Engine::LogReport(Engine::ELogLevel::level, msg, __FILE__, __LINE__); } } }
+#define HR(x, msg) {HRESULT hr; if(FAILED(hr = (x))){ LOG_REPORT(Error, msg); assert(false && msg);}}
+#define HR_WARN(x, msg) {HRESULT hr; if(FAILED(hr = (x))){ LOG_REPORT(Warning, msg);}}
+#define ERR(x, msg) {if((x)){ LOG_REPORT(Error, msg); assert(false && msg);}}
+#define WARN(x, msg) {if((x)){ LOG_REPORT(Warning, msg);}}
+//Logs a message at Info level, whose format is registered once, and whose arguments are formatted later, by the log's thread or the log decoder.
+//Arguments must be numbers, pointers or C strings.
+#define LOG_DEFERRED(...) { if constexpr (Engine::IsLogCompiled(Engine::ELogLevel::Info)) { if (Engine::IsLogEnabled(Engine::ELogLevel::Info, Engine::ELogCategory::LOG_CATEGORY)) { static const uint32_t logFormat = Engine::RegisterLogFormat(LOG_FIRST_ARG(__VA_ARGS__)); Engine::LogDeferred(logFormat, __VA_ARGS__); } } }
+#define LOG_EXPAND(x) x
+#define LOG_FIRST_ARG(...) LOG_EXPAND(LOG_FIRST_ARG_(__VA_ARGS__, 0))
+#define LOG_FIRST_ARG_(first, ...) first
 #define ALIGNUP(adr, bytes)  { (((uint64_t)(char*)(adr) + (bytes) - 1) & (~((bytes) - 1)));}
 
 constexpr bool ENABLE_LOGGING = true;   //TODO: Config file
 constexpr bool LOG_TO_FILE = true;
+constexpr uint32_t LOG_ARGS_SIZE = 500;     //Bytes of encoded arguments a deferred message may hold
 
 namespace Engine {
+    enum class ELogLevel : uint8_t
+    {
+        Trace = 0,  //Detail, e.g. per mesh import statistics
+        Info,
+        Warning,
+        Error,
+        None,       //Disables every message
+    };
+
+    enum class ELogCategory : uint8_t
+    {
+        General = 0,
+        Importer,
+        Graphics,
+        Input,
+        ResourcePool,
+        COUNT
+    };
+
+    //Runtime thresholds, by category. Only read by IsLogEnabled(), and written by SetLogLevel().
+    inline std::atomic<ELogLevel> LogLevels[(size_t)ELogCategory::COUNT];
+
+    /**
+     * \brief Checks whether a level is above the compile time threshold, LOG_MIN_LEVEL.
+     */
+    constexpr bool IsLogCompiled(ELogLevel level)
+    {
+        return ENABLE_LOGGING && level != ELogLevel::None && level >= ELogLevel::LOG_MIN_LEVEL;
+    }
+
+    /**
+     * \brief Checks whether a level is above the runtime threshold for a category.
+     */
+    inline bool IsLogEnabled(ELogLevel level, ELogCategory category)
+    {
+        return level >= LogLevels[(size_t)category].load(std::memory_order_relaxed);
+    }
+
+    /**
+     * \brief Sets the runtime threshold for a category. Levels below the compile time threshold remain disabled.
+     */
+    void SetLogLevel(ELogCategory category, ELogLevel level);
+
+    /**
+     * \brief Sets the runtime threshold for every category.
+     */
+    void SetLogLevel(ELogLevel level);
+
+    /**
+     * \brief What happens to messages logged while the log's queue is full.
+     */
+    enum class ELogOverflow
+    {
+        Drop = 0,   //Discard the message. The number dropped is written once there's space.
+        Block,      //Wait for the writer to make space.
+    };
+
+    /**
+     * \brief How the log is written to file.
+     */
+    enum class ELogFormat
+    {
+        Text = 0,   //Log.txt
+        Binary,     //Log.bin. Deferred messages are written unformatted, and may be read with the LogDecoder tool.
+    };
+
+    /**
+     * \brief Formats a message, and queues it to be written by the log's thread.
+     */
     void Log(const char* fmt, ...);
+
+    /**
+     * \brief Logs the current time. The time is taken when called, but formatted by the log's thread.
+     */
     void LogTime();
+
+    /**
+     * \brief Logs a failure reported by ERR, WARN or HR, with the time and location. Errors are flushed before returning.
+     */
+    void LogReport(ELogLevel level, const char* msg, const char* file, int line);
+
+    /**
+     * \brief Blocks until every message logged so far has been written, e.g. before asserting.
+     */
+    void FlushLog();
+
+    void SetLogOverflow(ELogOverflow policy);
+
+    void SetLogFormat(ELogFormat format);
+
+    /**
+     * \brief Registers a deferred message's format. The format must outlive the log, e.g. a string literal.
+     * \return The format's ID.
+     */
+    uint32_t RegisterLogFormat(const char* fmt);
+
+    /**
+     * \brief Queues a deferred message's encoded arguments.
+     */
+    void LogEncoded(uint32_t format, const uint8_t* args, uint32_t size);
+
+    /**
+     * \brief Encodes a deferred message's arguments, and queues them. Use LOG_DEFERRED(), which registers the format.
+     * \param format The ID returned by RegisterLogFormat().
+     * \param fmt Unused, but keeps the arguments in the same place as Log()'s.
+     */
+    template<typename... Args>
+    void LogDeferred(uint32_t format, const char* fmt, const Args&... args)
+    {
+        if (ENABLE_LOGGING) {
+            uint8_t encoded[LOG_ARGS_SIZE];
+            LogEncoded(format, encoded, LogFormat::Encode(encoded, sizeof(encoded), args...));
+        }
+    }
 }
@@ -0,0 +1,98 @@
+#pragma once
+#include "../Graphics/Model.h"
+#include <vector>
+
+//Mesh Optimizer
+//Import-time mesh processing, run while cooking models into .Asset files.
+//Ewan Burnett - 2022
+
+namespace Engine::MeshOptimizer
+{
+    constexpr uint32_t MESHLET_MAX_VERTICES = 64;
+    constexpr uint32_t MESHLET_MAX_TRIANGLES = 124;
+
+    /**
+     * \brief Describes how a chain of LODs should be generated.
+     */
+    struct LODSettings
+    {
+        uint32_t MaxLODs = 4;           //Maximum number of simplified levels to generate
+        float Reduction = 0.5f;         //Triangle count of each level, relative to the previous level's target
+        float MaxError = 0.05f;         //Maximum geometric error, relative to the mesh's extents
+        float NormalWeight = 0.5f;      //Weight of vertex normals in the collapse cost
+        float TexCoordWeight = 1.0f;    //Weight of texture coordinates in the collapse cost
+    };
+
+    /**
+     * \brief Simplifies a mesh using quadric error metrics.
+     * \param mesh The mesh to simplify. Vertex attributes are read from the mesh.
+     * \param indices The triangle list to simplify.
+     * \param targetIndexCount The desired number of indices.
+     * \param output The simplified triangle list.
+     * \param settings Attribute weights and the maximum error to introduce.
+     * \return The object-space error of the simplified triangle list.
+     */
+    float Simplify(const MeshFilter& mesh, const std::vector<uint32_t>& indices, uint32_t targetIndexCount, std::vector<uint32_t>& output, const LODSettings& settings = {});
+
+    /**
+     * \brief Generates a chain of simplified LODs for a mesh, replacing any existing LODs.
+     * Each level is simplified from the full mesh, so every level's error is relative to the original.
+     * \param mesh The mesh to generate LODs for.
+     * \param settings Describes the LOD chain to generate.
+     */
+    void GenerateLODs(MeshFilter& mesh, const LODSettings& settings = {});
+
+    /**
+     * \brief Projects an object-space error onto the screen.
+     * \param error The object-space error, in world units.
+     * \param distance The distance from the camera to the object.
+     * \param frustrum The camera's view frustrum.
+     * \param screenHeight The height of the viewport, in pixels.
+     * \return The error, in pixels.
+     */
+    float ScreenSpaceError(float error, float distance, const Frustrum& frustrum, float screenHeight);
+
+    /**
+     * \brief Selects the least detailed LOD whose screen-space error is within a threshold.
+     * \param mesh The mesh to select a LOD from.
+     * \param distance The distance from the camera to the mesh.
+     * \param frustrum The camera's view frustrum.
+     * \param screenHeight The height of the viewport, in pixels.
+     * \param pixelThreshold The maximum acceptable error, in pixels.
+     * \return 0 for the full detail mesh, or n for mesh.LODs[n - 1].
+     */
+    uint32_t SelectLOD(const MeshFilter& mesh, float distance, const Frustrum& frustrum, float screenHeight, float pixelThreshold = 1.0f);
+
+    /**
+     * \brief Statistics gathered while culling a mesh's meshlets.
+     */
+    struct MeshletCullStats
+    {
+        uint32_t Meshlets = 0;
+        uint32_t Triangles = 0;
+        uint32_t FrustrumCulledMeshlets = 0;
+        uint32_t BackfaceCulledMeshlets = 0;
+        uint32_t CulledTriangles = 0;
+    };
+
+    /**
+     * \brief Splits a mesh into meshlets, replacing any existing meshlets.
+     * \param mesh The mesh to split.
+     * \param maxVertices The maximum number of vertices per meshlet, clamped to between 3 and 256.
+     * \param maxTriangles The maximum number of triangles per meshlet.
+     */
+    void BuildMeshlets(MeshFilter& mesh, uint32_t maxVertices = MESHLET_MAX_VERTICES, uint32_t maxTriangles = MESHLET_MAX_TRIANGLES);
+
+    /**
+     * \brief Rejects meshlets which lie outside the view frustrum, or which are entirely back-facing.
+     * \param mesh The mesh to cull.
+     * \param world The mesh's world matrix. Back-face cones assume a uniform scale.
+     * \param view The camera's view matrix.
+     * \param cameraPosition The camera's world-space position.
+     * \param frustrum The camera's view frustrum.
+     * \param visible Receives the indices of visible meshlets.
+     * \param stats (Optional) Receives culling statistics.
+     * \return The number of visible meshlets.
+     */
+    uint32_t CullMeshlets(const MeshFilter& mesh, const Matrix4x4& world, const Matrix4x4& view, const Vector3f& cameraPosition, const Frustrum& frustrum, std::vector<uint32_t>& visible, MeshletCullStats* stats = nullptr);
+}
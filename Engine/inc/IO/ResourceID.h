@@ -0,0 +1,51 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+
+//Resource ID
+//Identifies a resource by the hash of its path. Paths are interned once, when an ID is created, so
+//copying, comparing and looking up IDs never touches a string. IDs share the hash used by resource packs.
+//Ewan Burnett - 2022
+
+namespace Engine
+{
+    class ResourceID
+    {
+    public:
+        ResourceID() = default;
+
+        /**
+         * \brief Interns a path. Converts implicitly, so that materials can be assigned paths.
+         * \param path The resource's path. Paths are relative to the Resources directory, which is prepended if missing.
+         * An empty path produces a null ID.
+         */
+        ResourceID(std::wstring_view path);
+        ResourceID(const std::basic_string<wchar_t>& path) : ResourceID(std::wstring_view(path)) {}
+        ResourceID(const wchar_t* path) : ResourceID(std::wstring_view(path)) {}
+
+        [[nodiscard]]
+        bool IsNull() const { return m_Hash == 0; }
+
+        [[nodiscard]]
+        uint64_t GetHash() const { return m_Hash; }
+
+        /**
+         * \brief The path the ID was interned from, including the Resources directory. Empty for null IDs.
+         */
+        [[nodiscard]]
+        const std::basic_string<wchar_t>& GetPath() const;
+
+        bool operator==(const ResourceID& other) const = default;
+
+    private:
+        uint64_t m_Hash = 0;
+    };
+}
+
+template<>
+struct std::hash<Engine::ResourceID>
+{
+    size_t operator()(const Engine::ResourceID& id) const noexcept { return (size_t)id.GetHash(); }
+};
@@ -4,15 +4,18 @@
 
 //#include "..\Core\Audio.h"
 
+#include <functional>
 #include <unordered_map>
 
 #include <sstream>
 #include <string>
-#include <Vector>
+#include <vector>
+#include <span>
 
 #include <wrl/client.h>
-#include "..\Graphics\Model.h"
-#include "..\IO\Logger.h"
+#include "../Graphics/Model.h"
+#include "../IO/Logger.h"
+#include "../IO/Archive.h"
 
 namespace Engine
 {
@@ -25,10 +28,41 @@ namespace Engine
         typedef Microsoft::WRL::ComPtr<ID3D11InputLayout> inputLayout;
         //typedef Engine::Audio::SoundPacket sound;
 
-        void Init();
+        /**
+         * \brief A mesh's buffers. Holds its own references, so the buffers remain valid while in use, even if the mesh is removed.
+         */
+        struct MeshBuffers
+        {
+            vBuffer VertexBuffer;
+            iBuffer IndexBuffer;     //nullptr for meshes without indices
+        };
+
+        /**
+         * \brief The kinds of resource whose memory is accounted for.
+         */
+        enum class EResourceCategory
+        {
+            Texture = 0,
+            VertexBuffer,
+            IndexBuffer,
+            COUNT
+        };
+
+        /**
+         * \brief Initializes the Resource Pool.
+         * \param packPath (Optional) A pack file to memory-map. Resources it contains are loaded from the pack, rather than from loose files.
+         */
+        void Init(const std::basic_string<char>& packPath = "");
         void Shutdown();
 
-        //TODO: Resource Deallocation
+        /**
+         * \brief Looks up a resource within the mounted packs.
+         * \param path The resource's path.
+         * \return A view of the resource's data, or an empty span if it should be loaded from disk.
+         */
+        [[nodiscard]]
+         std::span<const uint8_t> GetPackedData(const std::basic_string<wchar_t>& path);
+
         //TODO: Comment Interface Methods
 
         [[nodiscard]]
@@ -37,26 +71,98 @@ namespace Engine
         [[nodiscard]]
          std::basic_string<wchar_t> GetCompiledShaderPath(EShaderType type);
 
+        /**
+         * \brief Finds the shader type whose source or compiled shader is at a path.
+         * \return False if the path isn't a shader.
+         */
+         bool GetShaderType(const std::basic_string<wchar_t>& path, EShaderType& type);
+
+        //Resources are addressed by handle, so lookups are an array index and a generation check.
+        //Handles to removed resources resolve to nullptr, rather than to whatever replaced them.
+        //Resolving a texture or mesh pins it for the current frame, so that it can't be evicted while it's being drawn.
+        //The pool may be used from any thread. Lookups only contend with resources being added or removed.
+        //Resolved resources are returned as references taken under the pool's lock, so they outlive another thread removing them.
+
+        /**
+         * \brief Finds the shader loaded for a shader type.
+         */
         [[nodiscard]]
-         shader GetShader(EShaderType type);
-         void AddShader(shader shader, EShaderType type);
+         ShaderHandle FindShader(EShaderType type);
+        [[nodiscard]]
+         shader GetShader(ShaderHandle handle);
+         ShaderHandle AddShader(shader shader, EShaderType type);
+
+        /**
+         * \brief Finds the shader for a shader type, loading it if it isn't in the pool.
+         * Threads which request a shader while it's loading wait for it, rather than loading it again.
+         * \param load Loads the shader. Invoked on the calling thread, without the pool locked.
+         * \return The shader's handle, or a null handle if it failed to load.
+         */
+         ShaderHandle AcquireShader(EShaderType type, const std::function<shader()>& load);
+
+        /**
+         * \brief Swaps a loaded shader for a new one. Its handle remains valid, and resolves to the new shader.
+         * \return False if no shader is loaded for the type.
+         */
+         bool ReplaceShader(EShaderType type, shader shader);
 
          [[nodiscard]]
          inputLayout GetInputLayout(EShaderType type);
          void AddInputLayout(inputLayout layout, EShaderType type);
 
+        /**
+         * \brief Finds the texture loaded for a resource.
+         */
         [[nodiscard]]
-         texture GetTexture(std::basic_string<wchar_t> path);
-         void AddTexture(texture tex, std::basic_string<wchar_t> path);
-
-
+         TextureHandle FindTexture(const ResourceID& id);
         [[nodiscard]]
-         vBuffer GetVertexBuffer(const Engine::MeshFilter* mesh);
-         void AddVertexBuffer(vBuffer vertexBuffer, const Engine::MeshFilter* mesh);
+         texture GetTexture(TextureHandle handle);
+         TextureHandle AddTexture(texture tex, const ResourceID& id);
+
+        /**
+         * \brief Finds the texture loaded for a resource, loading it if it isn't in the pool.
+         * Threads which request a texture while it's loading wait for it, rather than loading it again.
+         * \param load Loads the texture. Invoked on the calling thread, without the pool locked.
+         * \return The texture's handle, or a null handle if it failed to load.
+         */
+         TextureHandle AcquireTexture(const ResourceID& id, const std::function<texture()>& load);
+
+        /**
+         * \brief Swaps a loaded texture for a new one. Its handle remains valid, and resolves to the new texture.
+         * \return False if no texture is loaded for the resource.
+         */
+         bool ReplaceTexture(const ResourceID& id, texture tex);
+         bool RemoveTexture(TextureHandle handle);
 
         [[nodiscard]]
-         iBuffer GetIndexBuffer(const Engine::MeshFilter* mesh);
-         void AddIndexBuffer(iBuffer indexBuffer, const Engine::MeshFilter* mesh);
+         MeshBuffers GetMesh(MeshHandle handle);
+         MeshHandle AddMesh(vBuffer vertexBuffer, iBuffer indexBuffer);
+         bool RemoveMesh(MeshHandle handle);
+
+        /**
+         * \brief Limits the memory held by textures and meshes. Once over budget, the least recently used are evicted.
+         * Evicted resources are reloaded by the backend the next time they're drawn.
+         * \param bytes The budget, in bytes. 0 disables eviction.
+         */
+         void SetMemoryBudget(uint64_t bytes);
+
+        /**
+         * \brief Sets how many frames a resource must go unused before it may be evicted.
+         * \param frames The age, in frames. Resources used this frame are never evicted, so this is at least 1.
+         */
+         void SetEvictionAge(uint32_t frames);
+
+        /**
+         * \brief The bytes held by a category of resource, as computed when each was added.
+         */
+        [[nodiscard]]
+         uint64_t GetMemoryUsage(EResourceCategory category);
+
+        /**
+         * \brief Closes the current frame, evicting resources if the pool is over budget. Called by backends when presenting.
+         * \return The number of resources evicted.
+         */
+         uint32_t EndFrame();
 
     }
 
@@ -0,0 +1,464 @@
+#include "../inc/IO/Archive.h"
+#include "../inc/IO/Logger.h"
+#include "../inc/IO/TypeConversion.h"
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_set>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace Engine;
+
+/**
+ * \brief A memory-mapped pack file.
+ */
+struct MountedArchive
+{
+    std::basic_string<char> Path;
+    const uint8_t* Base = nullptr;
+    uint64_t Size = 0;
+    const Archive::Header* Header = nullptr;
+    const Archive::DirectoryEntry* Directory = nullptr;
+    const char* Paths = nullptr;
+
+#ifdef _WIN32
+    HANDLE File = INVALID_HANDLE_VALUE;
+    HANDLE Mapping = nullptr;
+#else
+    int File = -1;
+#endif
+};
+
+static std::vector<MountedArchive> Mounts;
+static std::shared_mutex MountsMutex;     //Finds share the mounts, so that loading threads don't serialize on them
+
+static uint64_t AlignUp(uint64_t value, uint64_t alignment)
+{
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+static void Unmap(MountedArchive& archive)
+{
+#ifdef _WIN32
+    if (archive.Base != nullptr)
+    {
+        UnmapViewOfFile(archive.Base);
+    }
+    if (archive.Mapping != nullptr)
+    {
+        CloseHandle(archive.Mapping);
+    }
+    if (archive.File != INVALID_HANDLE_VALUE)
+    {
+        CloseHandle(archive.File);
+    }
+#else
+    if (archive.Base != nullptr)
+    {
+        munmap((void*)archive.Base, archive.Size);
+    }
+    if (archive.File != -1)
+    {
+        close(archive.File);
+    }
+#endif
+    archive = {};
+}
+
+/**
+ * \brief Maps an entire file into memory, read-only.
+ */
+static bool Map(const std::basic_string<char>& path, MountedArchive& archive)
+{
+#ifdef _WIN32
+    archive.File = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS, nullptr);
+    if (archive.File == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+
+    LARGE_INTEGER size = {};
+    if (!GetFileSizeEx(archive.File, &size) || size.QuadPart == 0)
+    {
+        Unmap(archive);
+        return false;
+    }
+    archive.Size = (uint64_t)size.QuadPart;
+
+    archive.Mapping = CreateFileMappingA(archive.File, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (archive.Mapping == nullptr)
+    {
+        Unmap(archive);
+        return false;
+    }
+
+    archive.Base = (const uint8_t*)MapViewOfFile(archive.Mapping, FILE_MAP_READ, 0, 0, 0);
+#else
+    archive.File = open(path.c_str(), O_RDONLY);
+    if (archive.File == -1)
+    {
+        return false;
+    }
+
+    struct stat info = {};
+    if (fstat(archive.File, &info) != 0 || info.st_size == 0)
+    {
+        Unmap(archive);
+        return false;
+    }
+    archive.Size = (uint64_t)info.st_size;
+
+    void* base = mmap(nullptr, archive.Size, PROT_READ, MAP_PRIVATE, archive.File, 0);
+    archive.Base = base == MAP_FAILED ? nullptr : (const uint8_t*)base;
+#endif
+
+    if (archive.Base == nullptr)
+    {
+        Unmap(archive);
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * \brief Checks that a mapped pack's header, directory and entries lie within the file.
+ */
+static bool Validate(const MountedArchive& archive)
+{
+    if (archive.Size < sizeof(Archive::Header))
+    {
+        return false;
+    }
+
+    const Archive::Header& header = *archive.Header;
+    if (header.Magic != Archive::ARCHIVE_MAGIC || header.Version != Archive::ARCHIVE_VERSION)
+    {
+        return false;
+    }
+
+    //The directory is open-addressed, and must contain at least one empty slot.
+    if (header.SlotCount == 0 || (header.SlotCount & (header.SlotCount - 1)) != 0 || header.FileCount >= header.SlotCount)
+    {
+        return false;
+    }
+
+    if (header.DirectoryOffset % Archive::DIRECTORY_ALIGNMENT != 0 || header.DirectoryOffset > archive.Size ||
+        (uint64_t)header.SlotCount * sizeof(Archive::DirectoryEntry) > archive.Size - header.DirectoryOffset ||
+        header.PathsOffset > archive.Size || header.PathsSize > archive.Size - header.PathsOffset)
+    {
+        return false;
+    }
+
+    uint32_t occupied = 0;
+    for (uint32_t i = 0; i < header.SlotCount; i++)
+    {
+        const Archive::DirectoryEntry& entry = archive.Directory[i];
+        if (entry.Hash == 0)
+        {
+            continue;
+        }
+
+        if (entry.Offset > archive.Size || entry.Size > archive.Size - entry.Offset ||
+            (uint64_t)entry.PathOffset + entry.PathLength > header.PathsSize)
+        {
+            return false;
+        }
+        occupied++;
+    }
+
+    //Probes stop at an empty slot, so a directory with more entries than the header counts may have none
+    return occupied == header.FileCount;
+}
+
+std::basic_string<char> Archive::NormalizePath(std::string_view path)
+{
+    //Strip any leading references to the current directory
+    while (path.starts_with(".\\") || path.starts_with("./"))
+    {
+        path.remove_prefix(2);
+    }
+
+    std::basic_string<char> out(path);
+    for (auto& c : out)
+    {
+        if (c == '/')
+        {
+            c = '\\';
+        }
+        else if (c >= 'A' && c <= 'Z')
+        {
+            c = (char)(c - 'A' + 'a');
+        }
+    }
+
+    return out;
+}
+
+std::basic_string<char> Archive::NormalizePath(std::wstring_view path)
+{
+    return NormalizePath(WStringToString(std::basic_string<wchar_t>(path)));
+}
+
+/**
+ * \brief Hashes an already normalized path.
+ */
+static uint64_t HashNormalized(std::string_view path)
+{
+    uint64_t hash = 14695981039346656037ull;
+    for (const char c : path)
+    {
+        hash ^= (uint8_t)c;
+        hash *= 1099511628211ull;
+    }
+
+    //0 marks an empty directory slot
+    return hash == 0 ? 1 : hash;
+}
+
+uint64_t Archive::HashPath(std::string_view path)
+{
+    return HashNormalized(NormalizePath(path));
+}
+
+uint64_t Archive::HashPath(std::wstring_view path)
+{
+    return HashNormalized(NormalizePath(path));
+}
+
+bool Archive::Build(const std::vector<std::basic_string<char>>& files, const std::basic_string<char>& archivePath)
+{
+    LOG_INFO("Packing %llu files into <%s>...\n", (uint64_t)files.size(), archivePath.c_str());
+    const auto start = std::chrono::steady_clock::now();
+
+    std::ofstream out(archivePath, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!out.is_open())
+    {
+        LOG_WARNING("Unable to create pack <%s>\n", archivePath.c_str());
+        return false;
+    }
+
+    Header header = {};
+    header.Magic = ARCHIVE_MAGIC;
+    header.Version = ARCHIVE_VERSION;
+
+    //The header is rewritten once the directory has been placed
+    out.write((const char*)&header, sizeof(header));
+    uint64_t offset = sizeof(header);
+
+    std::vector<DirectoryEntry> entries;
+    std::basic_string<char> paths;
+    std::unordered_set<std::basic_string<char>> packed;
+    std::vector<char> data;
+    bool success = true;
+
+    for (const auto& file : files)
+    {
+        const std::basic_string<char> path = NormalizePath(file);
+        const uint64_t hash = HashNormalized(path);
+
+        //Colliding hashes are told apart by path during lookup, but duplicate paths are skipped
+        if (!packed.insert(path).second)
+        {
+            continue;
+        }
+
+        std::ifstream in(file, std::ios::in | std::ios::binary | std::ios::ate);
+        if (!in.is_open())
+        {
+            LOG_WARNING("Unable to pack <%s>\n", file.c_str());
+            success = false;
+            continue;
+        }
+
+        data.resize((size_t)in.tellg());
+        in.seekg(0);
+        in.read(data.data(), data.size());
+
+        //Pad to the alignment of the next file
+        const uint64_t aligned = AlignUp(offset, ARCHIVE_ALIGNMENT);
+        const char padding[ARCHIVE_ALIGNMENT] = {};
+        out.write(padding, aligned - offset);
+        out.write(data.data(), data.size());
+
+        DirectoryEntry entry = {};
+        entry.Hash = hash;
+        entry.Offset = aligned;
+        entry.Size = data.size();
+        entry.PathOffset = (uint32_t)paths.size();
+        entry.PathLength = (uint32_t)path.size();
+        entries.push_back(entry);
+
+        paths.append(path);
+        offset = aligned + data.size();
+    }
+
+    //Size the directory for a load factor of at most 0.5
+    uint32_t slotCount = 2;
+    while (slotCount < entries.size() * 2)
+    {
+        slotCount *= 2;
+    }
+
+    std::vector<DirectoryEntry> directory(slotCount);
+    for (const auto& entry : entries)
+    {
+        uint32_t slot = (uint32_t)entry.Hash & (slotCount - 1);
+        while (directory[slot].Hash != 0)
+        {
+            slot = (slot + 1) & (slotCount - 1);
+        }
+        directory[slot] = entry;
+    }
+
+    header.FileCount = (uint32_t)entries.size();
+    header.SlotCount = slotCount;
+    header.DirectoryOffset = AlignUp(offset, DIRECTORY_ALIGNMENT);
+    header.PathsOffset = header.DirectoryOffset + directory.size() * sizeof(DirectoryEntry);
+    header.PathsSize = paths.size();
+
+    const char padding[DIRECTORY_ALIGNMENT] = {};
+    out.write(padding, header.DirectoryOffset - offset);
+    out.write((const char*)directory.data(), directory.size() * sizeof(DirectoryEntry));
+    out.write(paths.data(), paths.size());
+
+    out.seekp(0);
+    out.write((const char*)&header, sizeof(header));
+    out.close();
+
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    LOG_INFO("Packed %u files into <%s> (%llu bytes) in %fs\n", header.FileCount, archivePath.c_str(), header.PathsOffset + header.PathsSize, seconds);
+
+    return success && !out.fail();
+}
+
+bool Archive::Mount(const std::basic_string<char>& archivePath)
+{
+    MountedArchive archive = {};
+    if (!Map(archivePath, archive))
+    {
+        LOG_WARNING("Unable to mount pack <%s>\n", archivePath.c_str());
+        return false;
+    }
+
+    archive.Path = archivePath;
+    archive.Header = (const Header*)archive.Base;
+    if (archive.Size >= sizeof(Header))
+    {
+        archive.Directory = (const DirectoryEntry*)(archive.Base + archive.Header->DirectoryOffset);
+        archive.Paths = (const char*)(archive.Base + archive.Header->PathsOffset);
+    }
+
+    if (!Validate(archive))
+    {
+        LOG_WARNING("Pack <%s> is invalid or corrupt.\n", archivePath.c_str());
+        Unmap(archive);
+        return false;
+    }
+
+    LOG_INFO("Mounted pack <%s> (%u files, %llu bytes)\n", archivePath.c_str(), archive.Header->FileCount, archive.Size);
+
+    //The pack is mapped and validated before the lock is taken, so finds only wait for the push
+    std::unique_lock lock(MountsMutex);
+    Mounts.push_back(archive);
+    return true;
+}
+
+void Archive::UnmountAll()
+{
+    std::unique_lock lock(MountsMutex);
+    for (auto& archive : Mounts)
+    {
+        Unmap(archive);
+    }
+    Mounts.clear();
+}
+
+/**
+ * \brief Probes each mounted pack's directory for a normalized path. MountsMutex must be held.
+ */
+static std::span<const uint8_t> FindNormalized(std::string_view path)
+{
+    const uint64_t hash = HashNormalized(path);
+
+    //Later mounts override earlier ones
+    for (auto archive = Mounts.rbegin(); archive != Mounts.rend(); ++archive)
+    {
+        const uint32_t mask = archive->Header->SlotCount - 1;
+        for (uint32_t slot = (uint32_t)hash & mask; archive->Directory[slot].Hash != 0; slot = (slot + 1) & mask)
+        {
+            const Archive::DirectoryEntry& entry = archive->Directory[slot];
+            if (entry.Hash == hash && std::string_view(archive->Paths + entry.PathOffset, entry.PathLength) == path)
+            {
+                return { archive->Base + entry.Offset, (size_t)entry.Size };
+            }
+        }
+    }
+
+    return {};
+}
+
+std::span<const uint8_t> Archive::Find(std::string_view path)
+{
+    std::shared_lock lock(MountsMutex);
+    if (Mounts.empty())
+    {
+        return {};
+    }
+    return FindNormalized(NormalizePath(path));
+}
+
+std::span<const uint8_t> Archive::Find(std::wstring_view path)
+{
+    std::shared_lock lock(MountsMutex);
+    if (Mounts.empty())
+    {
+        return {};
+    }
+    return FindNormalized(NormalizePath(path));
+}
+
+Archive::MemoryStreamBuf::MemoryStreamBuf(std::span<const uint8_t> data)
+{
+    char* begin = (char*)data.data();
+    setg(begin, begin, begin + data.size());
+}
+
+Archive::MemoryStreamBuf::pos_type Archive::MemoryStreamBuf::seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which)
+{
+    off_type base = 0;
+    if (dir == std::ios_base::cur)
+    {
+        base = gptr() - eback();
+    }
+    else if (dir == std::ios_base::end)
+    {
+        base = egptr() - eback();
+    }
+
+    return seekpos(base + off, which);
+}
+
+Archive::MemoryStreamBuf::pos_type Archive::MemoryStreamBuf::seekpos(pos_type pos, std::ios_base::openmode which)
+{
+    if (!(which & std::ios_base::in) || pos < 0 || pos > egptr() - eback())
+    {
+        return pos_type(off_type(-1));
+    }
+
+    setg(eback(), eback() + (off_type)pos, egptr());
+    return pos;
+}
+
+Archive::MemoryStream::MemoryStream(std::span<const uint8_t> data) : std::istream(nullptr), m_Buffer(data)
+{
+    rdbuf(&m_Buffer);
+}
@@ -0,0 +1,238 @@
+#define LOG_CATEGORY Importer
+#include "../inc/IO/AssetLoader.h"
+#include "../inc/IO/Importer.h"
+
+using namespace Engine;
+
+Engine::AssetLoader::AssetLoader(uint32_t workerCount, uint32_t maxInFlight)
+    : m_NextHandle(1), m_NextSequence(0), m_InFlight(0), m_MaxInFlight(maxInFlight), m_Stopping(false)
+{
+    ERR(workerCount == 0 || maxInFlight == 0, "Asset Loader requires at least one worker and one load in flight.");
+
+    m_Workers.reserve(workerCount);
+    for (uint32_t i = 0; i < workerCount; i++)
+    {
+        m_Workers.emplace_back(&AssetLoader::WorkerMain, this);
+    }
+}
+
+Engine::AssetLoader::~AssetLoader()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Stopping = true;
+    }
+    m_WorkAvailable.notify_all();
+
+    //Workers finish their current load before exiting
+    for (auto& worker : m_Workers)
+    {
+        worker.join();
+    }
+}
+
+LoadHandle Engine::AssetLoader::Load(const std::basic_string<char>& filePath, float priority, LoadCallback callback)
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    const LoadHandle handle = m_NextHandle++;
+    Request& request = m_Requests[handle];
+    request.FilePath = filePath;
+    request.Callback = std::move(callback);
+    request.Priority = priority;
+    request.Sequence = m_NextSequence++;
+
+    Push(handle, request);
+    m_WorkAvailable.notify_one();
+
+    return handle;
+}
+
+bool Engine::AssetLoader::Cancel(LoadHandle handle)
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    auto it = m_Requests.find(handle);
+    if (it == m_Requests.end())
+    {
+        return false;
+    }
+
+    switch (it->second.State)
+    {
+    case ERequestState::Queued:
+        //The queue entry becomes stale, and is skipped when popped
+        m_Requests.erase(it);
+        break;
+
+    case ERequestState::Loading:
+        //The worker discards the result once the load finishes
+        it->second.Cancelled = true;
+        break;
+
+    case ERequestState::Complete:
+        //Free the in-flight slot. Poll() skips the completion.
+        m_Requests.erase(it);
+        m_InFlight--;
+        m_WorkAvailable.notify_one();
+        break;
+    }
+
+    return true;
+}
+
+bool Engine::AssetLoader::SetPriority(LoadHandle handle, float priority)
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    auto it = m_Requests.find(handle);
+    if (it == m_Requests.end() || it->second.State != ERequestState::Queued)
+    {
+        return false;
+    }
+
+    //Re-queue the request, invalidating its previous entry
+    it->second.Priority = priority;
+    it->second.Version++;
+    Push(handle, it->second);
+
+    return true;
+}
+
+uint32_t Engine::AssetLoader::Poll(uint32_t maxCompletions)
+{
+    std::vector<std::pair<LoadHandle, Request>> completed;
+
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        size_t consumed = 0;
+        for (; consumed < m_Completed.size() && completed.size() < maxCompletions; consumed++)
+        {
+            const LoadHandle handle = m_Completed[consumed];
+
+            //Requests cancelled after completing have already released their slot
+            auto it = m_Requests.find(handle);
+            if (it == m_Requests.end())
+            {
+                continue;
+            }
+
+            completed.emplace_back(handle, std::move(it->second));
+            m_Requests.erase(it);
+            m_InFlight--;
+        }
+        m_Completed.erase(m_Completed.begin(), m_Completed.begin() + consumed);
+    }
+
+    if (!completed.empty())
+    {
+        m_WorkAvailable.notify_all();
+    }
+
+    //Callbacks run without the lock held, so they may queue further loads
+    for (auto& [handle, request] : completed)
+    {
+        if (request.Callback)
+        {
+            request.Callback(handle, request.Result);
+        }
+    }
+
+    return (uint32_t)completed.size();
+}
+
+uint32_t Engine::AssetLoader::Pending()
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    return (uint32_t)m_Requests.size();
+}
+
+void Engine::AssetLoader::Push(LoadHandle handle, const Request& request)
+{
+    m_Queue.push({ request.Priority, request.Sequence, handle, request.Version });
+
+    //Rebuild the queue if stale entries from priority changes and cancellations dominate it
+    if (m_Queue.size() > m_Requests.size() * 2 + 32)
+    {
+        std::priority_queue<QueueEntry> queue;
+        for (const auto& [h, r] : m_Requests)
+        {
+            if (r.State == ERequestState::Queued)
+            {
+                queue.push({ r.Priority, r.Sequence, h, r.Version });
+            }
+        }
+        m_Queue.swap(queue);
+    }
+}
+
+bool Engine::AssetLoader::PopValid(LoadHandle& handle)
+{
+    while (!m_Queue.empty())
+    {
+        const QueueEntry entry = m_Queue.top();
+        m_Queue.pop();
+
+        auto it = m_Requests.find(entry.Handle);
+        if (it != m_Requests.end() && it->second.State == ERequestState::Queued && it->second.Version == entry.Version)
+        {
+            handle = entry.Handle;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void Engine::AssetLoader::WorkerMain()
+{
+    while (true)
+    {
+        LoadHandle handle = INVALID_LOAD_HANDLE;
+        std::basic_string<char> filePath;
+
+        {
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            m_WorkAvailable.wait(lock, [&] { return m_Stopping || (m_InFlight < m_MaxInFlight && !m_Queue.empty()); });
+
+            if (m_Stopping)
+            {
+                return;
+            }
+
+            if (!PopValid(handle))
+            {
+                continue;
+            }
+
+            Request& request = m_Requests.at(handle);
+            request.State = ERequestState::Loading;
+            filePath = request.FilePath;
+            m_InFlight++;
+        }
+
+        //I/O and decoding happen outside the lock
+        Model model = {};
+        Importer::LoadFromFile(model, filePath);
+
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+
+            //Loading requests are only erased here, so the request is still present
+            auto it = m_Requests.find(handle);
+            if (it->second.Cancelled)
+            {
+                m_Requests.erase(it);
+                m_InFlight--;
+                m_WorkAvailable.notify_one();
+            }
+            else
+            {
+                it->second.Result = std::move(model);
+                it->second.State = ERequestState::Complete;
+                m_Completed.push_back(handle);
+            }
+        }
+    }
+}
@@ -0,0 +1,235 @@
+#include "../inc/IO/Compression.h"
+#include <cstring>
+#include <vector>
+
+using namespace Engine;
+
+constexpr size_t MIN_MATCH = 4;         //Shortest back-reference
+constexpr size_t LAST_LITERALS = 5;     //The final bytes of a block are always literals
+constexpr size_t MATCH_LIMIT = 12;      //Matches may not start within this many bytes of the end
+constexpr size_t MAX_OFFSET = 65535;
+constexpr uint32_t HASH_BITS = 16;
+
+static uint32_t Read32(const uint8_t* p)
+{
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static uint32_t Hash(uint32_t sequence)
+{
+    return (sequence * 2654435761u) >> (32 - HASH_BITS);
+}
+
+/**
+ * \brief Writes a length which overflowed its 4-bit token field as a run of 255s and a remainder.
+ */
+static void WriteLength(uint8_t*& op, size_t length)
+{
+    while (length >= 255)
+    {
+        *op++ = 255;
+        length -= 255;
+    }
+    *op++ = (uint8_t)length;
+}
+
+static bool ReadLength(const uint8_t*& ip, const uint8_t* end, size_t& length)
+{
+    uint8_t b;
+    do
+    {
+        if (ip >= end)
+        {
+            return false;
+        }
+        b = *ip++;
+        length += b;
+    } while (b == 255);
+
+    return true;
+}
+
+size_t Compression::CompressBound(size_t size)
+{
+    return size + (size / 255) + 16;
+}
+
+size_t Compression::Compress(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstCapacity)
+{
+    if (dstCapacity < CompressBound(srcSize))
+    {
+        return 0;
+    }
+
+    uint8_t* op = dst;
+    size_t anchor = 0;
+
+    auto _emit = [&](size_t literalEnd, size_t offset, size_t matchLength)
+    {
+        const size_t literalLength = literalEnd - anchor;
+        uint8_t* token = op++;
+
+        //Literal run
+        *token = (uint8_t)((literalLength >= 15 ? 15 : literalLength) << 4);
+        if (literalLength >= 15)
+        {
+            WriteLength(op, literalLength - 15);
+        }
+        memcpy(op, src + anchor, literalLength);
+        op += literalLength;
+
+        //Back-reference. The final sequence has none.
+        if (matchLength > 0)
+        {
+            *op++ = (uint8_t)(offset & 0xff);
+            *op++ = (uint8_t)(offset >> 8);
+
+            const size_t m = matchLength - MIN_MATCH;
+            *token |= (uint8_t)(m >= 15 ? 15 : m);
+            if (m >= 15)
+            {
+                WriteLength(op, m - 15);
+            }
+        }
+    };
+
+    if (srcSize > MATCH_LIMIT)
+    {
+        std::vector<int64_t> table(1ull << HASH_BITS, -1);
+        const size_t matchLimit = srcSize - MATCH_LIMIT;
+        const size_t extendLimit = srcSize - LAST_LITERALS;
+
+        size_t ip = 0;
+        while (ip < matchLimit)
+        {
+            const uint32_t sequence = Read32(src + ip);
+            const uint32_t h = Hash(sequence);
+            const int64_t ref = table[h];
+            table[h] = (int64_t)ip;
+
+            if (ref < 0 || ip - (size_t)ref > MAX_OFFSET || Read32(src + ref) != sequence)
+            {
+                ip++;
+                continue;
+            }
+
+            //Extend the match as far as possible
+            size_t length = MIN_MATCH;
+            while (ip + length < extendLimit && src[ref + length] == src[ip + length])
+            {
+                length++;
+            }
+
+            _emit(ip, ip - (size_t)ref, length);
+            ip += length;
+            anchor = ip;
+        }
+    }
+
+    //Remaining literals
+    _emit(srcSize, 0, 0);
+
+    return (size_t)(op - dst);
+}
+
+bool Compression::Decompress(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstSize)
+{
+    const uint8_t* ip = src;
+    const uint8_t* const ipEnd = src + srcSize;
+    uint8_t* op = dst;
+    uint8_t* const opEnd = dst + dstSize;
+
+    while (ip < ipEnd)
+    {
+        const uint8_t token = *ip++;
+
+        //Copy the literal run
+        size_t literalLength = token >> 4;
+        if (literalLength == 15 && !ReadLength(ip, ipEnd, literalLength))
+        {
+            return false;
+        }
+        if (literalLength > (size_t)(ipEnd - ip) || literalLength > (size_t)(opEnd - op))
+        {
+            return false;
+        }
+        memcpy(op, ip, literalLength);
+        ip += literalLength;
+        op += literalLength;
+
+        //The final sequence ends after its literals
+        if (ip == ipEnd)
+        {
+            break;
+        }
+
+        //Copy the back-reference
+        if (ipEnd - ip < 2)
+        {
+            return false;
+        }
+        const size_t offset = ip[0] | ((size_t)ip[1] << 8);
+        ip += 2;
+
+        size_t matchLength = token & 15;
+        if (matchLength == 15 && !ReadLength(ip, ipEnd, matchLength))
+        {
+            return false;
+        }
+        matchLength += MIN_MATCH;
+
+        if (offset == 0 || offset > (size_t)(op - dst) || matchLength > (size_t)(opEnd - op))
+        {
+            return false;
+        }
+
+        const uint8_t* match = op - offset;
+        if (offset >= matchLength)
+        {
+            memcpy(op, match, matchLength);
+            op += matchLength;
+        }
+        else
+        {
+            //Overlapping references repeat the last `offset` bytes
+            for (size_t i = 0; i < matchLength; i++)
+            {
+                *op++ = *match++;
+            }
+        }
+    }
+
+    return op == opEnd;
+}
+
+void Compression::Shuffle(const uint8_t* src, uint8_t* dst, size_t size, size_t elementWidth)
+{
+    const size_t count = size / elementWidth;
+    for (size_t b = 0; b < elementWidth; b++)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            dst[b * count + i] = src[i * elementWidth + b];
+        }
+    }
+
+    const size_t tail = count * elementWidth;
+    memcpy(dst + tail, src + tail, size - tail);
+}
+
+void Compression::Unshuffle(const uint8_t* src, uint8_t* dst, size_t size, size_t elementWidth)
+{
+    const size_t count = size / elementWidth;
+    for (size_t i = 0; i < count; i++)
+    {
+        for (size_t b = 0; b < elementWidth; b++)
+        {
+            dst[i * elementWidth + b] = src[b * count + i];
+        }
+    }
+
+    const size_t tail = count * elementWidth;
+    memcpy(dst + tail, src + tail, size - tail);
+}
@@ -1,9 +1,8 @@
+#define LOG_CATEGORY Graphics
 #include "../inc/Graphics/Backends/DX11_GFX.h"
 
 using namespace Engine;
 
-constexpr UINT NUM_THREADS = 4;
-
 //DX11 SETUP ---------------------------------------------------------
 
 void CreateDX11Device(Microsoft::WRL::ComPtr<ID3D11Device>& device, D3D_FEATURE_LEVEL* pFeatureLevel, Microsoft::WRL::ComPtr<ID3D11DeviceContext>& context)
@@ -86,15 +85,22 @@ void CreateDX11SwapChain(const HWND& windowHandle, Microsoft::WRL::ComPtr<ID3D11
     dxgiAdapter->Release();
     dxgiDevice->Release();
 
-    Log("Created SwapChain.\n");
+    LOG_INFO("Created SwapChain.\n");
 }
 
-//TODO: Create Deferred Contexts for use on multiple threads
-void CreateDX11DeferredContexts(Microsoft::WRL::ComPtr<ID3D11Device>& device, std::vector<Microsoft::WRL::ComPtr<ID3D11DeviceContext>>& contexts)
+void CreateDX11DeferredContexts(Microsoft::WRL::ComPtr<ID3D11Device>& device, std::vector<Microsoft::WRL::ComPtr<ID3D11DeviceContext>>& contexts, UINT count)
 {
-    contexts.reserve(NUM_THREADS);
+    //Command lists still work without driver support, but are emulated by the runtime
+    D3D11_FEATURE_DATA_THREADING threading = {};
+    HR(device->CheckFeatureSupport(D3D11_FEATURE_THREADING, &threading, sizeof(threading)), "Threading Support Query Failed!");
+    if (!threading.DriverCommandLists)
+    {
+        LOG_INFO("Driver command lists are unsupported. Deferred contexts will be emulated.\n");
+    }
+
+    contexts.resize(count);
 
-    for(UINT i = 0; i < NUM_THREADS; i++)
+    for(UINT i = 0; i < count; i++)
     {
         HR(device->CreateDeferredContext(
             0,
@@ -161,6 +167,98 @@ void CreateDX11Views(Microsoft::WRL::ComPtr<ID3D11Device>& device, Microsoft::WR
 }
 
 
+//STATE CACHE ---------------------------------------------------------
+
+void BindVertexBuffer(Engine::DX11StateCache& state, ID3D11Buffer* buffer, UINT stride, const Microsoft::WRL::ComPtr<ID3D11DeviceContext>& context)
+{
+    if (state.VertexBuffer == buffer && state.VertexStride == stride)
+    {
+        state.Stats.SkippedBinds++;
+        return;
+    }
+
+    const UINT offset = 0;
+    context->IASetVertexBuffers(0, 1, &buffer, &stride, &offset);
+    state.VertexBuffer = buffer;
+    state.VertexStride = stride;
+    state.Stats.Binds++;
+}
+
+void BindInstanceBuffer(Engine::DX11StateCache& state, ID3D11Buffer* buffer, const Microsoft::WRL::ComPtr<ID3D11DeviceContext>& context)
+{
+    if (state.InstanceBuffer == buffer)
+    {
+        state.Stats.SkippedBinds++;
+        return;
+    }
+
+    const UINT stride = sizeof(Engine::Matrix4x4);
+    const UINT offset = 0;
+    context->IASetVertexBuffers(1, 1, &buffer, &stride, &offset);
+    state.InstanceBuffer = buffer;
+    state.Stats.Binds++;
+}
+
+void BindIndexBuffer(Engine::DX11StateCache& state, ID3D11Buffer* buffer, const Microsoft::WRL::ComPtr<ID3D11DeviceContext>& context)
+{
+    if (state.IndexBuffer == buffer)
+    {
+        state.Stats.SkippedBinds++;
+        return;
+    }
+
+    context->IASetIndexBuffer(buffer, DXGI_FORMAT_R32_UINT, 0);
+    state.IndexBuffer = buffer;
+    state.Stats.Binds++;
+}
+
+void BindInputLayout(Engine::DX11StateCache& state, ID3D11InputLayout* layout, const Microsoft::WRL::ComPtr<ID3D11DeviceContext>& context)
+{
+    if (state.InputLayout == layout)
+    {
+        state.Stats.SkippedBinds++;
+        return;
+    }
+
+    context->IASetInputLayout(layout);
+    state.InputLayout = layout;
+    state.Stats.Binds++;
+}
+
+void BindTopology(Engine::DX11StateCache& state, D3D11_PRIMITIVE_TOPOLOGY topology, const Microsoft::WRL::ComPtr<ID3D11DeviceContext>& context)
+{
+    if (state.Topology == topology)
+    {
+        state.Stats.SkippedBinds++;
+        return;
+    }
+
+    context->IASetPrimitiveTopology(topology);
+    state.Topology = topology;
+    state.Stats.Binds++;
+}
+
+/**
+ * \brief Forgets the state bound to a context, e.g. once it has been cleared.
+ * Textures set on effect variables persist in the effect, so remain cached.
+ */
+void ResetContextState(Engine::DX11StateCache& state)
+{
+    Engine::DX11StateCache reset;
+    reset.Textures = std::move(state.Textures);
+    reset.Stats = state.Stats;
+    state = std::move(reset);
+}
+
+/**
+ * \brief Whether a renderer's material differs from the one last set on the context, for draws which aren't sorted into a queue.
+ */
+bool MaterialChanged(const Engine::DX11StateCache& state, const Engine::DX11ShaderReflection& shader, const Engine::MeshRenderer& renderer)
+{
+    return state.Effect != shader.Effect.Get() || state.Technique != renderer.technique || state.Material != renderer.material;
+}
+
+
 //SHADERS -------------------------------------------------------------
 
 Microsoft::WRL::ComPtr<ID3D10Blob> CompileShader(const Engine::EShaderType type)
@@ -178,13 +276,22 @@ Microsoft::WRL::ComPtr<ID3D10Blob> CompileShader(const Engine::EShaderType type)
     std::basic_string<wchar_t> fxPath = ResourcePool::GetShaderPath(type);
     std::basic_string<wchar_t> cfxPath = ResourcePool::GetCompiledShaderPath(type);
 
-    //Attempt to load the precompiled shader object.
-    D3DReadFileToBlob(cfxPath.c_str(), pBlob.ReleaseAndGetAddressOf());
+    //Attempt to load the precompiled shader object, from a mounted pack if it contains one.
+    auto packed = ResourcePool::GetPackedData(cfxPath);
+    if (!packed.empty())
+    {
+        HR(D3DCreateBlob(packed.size(), pBlob.ReleaseAndGetAddressOf()), "Unable to allocate shader blob");
+        memcpy(pBlob->GetBufferPointer(), packed.data(), packed.size());
+    }
+    else
+    {
+        D3DReadFileToBlob(cfxPath.c_str(), pBlob.ReleaseAndGetAddressOf());
+    }
 
     //If the precompiled shader is not valid, compile the shader directly from source.
     if(pBlob == nullptr)
     {
-        Log("Compiling shader %s from source.\n", Engine::WStringToString(fxPath).c_str());
+        LOG_INFO("Compiling shader %s from source.\n", Engine::WStringToString(fxPath).c_str());
         Time timer;
         timer.Reset();
         timer.Start();
@@ -193,400 +300,595 @@ Microsoft::WRL::ComPtr<ID3D10Blob> CompileShader(const Engine::EShaderType type)
         
         timer.Tick();
         //ERR(pErr != nullptr, ("Shader Compilation Errors Found: \n%s", Engine::WStringToString((LPCWSTR)pErr->GetBufferPointer()).c_str()));
-        Engine::Log("Compiled shader %s in %fs\n", Engine::WStringToString(fxPath).c_str(), timer.DeltaTime());
+        LOG_INFO("Compiled shader %s in %fs\n", Engine::WStringToString(fxPath).c_str(), timer.DeltaTime());
     }
 
     return pBlob;
 }
 
-Microsoft::WRL::ComPtr<ID3DX11Effect> LoadShader(const Engine::MeshRenderer& renderer, const Microsoft::WRL::ComPtr<ID3D11Device>& device)
+//Effect variable semantics, indexed by EShaderVariable
+static const char* SHADER_SEMANTICS[] = {
+    "WORLD",
+    "WORLDVIEWPROJECTION",
+    "COLOUR",
+    "AMBIENT",
+    "DIFFUSE",
+    "Specular",
+    "SPECULARPOWER",
+    "DIRECTION",
+    "CAMERAPOSITION",
+    "T_DIFFUSE",
+    "T_NORMAL",
+    "T_SPECULAR",
+    "T_ATLAS",
+};
+static_assert(ARRAYSIZE(SHADER_SEMANTICS) == (size_t)Engine::EShaderVariable::Count, "Every shader variable requires a semantic.");
+
+/**
+ * \brief Resolves an effect's variables and techniques, so that draws can set them without looking them up by name.
+ */
+void ReflectShader(const Microsoft::WRL::ComPtr<ID3DX11Effect>& shader, Engine::DX11ShaderReflection& reflection)
 {
-    //Attempt to retrieve the compiled shader from the resource pool
-    Microsoft::WRL::ComPtr<ID3DX11Effect> shader = ResourcePool::GetShader(renderer.shader);
+    reflection = {};
+    reflection.Effect = shader;
 
-    //If the shader isn't present, compile it, then add it to the resource pool
-    if(shader == nullptr)
+    for (size_t i = 0; i < (size_t)Engine::EShaderVariable::Count; i++)
+    {
+        //Not every shader uses every variable
+        ID3DX11EffectVariable* var = shader->GetVariableBySemantic(SHADER_SEMANTICS[i]);
+        reflection.Variables[i] = var->IsValid() ? var : nullptr;
+    }
+
+    D3DX11_EFFECT_DESC effectDesc = {};
+    HR(shader->GetDesc(&effectDesc), "Effect Description Acquisition Failed!");
+
+    for (UINT i = 0; i < effectDesc.Techniques; i++)
+    {
+        ID3DX11EffectTechnique* tech = shader->GetTechniqueByIndex(i);
+        D3DX11_TECHNIQUE_DESC techDesc = {};
+        HR(tech->GetDesc(&techDesc), "Technique Description Acquisition Failed!");
+
+        reflection.Passes.emplace_back(techDesc.Name, tech->GetPassByIndex(0));     //TODO: Multiple shader pass support
+    }
+}
+
+/**
+ * \brief Retrieves a shader, loading and reflecting it on first use.
+ * \param reflections The backend's reflected shaders.
+ */
+Engine::DX11ShaderReflection& LoadShader(const Engine::MeshRenderer& renderer, const Microsoft::WRL::ComPtr<ID3D11Device>& device, std::unordered_map<EShaderType, Engine::DX11ShaderReflection>& reflections)
+{
+    Engine::DX11ShaderReflection& reflection = reflections[renderer.shader];
+    if (reflection.Effect != nullptr)
+    {
+        return reflection;
+    }
+
+    //Retrieve the compiled shader from the resource pool. If the shader isn't present, compile it, then add it to the resource pool
+    const ShaderHandle handle = ResourcePool::AcquireShader(renderer.shader, [&]
     {
         auto cShader = CompileShader(renderer.shader);
         ERR((cShader == nullptr), "Compiled Shader was Nullptr!");
 
-        HR(D3DX11CreateEffectFromMemory(cShader->GetBufferPointer(), cShader->GetBufferSize(), 0, device.Get(), shader.GetAddressOf()), "Shader Compilation Failed!");
+        Microsoft::WRL::ComPtr<ID3DX11Effect> effect;
+        HR(D3DX11CreateEffectFromMemory(cShader->GetBufferPointer(), cShader->GetBufferSize(), 0, device.Get(), effect.GetAddressOf()), "Shader Compilation Failed!");
+        return effect;
+    });
+
+    Microsoft::WRL::ComPtr<ID3DX11Effect> shader = ResourcePool::GetShader(handle);
+
+    ReflectShader(shader, reflection);
+    return reflection;
+}
 
-        ResourcePool::AddShader(shader.Get(), renderer.shader);
+/**
+ * \brief Clones a shader for use on another thread, unless it has already been cloned.
+ * Effects track their variables' values, so they can't be shared between threads recording at once.
+ * \param clones The recording thread's shaders.
+ */
+void CloneShader(const Engine::DX11ShaderReflection& source, EShaderType type, std::unordered_map<EShaderType, Engine::DX11ShaderReflection>& clones)
+{
+    Engine::DX11ShaderReflection& clone = clones[type];
+    if (clone.Effect != nullptr)
+    {
+        return;
     }
 
-    return shader;
+    Microsoft::WRL::ComPtr<ID3DX11Effect> effect;
+    HR(source.Effect->CloneEffect(0, effect.GetAddressOf()), "Effect Clone Failed!");
+    ReflectShader(effect, clone);
 }
 
-void SetShaderState(const Microsoft::WRL::ComPtr<ID3DX11Effect>& shader, const Engine::MeshRenderer& renderer, Matrix4x4& world, Camera& camera, const Microsoft::WRL::ComPtr<ID3D11Device>& device, const Microsoft::WRL::ComPtr<ID3D11DeviceContext>& context)
+/**
+ * \brief Describes the vertex layout a shader expects.
+ * \param instanced Whether to append the per-instance world matrix, read from the second vertex buffer slot.
+ */
+std::vector<D3D11_INPUT_ELEMENT_DESC> GetInputElements(const EShaderType type, bool instanced)
+{
+    std::vector<D3D11_INPUT_ELEMENT_DESC> ieDesc = {};
+
+    switch (type)
+    {
+        using enum EShaderType;
+    case(Basic):
+        ieDesc.push_back({ "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0 });
+        break;
+    case Blinn:
+        ieDesc.push_back({ "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0 });
+        ieDesc.push_back({ "TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0 });
+        ieDesc.push_back({ "NORMAL", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0 });
+        ieDesc.push_back({ "TANGENT", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0 });
+        ieDesc.push_back({ "BINORMAL", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0 });
+        break;
+    case SpriteRenderer:
+        ieDesc.push_back({ "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0 });
+        ieDesc.push_back({ "TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0 });
+        break;
+    default:
+        break;
+    }
+
+    if (instanced)
+    {
+        //One row of the instance's world matrix per element
+        for (UINT row = 0; row < 4; row++)
+        {
+            ieDesc.push_back({ "INSTANCEWORLD", row, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_INSTANCE_DATA, 1 });
+        }
+    }
+
+    return ieDesc;
+}
+
+/**
+ * \brief Retrieves the pass of a technique.
+ * \param technique The technique's name. The shader's first technique is used if empty.
+ */
+ID3DX11EffectPass* FindPass(const Engine::DX11ShaderReflection& shader, const std::basic_string<char>& technique)
 {
     // Use the default technique as a fallback
-    Microsoft::WRL::ComPtr<ID3DX11EffectTechnique> tech = shader->GetTechniqueByIndex(0);
-    if(!renderer.technique.empty())
+    ERR(shader.Passes.empty(), "Technique Is Invalid!");
+    ID3DX11EffectPass* techPass = shader.Passes.front().second;
+    if(!technique.empty())
+    {
+        //Attempt to retrieve the effect technique by name. Effects only have a handful of techniques.
+        techPass = nullptr;
+        for (const auto& [name, p] : shader.Passes)
+        {
+            if (name == technique)
+            {
+                techPass = p;
+                break;
+            }
+        }
+    }
+    ERR(techPass == nullptr, "Technique Is Invalid!");
+
+    return techPass;
+}
+
+/**
+ * \brief Retrieves a shader's input layout, creating it on first use.
+ * \param pass A pass of the shader, whose input signature the layout is validated against.
+ */
+Microsoft::WRL::ComPtr<ID3D11InputLayout> GetInputLayout(Engine::DX11ShaderReflection& shader, EShaderType type, ID3DX11EffectPass* pass, const Microsoft::WRL::ComPtr<ID3D11Device>& device, bool instanced)
+{
+    //Instanced layouts are specific to the backend's reflection of the shader
+    Microsoft::WRL::ComPtr<ID3D11InputLayout> inputLayout = instanced ? shader.InstancedLayout : ResourcePool::GetInputLayout(type);
+    
+    if (inputLayout.Get() == nullptr)
+    {
+        std::vector<D3D11_INPUT_ELEMENT_DESC> ieDesc = GetInputElements(type, instanced);
+
+        D3DX11_PASS_DESC passDesc = {};
+        HR(pass->GetDesc(&passDesc), "Pass Description Acquisition Failed!");
+
+        //Cache Input Layout
+        HR(device->CreateInputLayout(&ieDesc.front(), (UINT)ieDesc.size(), passDesc.pIAInputSignature, passDesc.IAInputSignatureSize, inputLayout.GetAddressOf()), "Error: Input Layout Creation Failed.");
+        if (instanced)
+        {
+            shader.InstancedLayout = inputLayout;
+        }
+        else
+        {
+            ResourcePool::AddInputLayout(inputLayout, type);
+        }
+    }
+
+    ERR(inputLayout.Get() == nullptr, "Input layout is Nullptr!");
+    return inputLayout;
+}
+
+/**
+ * \brief Creates a texture from an image.
+ * \param rPath The texture's path, including the Resources directory.
+ * \param data The image file's contents. Read from the path if empty.
+ */
+Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> CreateTexture(const std::basic_string<wchar_t>& rPath, std::span<const uint8_t> data, const Microsoft::WRL::ComPtr<ID3D11Device>& device, const Microsoft::WRL::ComPtr<ID3D11DeviceContext>& context)
+{
+    Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> tex;
+    const bool isDDS = rPath.substr(rPath.find_last_of(L".") + 1) == L"dds";
+
+    //If the texture type is .dds, use the DDS loaders.
+    if (isDDS && !data.empty()) {
+        HR(DirectX::CreateDDSTextureFromMemory(device.Get(), context.Get(), data.data(), data.size(), nullptr, &tex), ("Unable to load Texture <" + Engine::WStringToString(rPath) + ">").c_str());
+    }
+    else if (isDDS) {
+        HR(DirectX::CreateDDSTextureFromFile(device.Get(), context.Get(), rPath.c_str(), nullptr, &tex), ("Unable to load Texture <" + Engine::WStringToString(rPath) + ">").c_str());
+    }
+    //Assume the texture type is WIC compatible otherwise.
+    else if (!data.empty()) {
+        HR(DirectX::CreateWICTextureFromMemory(device.Get(), context.Get(), data.data(), data.size(), nullptr, &tex), ("Unable to load Texture <" + Engine::WStringToString(rPath) + ">").c_str());
+    }
+    else {
+        HR(DirectX::CreateWICTextureFromFile(device.Get(), context.Get(), rPath.c_str(), nullptr, &tex), ("Unable to load Texture <" + Engine::WStringToString(rPath) + ">").c_str());
+    }
+
+    ERR(tex.Get() == nullptr, "Texture Invalid!");
+    return tex;
+}
+
+/**
+ * \brief Retrieves a texture from the resource pool, loading it on first use.
+ * \param id The texture's resource.
+ * \param handle The texture's handle. Resolved from the ID if it's stale.
+ */
+ResourcePool::texture LoadTexture(const Engine::ResourceID& id, Engine::TextureHandle& handle, const Microsoft::WRL::ComPtr<ID3D11Device>& device, const Microsoft::WRL::ComPtr<ID3D11DeviceContext>& context)
+{
+    ResourcePool::texture view = ResourcePool::GetTexture(handle);
+    if (view != nullptr)
+    {
+        return view;
+    }
+
+    //If the resource pool doesn't have the texture, Attempt to load it, then add it.
+    //Textures within a mounted pack are created straight from the mapped file.
+    handle = ResourcePool::AcquireTexture(id, [&]
+    {
+        return CreateTexture(id.GetPath(), ResourcePool::GetPackedData(id.GetPath()), device, context);
+    });
+
+    return ResourcePool::GetTexture(handle);
+}
+
+/**
+ * \brief Loads the textures a renderer's material uses into the resource pool.
+ */
+void LoadMaterialTextures(const Engine::MeshRenderer& renderer, const Microsoft::WRL::ComPtr<ID3D11Device>& device, const Microsoft::WRL::ComPtr<ID3D11DeviceContext>& context)
+{
+    auto _load = [&](const Engine::ResourceID& id, Engine::TextureHandle& handle)
+    {
+        if (!id.IsNull())
+        {
+            LoadTexture(id, handle, device, context);
+        }
+    };
+
+    switch (renderer.shader)
+    {
+        using enum EShaderType;
+    case(Blinn):
     {
-        //Attempt to retrieve the effect technique by name.
-        tech = shader->GetTechniqueByName(renderer.technique.c_str());
+        const auto* material = (const Engine::Blinn*)renderer.material;
+        _load(material->DiffuseMap, material->DiffuseTexture);
+        _load(material->NormalMap, material->NormalTexture);
+        _load(material->SpecularMap, material->SpecularTexture);
+        break;
+    }
+    case SpriteRenderer:
+        _load(((const Engine::SpriteRenderer*)renderer.material)->TextureAtlas, ((const Engine::SpriteRenderer*)renderer.material)->AtlasTexture);
+        break;
+    default:
+        break;
     }
-    ERR(!tech->IsValid(), "Technique Is Invalid!");
+}
 
-    //Retrieve the effect pass
-    D3DX11_PASS_DESC passDesc = {};
-    Microsoft::WRL::ComPtr<ID3DX11EffectPass> pass = tech->GetPassByIndex(0);   //TODO: Multiple shader pass support
-    HR(pass->GetDesc(&passDesc), "Pass Description Acquisition Failed!");
+/**
+ * \brief Sets a shader's variables and input layout, then applies its pass.
+ * \param state The context's state cache. Passes, layouts and textures which are already bound are skipped.
+ * \param materialChanged Whether the shader, technique or material differ from the previous call. If not, only the per-object variables are set.
+ * \param instanced Whether the draw reads per-instance world matrices. The renderer's technique must be an instanced technique.
+ */
+void SetShaderState(Engine::DX11ShaderReflection& shader, const Engine::MeshRenderer& renderer, Matrix4x4& world, Camera& camera, const Microsoft::WRL::ComPtr<ID3D11Device>& device, const Microsoft::WRL::ComPtr<ID3D11DeviceContext>& context, Engine::DX11StateCache& state, bool materialChanged = true, bool instanced = false)
+{
+    PROFILE_SCOPE("SetShaderState");
+    //Retrieve the effect pass, unless it's the one last used
+    if (state.Effect != shader.Effect.Get() || state.Technique != renderer.technique)
+    {
+        state.Effect = shader.Effect.Get();
+        state.Technique = renderer.technique;
+        state.Pass = FindPass(shader, renderer.technique);
+        state.PassDirty = true;
+        state.Material = nullptr;
+        state.ObjectSet = false;
+        state.Stats.Binds++;
+    }
+    else
+    {
+        state.Stats.SkippedBinds++;
+    }
+    ID3DX11EffectPass* pass = state.Pass;
 
     //Set shader variables and input layout
-    auto _setMatrixVar = [&](const std::basic_string<char>& semantic, const Matrix4x4& mat)
+    auto _setMatrixVar = [&](Engine::EShaderVariable slot, const Matrix4x4& mat)
     {
-        Microsoft::WRL::ComPtr<ID3DX11EffectVariable> var = shader->GetVariableBySemantic(semantic.c_str());
-        ERR(var->IsValid() == false, "Variable Semantic is Invalid!");
-        HR(var->AsMatrix()->SetMatrix(reinterpret_cast<const float*>(&mat._matrix)), ("Unable to set variable %s", semantic.c_str()));   
+        ID3DX11EffectVariable* var = shader.Variables[(size_t)slot];
+        ERR(var == nullptr, (std::basic_string<char>("Variable Semantic ") + SHADER_SEMANTICS[(size_t)slot] + " is Invalid!").c_str());
+        HR(var->AsMatrix()->SetMatrix(reinterpret_cast<const float*>(&mat._matrix)), (std::basic_string<char>("Unable to set variable ") + SHADER_SEMANTICS[(size_t)slot]).c_str());   
+        state.PassDirty = true;
     };
 
-    auto _setFloatVar = [&](const std::basic_string<char>& semantic, const float& value)
+    auto _setFloatVar = [&](Engine::EShaderVariable slot, const float& value)
     {
-        Microsoft::WRL::ComPtr<ID3DX11EffectVariable> var = shader->GetVariableBySemantic(semantic.c_str());
-        ERR(var->IsValid() == false, "Variable Semantic is Invalid!");
-        HR(var->SetRawValue(&value, 0, sizeof(float)), ("Unable to set variable %s", semantic.c_str()));
+        ID3DX11EffectVariable* var = shader.Variables[(size_t)slot];
+        ERR(var == nullptr, (std::basic_string<char>("Variable Semantic ") + SHADER_SEMANTICS[(size_t)slot] + " is Invalid!").c_str());
+        HR(var->SetRawValue(&value, 0, sizeof(float)), (std::basic_string<char>("Unable to set variable ") + SHADER_SEMANTICS[(size_t)slot]).c_str());
+        state.PassDirty = true;
     };
 
-    auto _setVector2Var = [&](const std::basic_string<char>& semantic, const Vector2f& value)
+    auto _setVector2Var = [&](Engine::EShaderVariable slot, const Vector2f& value)
     {
-        Microsoft::WRL::ComPtr<ID3DX11EffectVariable> var = shader->GetVariableBySemantic(semantic.c_str());
-        ERR(var->IsValid() == false, "Variable Semantic is Invalid!");
-        HR(var->SetRawValue(&value, 0, sizeof(Engine::Vector2f)), ("Unable to set variable %s", semantic.c_str()));
+        ID3DX11EffectVariable* var = shader.Variables[(size_t)slot];
+        ERR(var == nullptr, (std::basic_string<char>("Variable Semantic ") + SHADER_SEMANTICS[(size_t)slot] + " is Invalid!").c_str());
+        HR(var->SetRawValue(&value, 0, sizeof(Engine::Vector2f)), (std::basic_string<char>("Unable to set variable ") + SHADER_SEMANTICS[(size_t)slot]).c_str());
+        state.PassDirty = true;
     };
 
-    auto _setVector3Var = [&](const std::basic_string<char>& semantic, const Vector3f& value)
+    auto _setVector3Var = [&](Engine::EShaderVariable slot, const Vector3f& value)
     {
-        Microsoft::WRL::ComPtr<ID3DX11EffectVariable> var = shader->GetVariableBySemantic(semantic.c_str());
-        ERR(var->IsValid() == false, "Variable Semantic is Invalid!");
-        HR(var->SetRawValue(&value, 0, sizeof(Engine::Vector3f)), ("Unable to set variable %s", semantic.c_str()));
+        ID3DX11EffectVariable* var = shader.Variables[(size_t)slot];
+        ERR(var == nullptr, (std::basic_string<char>("Variable Semantic ") + SHADER_SEMANTICS[(size_t)slot] + " is Invalid!").c_str());
+        HR(var->SetRawValue(&value, 0, sizeof(Engine::Vector3f)), (std::basic_string<char>("Unable to set variable ") + SHADER_SEMANTICS[(size_t)slot]).c_str());
+        state.PassDirty = true;
     };
 
-    auto _setVector4Var = [&](const std::basic_string<char>& semantic, const Vector4f& value)
+    auto _setVector4Var = [&](Engine::EShaderVariable slot, const Vector4f& value)
     {
-        Microsoft::WRL::ComPtr<ID3DX11EffectVariable> var = shader->GetVariableBySemantic(semantic.c_str());
-        ERR(var->IsValid() == false, "Variable Semantic is Invalid!");
-        HR(var->SetRawValue(&value, 0, sizeof(Engine::Vector4f)), ("Unable to set variable %s", semantic.c_str()));
+        ID3DX11EffectVariable* var = shader.Variables[(size_t)slot];
+        ERR(var == nullptr, (std::basic_string<char>("Variable Semantic ") + SHADER_SEMANTICS[(size_t)slot] + " is Invalid!").c_str());
+        HR(var->SetRawValue(&value, 0, sizeof(Engine::Vector4f)), (std::basic_string<char>("Unable to set variable ") + SHADER_SEMANTICS[(size_t)slot]).c_str());
+        state.PassDirty = true;
     };
 
-    auto _setTextureVar = [&](const std::basic_string<char>& semantic, const std::basic_string<wchar_t>& path)
+    auto _setTextureVar = [&](Engine::EShaderVariable slot, const Engine::ResourceID& id, Engine::TextureHandle& handle)
     {
-        if (!path.empty())
+        if (!id.IsNull())
         {
-            Microsoft::WRL::ComPtr<ID3DX11EffectVariable> var = shader->GetVariableBySemantic(semantic.c_str());
-            ERR(var->IsValid() == false, "Variable Semantic is Invalid!");
+            ID3DX11EffectVariable* var = shader.Variables[(size_t)slot];
+            ERR(var == nullptr, (std::basic_string<char>("Variable Semantic ") + SHADER_SEMANTICS[(size_t)slot] + " is Invalid!").c_str());
 
-            std::basic_string<wchar_t> rPath;
-            //Convert the path to a relative path
-            if (path.starts_with(L"Resources\\") == false) {
-                rPath = L"Resources\\";
-            }
-            rPath.append(path);
-            
-            Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> tex = ResourcePool::GetTexture(rPath);
+            const ResourcePool::texture tex = LoadTexture(id, handle, device, context);
 
-            //If the resource pool doesn't have the texture, Attempt to load it, then add it.
-            if (tex.Get() == nullptr)
+            //Skip textures which are already set
+            auto& bound = state.Textures[var];
+            if (bound == handle)
             {
-                //If the texture type is .dds, use the DDS loaders.
-                if (path.substr(path.find_last_of(L".") + 1) == L"dds") {
-                    HR(DirectX::CreateDDSTextureFromFile(device.Get(), context.Get(), rPath.c_str(), nullptr, &tex), ("Unable to load Texture <%s>", Engine::WStringToString(rPath.c_str()).c_str()));
-                }
-
-                //Assume the texture type is WIC compatible otherwise.
-                else {
-                    HR(DirectX::CreateWICTextureFromFile(device.Get(), context.Get(), rPath.c_str(), nullptr, &tex), ("Unable to load Texture <%s>", Engine::WStringToString(rPath.c_str()).c_str()));
-                }
-
-                ResourcePool::AddTexture(tex.Get(), rPath);
+                state.Stats.SkippedBinds++;
+                return;
             }
 
-            ERR(tex.Get() == nullptr, "Texture Invalid!");
-
-            var = shader->GetVariableBySemantic(semantic.c_str());
-            HR(var->AsShaderResource()->SetResource(tex.Get()), ("Unable to set Effect Texture %s \nPath:%s", semantic.c_str(), Engine::WStringToString(path).c_str()));
+            HR(var->AsShaderResource()->SetResource(tex.Get()), (std::basic_string<char>("Unable to set Effect Texture ") + SHADER_SEMANTICS[(size_t)slot] + " \nPath:" + Engine::WStringToString(id.GetPath())).c_str());
+            bound = handle;
+            state.PassDirty = true;
+            state.Stats.Binds++;
         }
     };
 
     //Set the Input Layout
+    if (materialChanged)
     {
-        std::vector<D3D11_INPUT_ELEMENT_DESC> ieDesc = {};
-        Microsoft::WRL::ComPtr<ID3D11InputLayout> inputLayout = ResourcePool::GetInputLayout(renderer.shader);
-        
-        if (inputLayout.Get() == nullptr)
+        Microsoft::WRL::ComPtr<ID3D11InputLayout> inputLayout = GetInputLayout(shader, renderer.shader, pass, device, instanced);
+        BindInputLayout(state, inputLayout.Get(), context);
+    }
+    //Set Effect Variables
+    {
+        const Matrix4x4 viewProjection = Engine::Math::MatrixMultiply(camera.viewMatrix, camera.projMatrix);
+        const Matrix4x4 worldViewProj = renderer.shader == EShaderType::SpriteRenderer ? Engine::Math::MatrixMultiply(world, camera.orthoProjMatrix) : Engine::Math::MatrixMultiply(world, viewProjection);
+
+        //Per-object variables, unless they're unchanged from the last object
+        if (!state.ObjectSet || memcmp(&state.World, &world, sizeof(Matrix4x4)) != 0 || memcmp(&state.WorldViewProjection, &worldViewProj, sizeof(Matrix4x4)) != 0)
         {
             switch (renderer.shader)
             {
                 using enum EShaderType;
             case(Basic):
-                ieDesc.push_back({ "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0 });
+                _setMatrixVar(Engine::EShaderVariable::WorldViewProjection, worldViewProj);
                 break;
-            case Blinn:
-                ieDesc.push_back({ "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0 });
-                ieDesc.push_back({ "TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0 });
-                ieDesc.push_back({ "NORMAL", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0 });
-                ieDesc.push_back({ "TANGENT", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0 });
-                ieDesc.push_back({ "BINORMAL", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0 });
+            case(Blinn):
+                _setMatrixVar(Engine::EShaderVariable::World, world);
+                _setMatrixVar(Engine::EShaderVariable::WorldViewProjection, worldViewProj);
                 break;
             case SpriteRenderer:
-                ieDesc.push_back({ "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0 });
-                ieDesc.push_back({ "TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0 });
+                _setMatrixVar(Engine::EShaderVariable::WorldViewProjection, worldViewProj);
                 break;
             default:
                 break;
             }
 
-            //Cache Input Layout
-            HR(device->CreateInputLayout(&ieDesc.front(), (UINT)ieDesc.size(), passDesc.pIAInputSignature, passDesc.IAInputSignatureSize, inputLayout.GetAddressOf()), "Error: Input Layout Creation Failed.");
-            ResourcePool::AddInputLayout(inputLayout, renderer.shader);
+            state.ObjectSet = true;
+            state.World = world;
+            state.WorldViewProjection = worldViewProj;
+            state.Stats.Binds++;
+        }
+        else
+        {
+            state.Stats.SkippedBinds++;
         }
-
-        ERR(inputLayout.Get() == nullptr, "Input layout is Nullptr!");
-        context->IASetInputLayout(inputLayout.Get());
-        
     }
-    //Set Effect Variables
-    {
-        const Matrix4x4 viewProjection = Engine::Math::MatrixMultiply(camera.viewMatrix, camera.projMatrix);
-        const Matrix4x4 worldViewProj = Engine::Math::MatrixMultiply(world, viewProjection);
-        
-        const Matrix4x4 worldProj2D = Engine::Math::MatrixMultiply(world, camera.orthoProjMatrix);
 
+    //Material variables persist in the effect until they're next set
+    if (materialChanged)
+    {
         switch (renderer.shader)
         {
             using enum EShaderType;
         case(Basic):
-            _setMatrixVar("WORLDVIEWPROJECTION", worldViewProj);
-            _setVector4Var("COLOUR", Engine::Math::Normalize(((Engine::Basic*)renderer.material)->Diffuse));
+            _setVector4Var(Engine::EShaderVariable::Colour, Engine::Math::Normalize(((Engine::Basic*)renderer.material)->Diffuse));
             break;
         case(Blinn):
-            _setMatrixVar("WORLD", world);
-            _setMatrixVar("WORLDVIEWPROJECTION", worldViewProj);
-            _setVector4Var("AMBIENT", Engine::Math::Normalize(((Engine::Blinn*)renderer.material)->Ambient));
-            _setVector4Var("DIFFUSE", Engine::Math::Normalize(((Engine::Blinn*)renderer.material)->Diffuse));
-            _setVector4Var("Specular", Engine::Math::Normalize(((Engine::Blinn*)renderer.material)->Specular));
-            _setFloatVar("SPECULARPOWER", ((Engine::Blinn*)renderer.material)->SpecularPower);
-            _setVector3Var("DIRECTION", {-0.35f, -0.60f, -0.17f});  //TODO: Light Attributes
-            _setVector3Var("CAMERAPOSITION", camera.Position);
-            _setTextureVar("T_DIFFUSE", ((Engine::Blinn*)renderer.material)->DiffuseMap);
-            _setTextureVar("T_NORMAL", ((Engine::Blinn*)renderer.material)->NormalMap);
-            _setTextureVar("T_SPECULAR", ((Engine::Blinn*)renderer.material)->SpecularMap);
+            _setVector4Var(Engine::EShaderVariable::Ambient, Engine::Math::Normalize(((Engine::Blinn*)renderer.material)->Ambient));
+            _setVector4Var(Engine::EShaderVariable::Diffuse, Engine::Math::Normalize(((Engine::Blinn*)renderer.material)->Diffuse));
+            _setVector4Var(Engine::EShaderVariable::Specular, Engine::Math::Normalize(((Engine::Blinn*)renderer.material)->Specular));
+            _setFloatVar(Engine::EShaderVariable::SpecularPower, ((Engine::Blinn*)renderer.material)->SpecularPower);
+            _setVector3Var(Engine::EShaderVariable::Direction, {-0.35f, -0.60f, -0.17f});  //TODO: Light Attributes
+            _setVector3Var(Engine::EShaderVariable::CameraPosition, camera.Position);
+            _setTextureVar(Engine::EShaderVariable::DiffuseMap, ((Engine::Blinn*)renderer.material)->DiffuseMap, ((Engine::Blinn*)renderer.material)->DiffuseTexture);
+            _setTextureVar(Engine::EShaderVariable::NormalMap, ((Engine::Blinn*)renderer.material)->NormalMap, ((Engine::Blinn*)renderer.material)->NormalTexture);
+            _setTextureVar(Engine::EShaderVariable::SpecularMap, ((Engine::Blinn*)renderer.material)->SpecularMap, ((Engine::Blinn*)renderer.material)->SpecularTexture);
             break;
         case SpriteRenderer:
-            _setMatrixVar("WORLDVIEWPROJECTION", worldProj2D);
-            _setTextureVar("T_ATLAS", ((Engine::SpriteRenderer*)renderer.material)->TextureAtlas);
+            _setTextureVar(Engine::EShaderVariable::Atlas, ((Engine::SpriteRenderer*)renderer.material)->TextureAtlas, ((Engine::SpriteRenderer*)renderer.material)->AtlasTexture);
             break;
         default:
             break;
         }
+
+        state.Material = renderer.material;
     }
 
-    pass->Apply(0, context.Get());
+    //Applying the pass uploads changed variables, so it can only be skipped if none have changed
+    if (state.PassDirty)
+    {
+        pass->Apply(0, context.Get());
+        state.PassDirty = false;
+        state.Stats.Binds++;
+    }
+    else
+    {
+        state.Stats.SkippedBinds++;
+    }
 
 }
 
 
 //MODEL LOADING --------------------------------------------------------
 
-void CreateBuffers(const Engine::MeshFilter& mesh, Engine::Camera& camera, const EShaderType& type, const Microsoft::WRL::ComPtr<ID3D11Device>& device, const Microsoft::WRL::ComPtr<ID3D11DeviceContext>& context, bool cacheBuffer = true)
+/**
+ * \brief Retrieves a mesh's vertex and index buffers from the resource pool, creating them on first use.
+ * Meshes which change from frame to frame should be streamed through the upload rings instead.
+ */
+ResourcePool::MeshBuffers LoadBuffers(const Engine::MeshFilter& mesh, const EShaderType& type, const Microsoft::WRL::ComPtr<ID3D11Device>& device, Engine::DX11StateCache& state)
 {
-    unsigned vertexSize = 0;
-    unsigned stride = 0;
-    unsigned offset = 0;
-
-    std::bitset<10> attributeFlags;
-
-    //Set the attribute flags based on the shader type
-    switch(type)
+    //The handle travels with the mesh, so meshes which are moved or copied keep their buffers
+    ResourcePool::MeshBuffers buffers = ResourcePool::GetMesh(mesh.Buffers);
+    if (buffers.VertexBuffer != nullptr)
     {
-        using enum EShaderType;
-    case(Basic):
-        attributeFlags.set((size_t)EVertexAttributes::Position);
-        break;
-    case(Blinn):
-        attributeFlags.set((size_t)EVertexAttributes::Position);
-        attributeFlags.set((size_t)EVertexAttributes::TexCoord);
-        attributeFlags.set((size_t)EVertexAttributes::Normal);
-        attributeFlags.set((size_t)EVertexAttributes::Tangent);
-        attributeFlags.set((size_t)EVertexAttributes::Binormal);
-    break;
-    case SpriteRenderer:
-        attributeFlags.set((size_t)EVertexAttributes::Position);
-        attributeFlags.set((size_t)EVertexAttributes::TexCoord);
-        break;
-    default:
-        break;
+        return buffers;
     }
 
-    //Set the correct vertex size (4 bytes per float)
-    attributeFlags.test((size_t)EVertexAttributes::Position) ? vertexSize += 3 : NULL;
-    attributeFlags.test((size_t)EVertexAttributes::TexCoord) ? vertexSize += 2 : NULL;
-    attributeFlags.test((size_t)EVertexAttributes::Normal) ? vertexSize += 3 : NULL;
-    attributeFlags.test((size_t)EVertexAttributes::Tangent) ? vertexSize += 3 : NULL;
-    attributeFlags.test((size_t)EVertexAttributes::Binormal) ? vertexSize += 3 : NULL;
-
     Microsoft::WRL::ComPtr<ID3D11Buffer> vertexBuffer;
-    if (cacheBuffer) {
-        vertexBuffer = ResourcePool::GetVertexBuffer(&mesh);
-    }
-    if (vertexBuffer.Get() == nullptr) {
-        std::vector<float> verts;
-        verts.reserve(mesh.Vertices.size() * vertexSize);
+    std::vector<float> verts;
+    Engine::VertexLayout::Interleave(mesh, type, verts);
 
-        //Assume all models include vertex positions
-        for (size_t i = 0; i < mesh.Vertices.size(); i++)
-        {
-            //Load Positions, and other attributes, based on flags
-            if (attributeFlags.test((size_t)EVertexAttributes::Position) && !mesh.Vertices.empty())
-            {
-                verts.emplace_back(mesh.Vertices[i].x);
-                verts.emplace_back(mesh.Vertices[i].y);
-                verts.emplace_back(mesh.Vertices[i].z);
-            }
-
-            if (attributeFlags.test((size_t)EVertexAttributes::TexCoord))
-            {
-                if (!mesh.TexCoords.empty())
-                {
-                    verts.emplace_back(mesh.TexCoords[i].x);
-                    verts.emplace_back(mesh.TexCoords[i].y);
-                }
-                else
-                {
-                    //Log("Warning: <%s> Mesh texture coordinates are invalid. Defaulting to null.\n", mesh.Name);
-                    verts.emplace_back(0.0f);
-                    verts.emplace_back(0.0f);
-                }
-            }
-
-            if (attributeFlags.test((size_t)EVertexAttributes::Normal))
-            {
-                if (!mesh.Normals.empty())
-                {
-                    verts.emplace_back(mesh.Normals[i].x);
-                    verts.emplace_back(mesh.Normals[i].y);
-                    verts.emplace_back(mesh.Normals[i].z);
-                }
-                else
-                {
-                    verts.emplace_back(0.0f);
-                    verts.emplace_back(0.0f);
-                    verts.emplace_back(0.0f);
-                }
-            }
-
-            if (attributeFlags.test((size_t)EVertexAttributes::Tangent))
-            {
-                if (!mesh.Tangents.empty())
-                {
-                    verts.emplace_back(mesh.Tangents[i].x);
-                    verts.emplace_back(mesh.Tangents[i].y);
-                    verts.emplace_back(mesh.Tangents[i].z);
-                }
-                else
-                {
-                    verts.emplace_back(0.0f);
-                    verts.emplace_back(0.0f);
-                    verts.emplace_back(0.0f);
-                }
-            }
+    //Create the Vertex Buffer
+    if (!verts.empty())
+    {
+        D3D11_BUFFER_DESC vbd;
+        ZeroMemory(&vbd, sizeof(vbd));
+        vbd.ByteWidth = (UINT)verts.size() * sizeof(float);
+        vbd.Usage = D3D11_USAGE_IMMUTABLE;
+        vbd.BindFlags = D3D11_BIND_VERTEX_BUFFER;
 
-            if (attributeFlags.test((size_t)EVertexAttributes::Binormal))
-            {
-                if (!mesh.Binormals.empty())
-                {
-                    verts.emplace_back(mesh.Binormals[i].x);
-                    verts.emplace_back(mesh.Binormals[i].y);
-                    verts.emplace_back(mesh.Binormals[i].z);
-                }
-                else
-                {
-                    verts.emplace_back(0.0f);
-                    verts.emplace_back(0.0f);
-                    verts.emplace_back(0.0f);
-                }
-            }
-        }
+        D3D11_SUBRESOURCE_DATA vertexSubresourceData = {};
+        ZeroMemory(&vertexSubresourceData, sizeof(vertexSubresourceData));
 
-        verts.shrink_to_fit();
+        
+        vertexSubresourceData.pSysMem = verts.data();
+        HR(device->CreateBuffer(&vbd, &vertexSubresourceData, vertexBuffer.ReleaseAndGetAddressOf()), "Vertex Buffer Creation Failed!");
+        state.Stats.BytesUploaded += vbd.ByteWidth;
+    }
 
-        //Bind the Vertex Buffer
-        if (!verts.empty())
-        {
-            D3D11_BUFFER_DESC vbd;
-            ZeroMemory(&vbd, sizeof(vbd));
-            vbd.ByteWidth = (UINT)verts.size() * sizeof(float);
-            vbd.Usage = D3D11_USAGE_IMMUTABLE;
-            vbd.BindFlags = D3D11_BIND_VERTEX_BUFFER;
-
-            D3D11_SUBRESOURCE_DATA vertexSubresourceData = {};
-            ZeroMemory(&vertexSubresourceData, sizeof(vertexSubresourceData));
-
-            
-            vertexSubresourceData.pSysMem = verts.data();
-            HR(device->CreateBuffer(&vbd, &vertexSubresourceData, vertexBuffer.ReleaseAndGetAddressOf()), "Vertex Buffer Creation Failed!");
-        }
+    ERR(vertexBuffer.Get() == nullptr, "Vertex Buffer is Invalid!");
 
-        ResourcePool::AddVertexBuffer(vertexBuffer.Get(), &mesh);
+    //Load the Index Buffer
+    Microsoft::WRL::ComPtr<ID3D11Buffer> ib;
+    if (!mesh.Indices.empty()) {
+        D3D11_BUFFER_DESC ibd = {};
+        ibd.Usage = D3D11_USAGE_DEFAULT;
+        ibd.ByteWidth = (UINT)(mesh.Indices.size() * sizeof(int));
+        ibd.BindFlags = D3D11_BIND_INDEX_BUFFER;
+        ibd.CPUAccessFlags = 0;
+        ibd.MiscFlags = 0;
+        ibd.StructureByteStride = sizeof(int);
+
+        D3D11_SUBRESOURCE_DATA iInitData = {};
+        iInitData.pSysMem = &mesh.Indices[0];
+
+        HR(device->CreateBuffer(&ibd, &iInitData, ib.ReleaseAndGetAddressOf()), "Index Buffer Creation Failed!");
+        state.Stats.BytesUploaded += ibd.ByteWidth;
     }
 
-    stride = sizeof(float) * vertexSize;
-    offset = 0;
+    mesh.Buffers = ResourcePool::AddMesh(vertexBuffer, ib);
+    return { vertexBuffer, ib };
+}
 
-    ERR(vertexBuffer.Get() == nullptr, "Vertex Buffer is Invalid!");
+void CreateBuffers(const Engine::MeshFilter& mesh, Engine::Camera& camera, const EShaderType& type, const Microsoft::WRL::ComPtr<ID3D11Device>& device, const Microsoft::WRL::ComPtr<ID3D11DeviceContext>& context, Engine::DX11StateCache& state)
+{
+    PROFILE_SCOPE("CreateBuffers");
+    const ResourcePool::MeshBuffers buffers = LoadBuffers(mesh, type, device, state);
 
-    context->IASetVertexBuffers(0, 1, vertexBuffer.GetAddressOf(), &stride, &offset);
+    const UINT stride = sizeof(float) * Engine::VertexLayout::GetVertexSize(type);
+    BindVertexBuffer(state, buffers.VertexBuffer.Get(), stride, context);
 
-    Microsoft::WRL::ComPtr<ID3D11Buffer> ib;
+    if (!mesh.Indices.empty()) {
+        ERR(buffers.IndexBuffer == nullptr, "Index Buffer is Invalid!");
+        BindIndexBuffer(state, buffers.IndexBuffer.Get(), context);
+    }
+        
+}
 
-    if (cacheBuffer) {
-        ib = ResourcePool::GetIndexBuffer(&mesh);
+/**
+ * \brief Writes data into a dynamic buffer, recreating the buffer if it is too small.
+ * \param buffer The buffer to write to. Created on first use.
+ * \param bindFlags How the buffer is bound to the pipeline.
+ * \param data The data to write.
+ * \param size The size of the data, in bytes.
+ */
+void WriteDynamicBuffer(Microsoft::WRL::ComPtr<ID3D11Buffer>& buffer, UINT bindFlags, const void* data, UINT size, const Microsoft::WRL::ComPtr<ID3D11Device>& device, const Microsoft::WRL::ComPtr<ID3D11DeviceContext>& context)
+{
+    D3D11_BUFFER_DESC desc = {};
+    if (buffer.Get() != nullptr)
+    {
+        buffer->GetDesc(&desc);
     }
-    //Load the Index Buffer
-    if (!mesh.Indices.empty()) {
-        if (ib.Get() == nullptr) {
-            //If the index buffer doesn't exist, Load model indices
-            D3D11_BUFFER_DESC ibd = {};
-            ibd.Usage = D3D11_USAGE_DEFAULT;
-            ibd.ByteWidth = (UINT)(mesh.Indices.size() * sizeof(int));
-            ibd.BindFlags = D3D11_BIND_INDEX_BUFFER;
-            ibd.CPUAccessFlags = 0;
-            ibd.MiscFlags = 0;
-            ibd.StructureByteStride = sizeof(int);
-
-            D3D11_SUBRESOURCE_DATA iInitData = {};
-            iInitData.pSysMem = &mesh.Indices[0];
-
-            device->CreateBuffer(&ibd, &iInitData, ib.ReleaseAndGetAddressOf());
-
-            ResourcePool::AddIndexBuffer(ib.Get(), &mesh);
-        }
 
-        ERR(ib.Get() == nullptr, "Index Buffer is Invalid!");
-        context->IASetIndexBuffer(ib.Get(), DXGI_FORMAT_R32_UINT, 0);
+    //Grow geometrically, so that the buffer is rarely recreated
+    if (buffer.Get() == nullptr || desc.ByteWidth < size)
+    {
+        const UINT grown = desc.ByteWidth * 2;
+        desc = {};
+        desc.ByteWidth = size > grown ? size : grown;
+        desc.Usage = D3D11_USAGE_DYNAMIC;
+        desc.BindFlags = bindFlags;
+        desc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+
+        HR(device->CreateBuffer(&desc, nullptr, buffer.ReleaseAndGetAddressOf()), "Dynamic Buffer Creation Failed!");
     }
-        
+
+    D3D11_MAPPED_SUBRESOURCE mapped = {};
+    HR(context->Map(buffer.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped), "Unable to map Dynamic Buffer");
+    memcpy(mapped.pData, data, size);
+    context->Unmap(buffer.Get(), 0);
 }
 
-void SetPrimitiveTopology(const Engine::MeshRenderer renderer,const Microsoft::WRL::ComPtr<ID3D11DeviceContext>& context)
+void SetPrimitiveTopology(const Engine::MeshRenderer renderer, const Microsoft::WRL::ComPtr<ID3D11DeviceContext>& context, Engine::DX11StateCache& state)
 {
     switch (renderer.topology)
     {
     case(Engine::EPrimitiveTopology::Points):
-        context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_POINTLIST);
+        BindTopology(state, D3D11_PRIMITIVE_TOPOLOGY_POINTLIST, context);
         break;
     case(Engine::EPrimitiveTopology::TriangleList):
-        context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+        BindTopology(state, D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST, context);
         break;
     case(Engine::EPrimitiveTopology::TriangleStrip):
-        context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLESTRIP);
+        BindTopology(state, D3D11_PRIMITIVE_TOPOLOGY_TRIANGLESTRIP, context);
         break;
     case(Engine::EPrimitiveTopology::LineList):
-        context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_LINELIST);
+        BindTopology(state, D3D11_PRIMITIVE_TOPOLOGY_LINELIST, context);
         break;
     case(Engine::EPrimitiveTopology::LineStrip):
-        context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_LINESTRIP);
+        BindTopology(state, D3D11_PRIMITIVE_TOPOLOGY_LINESTRIP, context);
         break;
 
     default:
@@ -595,6 +897,55 @@ void SetPrimitiveTopology(const Engine::MeshRenderer renderer,const Microsoft::W
 }
 
 
+/**
+ * \brief Records a run of sorted render commands into a context. State is only rebound where it differs from the previous command.
+ * \param reflections The shaders to draw with. Each recording thread requires its own.
+ */
+void RecordCommands(std::span<const Engine::RenderCommand> commands, Engine::Camera& camera, std::unordered_map<EShaderType, Engine::DX11ShaderReflection>& reflections, const Microsoft::WRL::ComPtr<ID3D11Device>& device, const Microsoft::WRL::ComPtr<ID3D11DeviceContext>& context, Engine::DX11StateCache& state)
+{
+    Engine::DX11ShaderReflection* shader = nullptr;
+    const Engine::RenderCommand* previous = nullptr;
+
+    for (const auto& command : commands)
+    {
+        const Engine::MeshRenderer& renderer = *command.Renderer;
+        const bool shaderChanged = previous == nullptr || previous->Renderer->shader != renderer.shader;
+        const bool materialChanged = shaderChanged || previous->Technique != command.Technique || previous->Material != command.Material;
+
+        if (shaderChanged)
+        {
+            shader = &LoadShader(renderer, device, reflections);
+        }
+
+        //The vertex layout depends on the shader, so buffers are rebound when either changes
+        if (shaderChanged || previous->Mesh != command.Mesh)
+        {
+            CreateBuffers(*command.Mesh, camera, renderer.shader, device, context, state);
+        }
+
+        Matrix4x4 world = command.World;
+        SetShaderState(*shader, renderer, world, camera, device, context, state, materialChanged);
+
+        if (previous == nullptr || previous->Renderer->topology != renderer.topology)
+        {
+            SetPrimitiveTopology(renderer, context, state);
+        }
+
+        if (!command.Mesh->Indices.empty())
+        {
+            context->DrawIndexed((UINT)command.Mesh->Indices.size(), 0, 0);
+            state.Stats.DrawCalls++;
+        }
+        else if (!command.Mesh->Vertices.empty())
+        {
+            context->Draw((UINT)command.Mesh->Vertices.size(), 0);
+            state.Stats.DrawCalls++;
+        }
+
+        previous = &command;
+    }
+}
+
 
 //DX11 Graphics Class Methods -----------------------------------------------------------------
 
@@ -616,10 +967,20 @@ bool DX11_GFX::Init(Engine::Window& window, Engine::GraphicsMode mode)
 
     CreateDX11Views(m_pDevice, m_pContext, m_pSwapChain, m_pRenderTargetView, m_pDepthStencilView, m_BackBufferDesc, m_Viewport, mode);
 
+    m_Reloader = HotReload::Register([this](const std::basic_string<wchar_t>& path) { return ReloadAsset(path); });
+
     window.m_Gfx = this;
     return true;
 }
 
+DX11_GFX::~DX11_GFX()
+{
+    if (m_Reloader != 0)
+    {
+        HotReload::Unregister(m_Reloader);
+    }
+}
+
 /**
  * \brief Clears the window to a specified colour (8-bit RGBA format).
  */
@@ -635,7 +996,40 @@ void DX11_GFX::Clear(uint8_t r, uint8_t g, uint8_t b, uint8_t a)
  */
 void DX11_GFX::Present()
 {
+    //Fence the frame's transient geometry, so that its space in the upload rings can be reused once the GPU is done with it
+    m_Frame++;
+    m_TransientVertices.Ring.EndFrame(m_Frame);
+    m_TransientIndices.Ring.EndFrame(m_Frame);
+
+    Microsoft::WRL::ComPtr<ID3D11Query> fence;
+    if (!m_FreeFences.empty())
+    {
+        fence = m_FreeFences.back();
+        m_FreeFences.pop_back();
+    }
+    else
+    {
+        D3D11_QUERY_DESC qd = {};
+        qd.Query = D3D11_QUERY_EVENT;
+        HR(m_pDevice->CreateQuery(&qd, fence.GetAddressOf()), "Frame Fence Creation Failed!");
+    }
+    m_pContext->End(fence.Get());
+    m_FrameFences.emplace_back(m_Frame, fence);
+
     m_pSwapChain->Present(0, 0);
+    RetireFrames(false);
+
+    //Swap in assets which have changed on disk, then evict pooled resources which have gone unused, if the pool is over budget
+    HotReload::Apply();
+    ResourcePool::EndFrame();
+
+    //Materials may be edited before the next frame, so their variables are set again on first use
+    m_State.Material = nullptr;
+
+    //Publish this frame's statistics, and start counting the next
+    m_FrameStats = m_State.Stats;
+    m_State.Stats = {};
+    Profiler::EndFrame();
 }
 
 /**
@@ -659,34 +1053,37 @@ void DX11_GFX::SetGraphicsMode(const Window& window, GraphicsMode mode)
  */
 void DX11_GFX::Draw(Matrix4x4& worldMatrix, const MeshFilter& mesh, const MeshRenderer& renderer, Camera& camera)
 {
+    PROFILE_SCOPE("Draw Mesh");
     //Draw the model using its world matrix, and the camera's view and projection matrices
 
     //Load the appropriate shader
-    auto shader = LoadShader(renderer, m_pDevice);
+    auto& shader = LoadShader(renderer, m_pDevice, m_Shaders);
 
     //Bind the vertex and index buffers to the pipeline
-    CreateBuffers(mesh, camera, renderer.shader, m_pDevice, m_pContext);
+    CreateBuffers(mesh, camera, renderer.shader, m_pDevice, m_pContext, m_State);
 
-    //Set shader parameters
-    SetShaderState(shader, renderer, worldMatrix, camera, m_pDevice, m_pContext);
+    //Set shader parameters. Material variables are only set when the material differs from the last draw's.
+    SetShaderState(shader, renderer, worldMatrix, camera, m_pDevice, m_pContext, m_State, MaterialChanged(m_State, shader, renderer));
 
 
     //Set the primitive topology appropriately
-    SetPrimitiveTopology(renderer, m_pContext);
+    SetPrimitiveTopology(renderer, m_pContext, m_State);
 
     //...
 
     if (!mesh.Indices.empty()) {
         m_pContext->DrawIndexed((UINT)mesh.Indices.size(), 0, 0);
+        m_State.Stats.DrawCalls++;
     }
     else if(!mesh.Vertices.empty())
     {
         m_pContext->Draw((UINT)mesh.Vertices.size(), 0);
+        m_State.Stats.DrawCalls++;
     }
 
 
 }/**W
- * \brief Draws Text to the screen.
+ * \brief Draws a Sprite to the screen.
  * \param worldMatrix 
  * \param sprite 
  * \param renderer 
@@ -694,29 +1091,473 @@ void DX11_GFX::Draw(Matrix4x4& worldMatrix, const MeshFilter& mesh, const MeshRe
  */
 void DX11_GFX::Draw(Matrix4x4& worldMatrix, const Sprite& sprite, Camera& camera)
 {
-    //Draw the model using its world matrix, and the camera's view and projection matrices
+    PROFILE_SCOPE("Draw Sprite");
+    DrawTransient(worldMatrix, sprite.m_Sprite, sprite.m_Renderer, camera);
+}
 
-    //Load the appropriate shader
-    auto shader = LoadShader(sprite.m_Renderer, m_pDevice);
+/**
+ * \brief Draws Text to the screen, as a single draw call.
+ * \param worldMatrix 
+ * \param text 
+ * \param camera 
+ */
+void DX11_GFX::Draw(Matrix4x4& worldMatrix, const Text& text, Camera& camera)
+{
+    PROFILE_SCOPE("Draw Text");
+    if (text.m_Mesh.Indices.empty())
+    {
+        return;
+    }
 
-    //Bind the vertex and index buffers to the pipeline
-    CreateBuffers(sprite.m_Sprite, camera, sprite.m_Renderer.shader, m_pDevice, m_pContext, false); //NOTE: Hack to get text rendering properly without spritebatching. 
+    //The mesh changes whenever the string does, so it's streamed rather than cached
+    DrawTransient(worldMatrix, text.m_Mesh, text.m_Renderer, camera);
+}
 
-    //Set shader parameters
-    SetShaderState(shader, sprite.m_Renderer, worldMatrix, camera, m_pDevice, m_pContext);
+/**
+ * \brief Draws a mesh which only lives for the frame, streaming it through the upload rings.
+ */
+void DX11_GFX::DrawTransient(Matrix4x4& worldMatrix, const MeshFilter& mesh, const MeshRenderer& renderer, Camera& camera)
+{
+    PROFILE_SCOPE("Draw Transient");
+    const UINT stride = sizeof(float) * VertexLayout::GetVertexSize(renderer.shader);
+    if (mesh.Vertices.empty() || stride == 0)
+    {
+        return;
+    }
 
+    auto& shader = LoadShader(renderer, m_pDevice, m_Shaders);
 
-    //Set the primitive topology appropriately
-    SetPrimitiveTopology(sprite.m_Renderer, m_pContext);
+    //Allocations are aligned to the stride, so that draws can address them without rebinding the buffers
+    VertexLayout::Interleave(mesh, renderer.shader, m_TransientScratch);
+    const UINT vertexOffset = WriteTransient(m_TransientVertices, m_TransientScratch.data(), (UINT)(m_TransientScratch.size() * sizeof(float)), stride);
+    BindVertexBuffer(m_State, m_TransientVertices.Buffer.Get(), stride, m_pContext);
 
-    //...
+    UINT indexOffset = 0;
+    if (!mesh.Indices.empty())
+    {
+        indexOffset = WriteTransient(m_TransientIndices, mesh.Indices.data(), (UINT)(mesh.Indices.size() * sizeof(uint32_t)), sizeof(uint32_t));
+        BindIndexBuffer(m_State, m_TransientIndices.Buffer.Get(), m_pContext);
+    }
 
-    if (!sprite.m_Sprite.Indices.empty()) {
-        m_pContext->DrawIndexed((UINT)sprite.m_Sprite.Indices.size(), 0, 0);
+    SetShaderState(shader, renderer, worldMatrix, camera, m_pDevice, m_pContext, m_State, MaterialChanged(m_State, shader, renderer));
+    SetPrimitiveTopology(renderer, m_pContext, m_State);
+
+    if (!mesh.Indices.empty())
+    {
+        m_pContext->DrawIndexed((UINT)mesh.Indices.size(), indexOffset / sizeof(uint32_t), vertexOffset / stride);
     }
-    else if(!sprite.m_Sprite.Vertices.empty())
+    else
     {
-        m_pContext->Draw((UINT)sprite.m_Sprite.Vertices.size(), 0);
+        m_pContext->Draw((UINT)mesh.Vertices.size(), vertexOffset / stride);
+    }
+    m_State.Stats.DrawCalls++;
+}
+
+/**
+ * \brief Sub-allocates an upload ring, and writes data into it.
+ * Waits for the GPU to finish with old frames if the ring is full, and grows the ring if that isn't enough.
+ * \param alignment The allocation's offset is a multiple of this.
+ * \return The allocation's offset, in bytes.
+ */
+UINT DX11_GFX::WriteTransient(DX11UploadBuffer& upload, const void* data, UINT size, UINT alignment)
+{
+    UINT offset = 0;
+    while (upload.Buffer.Get() == nullptr || !upload.Ring.Allocate(size, alignment, offset))
+    {
+        if (upload.Buffer.Get() != nullptr && upload.Ring.HasFramesInFlight())
+        {
+            RetireFrames(true);
+            continue;
+        }
+
+        //Nothing remains in flight, so the ring is too small. Draws already issued keep the old buffer alive.
+        UINT capacity = upload.Ring.GetCapacity() * 2;
+        capacity = capacity > TRANSIENT_BUFFER_SIZE ? capacity : TRANSIENT_BUFFER_SIZE;
+        capacity = capacity > size ? capacity : size;
+
+        D3D11_BUFFER_DESC desc = {};
+        desc.ByteWidth = capacity;
+        desc.Usage = D3D11_USAGE_DYNAMIC;
+        desc.BindFlags = upload.BindFlags;
+        desc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+        HR(m_pDevice->CreateBuffer(&desc, nullptr, upload.Buffer.ReleaseAndGetAddressOf()), "Upload Buffer Creation Failed!");
+
+        upload.Ring.Reset(capacity);
+        upload.Fresh = true;
+    }
+
+    //Space in the ring is never in use by the GPU, so it can be written without waiting
+    D3D11_MAPPED_SUBRESOURCE mapped = {};
+    HR(m_pContext->Map(upload.Buffer.Get(), 0, upload.Fresh ? D3D11_MAP_WRITE_DISCARD : D3D11_MAP_WRITE_NO_OVERWRITE, 0, &mapped), "Unable to map Upload Buffer");
+    memcpy((uint8_t*)mapped.pData + offset, data, size);
+    m_pContext->Unmap(upload.Buffer.Get(), 0);
+
+    upload.Fresh = false;
+    m_State.Stats.BytesUploaded += size;
+    return offset;
+}
+
+/**
+ * \brief Frees the upload ring space of frames the GPU has finished with.
+ * \param wait Whether to wait for the oldest frame in flight to finish.
+ */
+void DX11_GFX::RetireFrames(bool wait)
+{
+    while (!m_FrameFences.empty())
+    {
+        auto& [fence, query] = m_FrameFences.front();
+
+        HRESULT hr = m_pContext->GetData(query.Get(), nullptr, 0, 0);
+        while (hr == S_FALSE && wait)
+        {
+            std::this_thread::yield();
+            hr = m_pContext->GetData(query.Get(), nullptr, 0, 0);
+        }
+
+        if (hr == S_FALSE)
+        {
+            break;
+        }
+
+        m_TransientVertices.Ring.Retire(fence);
+        m_TransientIndices.Ring.Retire(fence);
+        m_FreeFences.push_back(query);
+        m_FrameFences.pop_front();
+        wait = false;
+    }
+}
+
+/**
+ * \brief Draws a batch of sprites, with one draw call per batched range.
+ * \param batch The batch to draw. SpriteBatch::End() must have been called.
+ * \param camera 
+ */
+void DX11_GFX::Draw(const SpriteBatch& batch, Camera& camera)
+{
+    PROFILE_SCOPE("Draw SpriteBatch");
+    const auto& vertices = batch.GetVertices();
+    const auto& indices = batch.GetIndices();
+    if (batch.GetRanges().empty())
+    {
+        return;
+    }
+
+    //Stream the whole batch into the dynamic buffers
+    WriteDynamicBuffer(m_pSpriteVertexBuffer, D3D11_BIND_VERTEX_BUFFER, vertices.data(), (UINT)(vertices.size() * sizeof(SpriteVertex)), m_pDevice, m_pContext);
+    m_State.Stats.BytesUploaded += (UINT)(vertices.size() * sizeof(SpriteVertex));
+    WriteDynamicBuffer(m_pSpriteIndexBuffer, D3D11_BIND_INDEX_BUFFER, indices.data(), (UINT)(indices.size() * sizeof(uint32_t)), m_pDevice, m_pContext);
+    m_State.Stats.BytesUploaded += (UINT)(indices.size() * sizeof(uint32_t));
+
+    BindVertexBuffer(m_State, m_pSpriteVertexBuffer.Get(), sizeof(SpriteVertex), m_pContext);
+    BindIndexBuffer(m_State, m_pSpriteIndexBuffer.Get(), m_pContext);
+
+    //Each range only differs by its atlas and technique
+    Engine::SpriteRenderer material;
+    Engine::MeshRenderer renderer = { Engine::EPrimitiveTopology::TriangleList, Engine::EShaderType::SpriteRenderer, &material, "" };
+    Matrix4x4 world;
+
+    auto& shader = LoadShader(renderer, m_pDevice, m_Shaders);
+    SetPrimitiveTopology(renderer, m_pContext, m_State);
+
+    const SpriteBatchRange* previous = nullptr;
+    for (const auto& range : batch.GetRanges())
+    {
+        //The material is reused for every atlas, so it's compared by the range's atlas rather than by its address
+        const bool materialChanged = previous == nullptr || previous->Texture != range.Texture || previous->Technique != range.Technique;
+        if (materialChanged)
+        {
+            //Its handle must also be resolved again
+            material.TextureAtlas = batch.GetTexture(range.Texture);
+            material.AtlasTexture = {};
+            renderer.technique = batch.GetTechnique(range.Technique);
+        }
+
+        SetShaderState(shader, renderer, world, camera, m_pDevice, m_pContext, m_State, materialChanged);
+        m_pContext->DrawIndexed(range.IndexCount, range.FirstIndex, 0);
+        m_State.Stats.DrawCalls++;
+        previous = &range;
+    }
+
+    //The material's address may be reused by a later draw's
+    m_State.Material = nullptr;
+}
+
+/**
+ * \brief Replays a sorted render queue. State is only rebound where it differs from the previous command.
+ * \param queue The queue to draw. RenderQueue::End() must have been called.
+ * \param camera 
+ */
+void DX11_GFX::Draw(const RenderQueue& queue, Camera& camera)
+{
+    PROFILE_SCOPE("Draw RenderQueue");
+    const auto& commands = queue.GetCommands();
+
+    if (m_Workers != nullptr)
+    {
+        queue.Partition((UINT)m_DeferredContexts.size(), MIN_COMMANDS_PER_THREAD, m_Ranges);
+    }
+
+    if (m_Workers == nullptr || m_Ranges.size() < 2)
+    {
+        RecordCommands(commands, camera, m_Shaders, m_pDevice, m_pContext, m_State);
+        return;
+    }
+
+    PrepareCommands(queue);
+
+    //Each range is recorded into its own deferred context
+    m_Workers->Run((UINT)m_Ranges.size(), [&](uint32_t i)
+    {
+        const CommandRange& range = m_Ranges[i];
+        const auto& context = m_DeferredContexts[i];
+        DX11Recorder& recorder = m_Recorders[i];
+
+        //Deferred contexts start each command list with cleared state
+        ResetContextState(recorder.State);
+        context->OMSetRenderTargets(1, m_pRenderTargetView.GetAddressOf(), m_pDepthStencilView.Get());
+        context->RSSetViewports(1, &m_Viewport);
+
+        RecordCommands(std::span(commands).subspan(range.FirstCommand, range.CommandCount), camera, recorder.Shaders, m_pDevice, context, recorder.State);
+        HR(context->FinishCommandList(FALSE, recorder.CommandList.ReleaseAndGetAddressOf()), "Command List Recording Failed!");
+    });
+
+    //Execute the command lists in queue order
+    for (size_t i = 0; i < m_Ranges.size(); i++)
+    {
+        DX11Recorder& recorder = m_Recorders[i];
+        m_pContext->ExecuteCommandList(recorder.CommandList.Get(), FALSE);
+        recorder.CommandList.Reset();
+
+        m_State.Stats += recorder.State.Stats;
+        recorder.State.Stats = {};
+    }
+
+    //Executing a command list clears the immediate context's state
+    ResetContextState(m_State);
+    m_pContext->OMSetRenderTargets(1, m_pRenderTargetView.GetAddressOf(), m_pDepthStencilView.Get());
+    m_pContext->RSSetViewports(1, &m_Viewport);
+}
+
+/**
+ * \brief Creates the resources a queue uses on the calling thread, so that recording threads only read the resource pool.
+ */
+void DX11_GFX::PrepareCommands(const RenderQueue& queue)
+{
+    DX11ShaderReflection* shader = nullptr;
+    const RenderCommand* previous = nullptr;
+
+    for (const auto& command : queue.GetCommands())
+    {
+        const MeshRenderer& renderer = *command.Renderer;
+        const bool shaderChanged = previous == nullptr || previous->Renderer->shader != renderer.shader;
+        const bool materialChanged = shaderChanged || previous->Technique != command.Technique || previous->Material != command.Material;
+
+        if (shaderChanged)
+        {
+            shader = &LoadShader(renderer, m_pDevice, m_Shaders);
+            for (auto& recorder : m_Recorders)
+            {
+                CloneShader(*shader, renderer.shader, recorder.Shaders);
+            }
+        }
+
+        if (shaderChanged || previous->Mesh != command.Mesh)
+        {
+            LoadBuffers(*command.Mesh, renderer.shader, m_pDevice, m_State);
+        }
+
+        if (materialChanged)
+        {
+            GetInputLayout(*shader, renderer.shader, FindPass(*shader, renderer.technique), m_pDevice, false);
+            LoadMaterialTextures(renderer, m_pDevice, m_pContext);
+        }
+
+        previous = &command;
+    }
+}
+
+/**
+ * \brief Sets how many threads record render queues, creating a deferred context for each.
+ */
+void DX11_GFX::SetSubmissionThreads(uint32_t threadCount)
+{
+    Graphics::SetSubmissionThreads(threadCount);
+
+    m_DeferredContexts.clear();
+    m_Recorders.clear();
+    if (threadCount > 1)
+    {
+        CreateDX11DeferredContexts(m_pDevice, m_DeferredContexts, threadCount);
+        m_Recorders.resize(threadCount);
+    }
+}
+
+/**
+ * \brief Draws many copies of a mesh with a single instanced draw call.
+ * \param mesh 
+ * \param renderer The renderer's shader must provide an instanced variant of its technique, named with an "Instanced" suffix.
+ * \param worlds The world matrix of each instance.
+ * \param camera 
+ */
+void DX11_GFX::DrawInstanced(const MeshFilter& mesh, const MeshRenderer& renderer, std::span<const Matrix4x4> worlds, Camera& camera)
+{
+    PROFILE_SCOPE("Draw Instanced");
+    if (worlds.empty())
+    {
+        return;
+    }
+
+    WriteDynamicBuffer(m_pInstanceBuffer, D3D11_BIND_VERTEX_BUFFER, worlds.data(), (UINT)worlds.size_bytes(), m_pDevice, m_pContext);
+    m_State.Stats.BytesUploaded += (UINT)worlds.size_bytes();
+    DrawInstances(mesh, renderer, 0, (UINT)worlds.size(), camera);
+}
+
+/**
+ * \brief Draws a batch of instances, with one instanced draw call per group.
+ * \param batch The batch to draw. InstanceBatch::End() must have been called.
+ * \param camera 
+ */
+void DX11_GFX::Draw(const InstanceBatch& batch, Camera& camera)
+{
+    PROFILE_SCOPE("Draw InstanceBatch");
+    const auto& instances = batch.GetInstances();
+    if (batch.GetGroups().empty())
+    {
+        return;
+    }
+
+    //Stream every group's instances in at once
+    WriteDynamicBuffer(m_pInstanceBuffer, D3D11_BIND_VERTEX_BUFFER, instances.data(), (UINT)(instances.size() * sizeof(Matrix4x4)), m_pDevice, m_pContext);
+    m_State.Stats.BytesUploaded += (UINT)(instances.size() * sizeof(Matrix4x4));
+
+    for (const auto& group : batch.GetGroups())
+    {
+        DrawInstances(*group.Mesh, *group.Renderer, group.FirstInstance, group.InstanceCount, camera);
+    }
+}
+
+/**
+ * \brief Draws a range of the instances within the instance buffer.
+ */
+void DX11_GFX::DrawInstances(const MeshFilter& mesh, const MeshRenderer& renderer, UINT firstInstance, UINT instanceCount, Camera& camera)
+{
+    auto& shader = LoadShader(renderer, m_pDevice, m_Shaders);
+
+    //Switch to the instanced variant of the renderer's technique
+    MeshRenderer instanced = renderer;
+    instanced.technique = (renderer.technique.empty() ? shader.Passes.front().first : renderer.technique) + "Instanced";
+
+    CreateBuffers(mesh, camera, renderer.shader, m_pDevice, m_pContext, m_State);
+    BindInstanceBuffer(m_State, m_pInstanceBuffer.Get(), m_pContext);
+
+    //Instances carry their own world matrices, so the shared world is the identity
+    Matrix4x4 world;
+    SetShaderState(shader, instanced, world, camera, m_pDevice, m_pContext, m_State, true, true);
+
+    SetPrimitiveTopology(renderer, m_pContext, m_State);
+
+    if (!mesh.Indices.empty()) {
+        m_pContext->DrawIndexedInstanced((UINT)mesh.Indices.size(), instanceCount, 0, 0, firstInstance);
+        m_State.Stats.DrawCalls++;
+    }
+    else if (!mesh.Vertices.empty())
+    {
+        m_pContext->DrawInstanced((UINT)mesh.Vertices.size(), instanceCount, 0, firstInstance);
+        m_State.Stats.DrawCalls++;
+    }
+}
+
+/**
+ * \brief Reloads a shader or texture which has changed on disk. Runs on the hot reload thread.
+ * Shaders are compiled here, as devices are free-threaded. Textures are only read, as creating them may use the immediate context.
+ * \return Swaps the asset into the resource pool, or an empty function if the asset isn't loaded.
+ */
+std::function<void()> DX11_GFX::ReloadAsset(const std::basic_string<wchar_t>& path)
+{
+    EShaderType type;
+    if (ResourcePool::GetShaderType(path, type))
+    {
+        if (ResourcePool::FindShader(type).IsNull())
+        {
+            return {};
+        }
+
+        //Edited sources are compiled directly, so that iterating on a shader doesn't need it to be cooked
+        Microsoft::WRL::ComPtr<ID3D10Blob> pBlob;
+        if (path.ends_with(L".cso"))
+        {
+            HR_WARN(D3DReadFileToBlob(path.c_str(), pBlob.GetAddressOf()), ("Unable to reload shader " + Engine::WStringToString(path)).c_str());
+        }
+        else
+        {
+            UINT shaderFlags = 0x00;
+#if defined(DEBUG) || defined(_DEBUG)
+            shaderFlags |= D3DCOMPILE_DEBUG;
+            shaderFlags |= D3DCOMPILE_SKIP_OPTIMIZATION;
+#endif
+            Microsoft::WRL::ComPtr<ID3D10Blob> pErr;
+            HR_WARN(D3DCompileFromFile(path.c_str(), nullptr, nullptr, nullptr, "fx_5_0", shaderFlags, 0, pBlob.GetAddressOf(), pErr.GetAddressOf()), ("Unable to reload shader " + Engine::WStringToString(path)).c_str());
+            if (pErr != nullptr)
+            {
+                LOG_ERROR("%s\n", (const char*)pErr->GetBufferPointer());
+            }
+        }
+
+        //Keep the previous shader if the new one doesn't compile
+        Microsoft::WRL::ComPtr<ID3DX11Effect> effect;
+        if (pBlob == nullptr || FAILED(D3DX11CreateEffectFromMemory(pBlob->GetBufferPointer(), pBlob->GetBufferSize(), 0, m_pDevice.Get(), effect.GetAddressOf())))
+        {
+            return {};
+        }
+
+        return [this, type, effect]
+        {
+            ResourcePool::ReplaceShader(type, effect);
+
+            //Reflections and clones refer to the previous effect
+            m_Shaders.erase(type);
+            for (auto& recorder : m_Recorders)
+            {
+                recorder.Shaders.erase(type);
+            }
+            InvalidateState();
+        };
+    }
+
+    const ResourceID id = path;
+    if (ResourcePool::FindTexture(id).IsNull())
+    {
+        return {};
+    }
+
+    std::ifstream in(path, std::ios::in | std::ios::binary | std::ios::ate);
+    if (!in.is_open())
+    {
+        return {};
+    }
+
+    std::vector<uint8_t> data((size_t)in.tellg());
+    in.seekg(0);
+    in.read((char*)data.data(), data.size());
+
+    return [this, id, data = std::move(data)]
+    {
+        ResourcePool::ReplaceTexture(id, CreateTexture(id.GetPath(), data, m_pDevice, m_pContext));
+        InvalidateState();
+    };
+}
+
+/**
+ * \brief Forgets the state bound on every context, once an asset has been swapped. Handles are unchanged by the swap, so must be rebound.
+ */
+void DX11_GFX::InvalidateState()
+{
+    ResetContextState(m_State);
+    m_State.Textures.clear();
+
+    for (auto& recorder : m_Recorders)
+    {
+        ResetContextState(recorder.State);
+        recorder.State.Textures.clear();
     }
-    
 }
@@ -0,0 +1,196 @@
+#include "../inc/IO/FileWatcher.h"
+#include "../inc/IO/Logger.h"
+#include "../inc/IO/TypeConversion.h"
+#include <filesystem>
+#include <vector>
+
+#ifndef _WIN32
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+using namespace Engine;
+
+Engine::FileWatcher::FileWatcher(const std::basic_string<wchar_t>& directory, Callback onChanged) : m_Directory(directory), m_OnChanged(std::move(onChanged))
+{
+    //Paths are reported relative to the directory, so strip any trailing separator
+    while (!m_Directory.empty() && (m_Directory.back() == L'\\' || m_Directory.back() == L'/'))
+    {
+        m_Directory.pop_back();
+    }
+
+    m_Thread = std::thread(&FileWatcher::WatchMain, this);
+}
+
+Engine::FileWatcher::~FileWatcher()
+{
+    m_Stopping = true;
+    m_Thread.join();
+}
+
+void Engine::FileWatcher::Record(const std::basic_string<wchar_t>& path)
+{
+    m_Pending[path] = std::chrono::steady_clock::now();
+}
+
+void Engine::FileWatcher::Flush()
+{
+    const auto now = std::chrono::steady_clock::now();
+    for (auto it = m_Pending.begin(); it != m_Pending.end();)
+    {
+        if (now - it->second >= SETTLE_TIME)
+        {
+            m_OnChanged(it->first);
+            it = m_Pending.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+#ifdef _WIN32
+
+void Engine::FileWatcher::WatchMain()
+{
+    HANDLE directory = CreateFileW(m_Directory.c_str(), FILE_LIST_DIRECTORY, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr);
+    if (directory == INVALID_HANDLE_VALUE)
+    {
+        LOG_WARNING("Unable to watch directory %s\n", WStringToString(m_Directory).c_str());
+        return;
+    }
+
+    OVERLAPPED overlapped = {};
+    overlapped.hEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+
+    alignas(DWORD) uint8_t buffer[64 * 1024];
+    bool reading = false;
+
+    while (!m_Stopping)
+    {
+        if (!reading)
+        {
+            ResetEvent(overlapped.hEvent);
+            if (!ReadDirectoryChangesW(directory, buffer, sizeof(buffer), TRUE, FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_FILE_NAME, nullptr, &overlapped, nullptr))
+            {
+                LOG_WARNING("Unable to watch directory %s\n", WStringToString(m_Directory).c_str());
+                break;
+            }
+            reading = true;
+        }
+
+        if (WaitForSingleObject(overlapped.hEvent, POLL_INTERVAL_MS) == WAIT_OBJECT_0)
+        {
+            DWORD bytes = 0;
+            GetOverlappedResult(directory, &overlapped, &bytes, FALSE);
+            reading = false;
+
+            //0 bytes means the buffer overflowed, and the changes were lost
+            for (DWORD offset = 0; bytes != 0;)
+            {
+                const auto* info = (const FILE_NOTIFY_INFORMATION*)(buffer + offset);
+                if (info->Action == FILE_ACTION_MODIFIED || info->Action == FILE_ACTION_ADDED || info->Action == FILE_ACTION_RENAMED_NEW_NAME)
+                {
+                    Record(m_Directory + L"\\" + std::basic_string<wchar_t>(info->FileName, info->FileNameLength / sizeof(WCHAR)));
+                }
+
+                if (info->NextEntryOffset == 0)
+                {
+                    break;
+                }
+                offset += info->NextEntryOffset;
+            }
+        }
+
+        Flush();
+    }
+
+    if (reading)
+    {
+        CancelIoEx(directory, &overlapped);
+        DWORD bytes = 0;
+        GetOverlappedResult(directory, &overlapped, &bytes, TRUE);
+    }
+
+    CloseHandle(overlapped.hEvent);
+    CloseHandle(directory);
+}
+
+#else
+
+void Engine::FileWatcher::WatchMain()
+{
+    const int inotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotify < 0)
+    {
+        LOG_WARNING("Unable to watch directory %s\n", WStringToString(m_Directory).c_str());
+        return;
+    }
+
+    //inotify isn't recursive, so each subdirectory is watched separately
+    std::unordered_map<int, std::basic_string<wchar_t>> watches;
+    auto _watch = [&](const std::filesystem::path& path)
+    {
+        const int watch = inotify_add_watch(inotify, path.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+        if (watch >= 0)
+        {
+            watches[watch] = path.wstring();
+        }
+    };
+
+    std::error_code error;
+    _watch(std::filesystem::path(m_Directory));
+    for (const auto& entry : std::filesystem::recursive_directory_iterator(std::filesystem::path(m_Directory), error))
+    {
+        if (entry.is_directory())
+        {
+            _watch(entry.path());
+        }
+    }
+
+    alignas(inotify_event) char buffer[64 * 1024];
+    pollfd fd = { inotify, POLLIN, 0 };
+
+    while (!m_Stopping)
+    {
+        if (poll(&fd, 1, POLL_INTERVAL_MS) > 0)
+        {
+            ssize_t bytes;
+            while ((bytes = read(inotify, buffer, sizeof(buffer))) > 0)
+            {
+                for (ssize_t offset = 0; offset < bytes;)
+                {
+                    const auto* event = (const inotify_event*)(buffer + offset);
+                    offset += sizeof(inotify_event) + event->len;
+
+                    auto it = watches.find(event->wd);
+                    if (it == watches.end() || event->len == 0)
+                    {
+                        continue;
+                    }
+
+                    const std::filesystem::path path = std::filesystem::path(it->second) / event->name;
+                    if (event->mask & IN_ISDIR)
+                    {
+                        if (event->mask & (IN_CREATE | IN_MOVED_TO))
+                        {
+                            _watch(path);
+                        }
+                    }
+                    else if (event->mask & (IN_CLOSE_WRITE | IN_MOVED_TO))
+                    {
+                        Record(path.wstring());
+                    }
+                }
+            }
+        }
+
+        Flush();
+    }
+
+    close(inotify);
+}
+
+#endif
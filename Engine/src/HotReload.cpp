@@ -0,0 +1,95 @@
+#include "../inc/IO/HotReload.h"
+#include "../inc/IO/FileWatcher.h"
+#include "../inc/IO/Logger.h"
+#include "../inc/IO/TypeConversion.h"
+#include <memory>
+#include <mutex>
+#include <vector>
+
+using namespace Engine;
+
+struct PendingReload
+{
+    uint32_t Reloader;
+    std::function<void()> Swap;
+};
+
+//Held while reloaders run, so that they can't be unregistered mid-reload
+static std::mutex ReloaderMutex;
+static std::vector<std::pair<uint32_t, HotReload::Reloader>> Reloaders;
+static uint32_t NextReloader = 1;
+
+static std::mutex PendingMutex;
+static std::vector<PendingReload> Pending;
+
+//Declared last, so that its thread stops before the state it uses is destroyed
+static std::unique_ptr<FileWatcher> Watcher;
+
+/**
+ * \brief Offers a changed file to each reloader. Runs on the watcher's thread.
+ */
+static void OnChanged(const std::basic_string<wchar_t>& path)
+{
+    std::lock_guard<std::mutex> lock(ReloaderMutex);
+    for (const auto& [id, reloader] : Reloaders)
+    {
+        std::function<void()> swap = reloader(path);
+        if (swap)
+        {
+            LOG_INFO("Reloaded %s\n", WStringToString(path).c_str());
+
+            std::lock_guard<std::mutex> pendingLock(PendingMutex);
+            Pending.push_back({ id, std::move(swap) });
+        }
+    }
+}
+
+void HotReload::Start(const std::basic_string<wchar_t>& directory)
+{
+    Watcher = std::make_unique<FileWatcher>(directory, OnChanged);
+}
+
+void HotReload::Stop()
+{
+    Watcher.reset();
+
+    std::lock_guard<std::mutex> lock(PendingMutex);
+    Pending.clear();
+}
+
+uint32_t HotReload::Register(Reloader reloader)
+{
+    std::lock_guard<std::mutex> lock(ReloaderMutex);
+    Reloaders.emplace_back(NextReloader, std::move(reloader));
+    return NextReloader++;
+}
+
+void HotReload::Unregister(uint32_t id)
+{
+    std::lock_guard<std::mutex> lock(ReloaderMutex);
+    std::erase_if(Reloaders, [&](const auto& reloader) { return reloader.first == id; });
+
+    std::lock_guard<std::mutex> pendingLock(PendingMutex);
+    std::erase_if(Pending, [&](const PendingReload& reload) { return reload.Reloader == id; });
+}
+
+uint32_t HotReload::Apply()
+{
+    std::vector<PendingReload> reloads;
+    {
+        std::lock_guard<std::mutex> lock(PendingMutex);
+        if (Pending.empty())
+        {
+            return 0;
+        }
+        reloads.swap(Pending);
+    }
+
+    //Swaps run in the order files were reloaded, so a file saved twice ends with its latest version
+    for (auto& reload : reloads)
+    {
+        reload.Swap();
+    }
+
+    return (uint32_t)reloads.size();
+}
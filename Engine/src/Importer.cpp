@@ -1,4 +1,6 @@
+#define LOG_CATEGORY Importer
 #include "../inc/IO/Importer.h"
+#include "../inc/Core/Time.h"
 #pragma warning(disable : 4996) //for mbstowcs
 
 #include <assimp/Importer.hpp>
@@ -47,7 +49,7 @@ void WriteData(std::fstream& file, uint64_t count, uint64_t byteWidth, T* data)
 }
 
 template <typename T>
-T ReadData(std::ifstream& file, uint64_t size, uint64_t& offset)
+T ReadData(std::istream& file, uint64_t size, uint64_t& offset)
 {
     file.seekg(offset);
     offset += size;
@@ -63,7 +65,7 @@ T ReadData(std::ifstream& file, uint64_t size, uint64_t& offset)
 }
 
 template <typename T>
-void ReadData(std::ifstream& file, uint64_t size, uint64_t& offset, uintptr_t buffer)
+void ReadData(std::istream& file, uint64_t size, uint64_t& offset, uintptr_t buffer)
 {
     file.seekg(offset);
     offset += size;
@@ -71,6 +73,138 @@ void ReadData(std::ifstream& file, uint64_t size, uint64_t& offset, uintptr_t bu
     file.read((char*)buffer, size);       
 }
 
+/**
+ * \brief Opens a file for reading, from a mounted pack if one contains it, or from disk otherwise.
+ * \param path The path of the file to open
+ * \return The opened stream. Check good() before reading.
+ */
+static std::unique_ptr<std::istream> OpenFile(const std::basic_string<char>& path)
+{
+    auto packed = Engine::Archive::Find(path);
+    if (!packed.empty())
+    {
+        return std::make_unique<Engine::Archive::MemoryStream>(packed);
+    }
+
+    return std::make_unique<std::ifstream>(path, std::ios::in | std::ios::binary);
+}
+
+using Engine::Compression::ECodec;
+using Engine::Compression::EFilter;
+
+constexpr uint64_t MIN_COMPRESSED_SECTION = 64;   //Smaller sections are always stored uncompressed
+
+/**
+ * \brief Accumulates the sizes, and decompression time, of an asset's sections.
+ */
+struct SectionStats
+{
+    uint64_t rawBytes = 0;
+    uint64_t storedBytes = 0;
+    double seconds = 0.0;
+};
+
+/**
+ * \brief Writes an array as an asset section, compressing it if worthwhile.
+ * Layout: Count (8 bytes), Byte Width (2 bytes), Codec (1 byte), Filter (1 byte), Stored Size (8 bytes), Data.
+ */
+template <typename T>
+void WriteSection(std::fstream& file, const std::vector<T>& data, ECodec codec, EFilter filter, SectionStats& stats)
+{
+    const uint64_t rawSize = data.size() * sizeof(T);
+    const uint8_t* src = (const uint8_t*)data.data();
+
+    WriteData<uint64_t>(file, 1, sizeof(uint64_t), data.size());
+    WriteData<uint16_t>(file, 1, sizeof(uint16_t), sizeof(T));
+
+    std::vector<uint8_t> stored;
+    if (codec == ECodec::LZ && rawSize >= MIN_COMPRESSED_SECTION)
+    {
+        std::vector<uint8_t> shuffled;
+        if (filter == EFilter::Shuffle)
+        {
+            //Float streams are shuffled per float, rather than per element
+            shuffled.resize(rawSize);
+            Engine::Compression::Shuffle(src, shuffled.data(), rawSize, sizeof(float));
+        }
+
+        stored.resize(Engine::Compression::CompressBound(rawSize));
+        stored.resize(Engine::Compression::Compress(shuffled.empty() ? src : shuffled.data(), rawSize, stored.data(), stored.size()));
+    }
+
+    //Store the section raw if compression didn't help
+    if (stored.empty() || stored.size() >= rawSize)
+    {
+        WriteData<uint8_t>(file, 1, sizeof(uint8_t), (uint8_t)ECodec::None);
+        WriteData<uint8_t>(file, 1, sizeof(uint8_t), (uint8_t)EFilter::None);
+        WriteData<uint64_t>(file, 1, sizeof(uint64_t), rawSize);
+        WriteData<const uint8_t>(file, rawSize, sizeof(uint8_t), src);
+        stats.storedBytes += rawSize;
+    }
+    else
+    {
+        WriteData<uint8_t>(file, 1, sizeof(uint8_t), (uint8_t)ECodec::LZ);
+        WriteData<uint8_t>(file, 1, sizeof(uint8_t), (uint8_t)filter);
+        WriteData<uint64_t>(file, 1, sizeof(uint64_t), stored.size());
+        WriteData<uint8_t>(file, stored.size(), sizeof(uint8_t), stored.data());
+        stats.storedBytes += stored.size();
+    }
+    stats.rawBytes += rawSize;
+}
+
+/**
+ * \brief Reads an asset section, decompressing it straight into the destination array.
+ */
+template <typename T>
+void ReadSection(std::istream& file, uint64_t& offset, uint16_t version, std::vector<T>& data, std::vector<uint8_t>& scratch, SectionStats& stats)
+{
+    data.resize(ReadData<uint64_t>(file, sizeof(uint64_t), offset));
+    const uint16_t byteWidth = ReadData<uint16_t>(file, sizeof(uint16_t), offset);
+    ERR(byteWidth != sizeof(T), "Asset section width does not match its type.");
+
+    const uint64_t rawSize = data.size() * sizeof(T);
+
+    //Sections were stored raw before Version 4
+    if (version < 4)
+    {
+        ReadData<T>(file, rawSize, offset, (uintptr_t)data.data());
+        return;
+    }
+
+    const ECodec codec = (ECodec)ReadData<uint8_t>(file, sizeof(uint8_t), offset);
+    const EFilter filter = (EFilter)ReadData<uint8_t>(file, sizeof(uint8_t), offset);
+    const uint64_t storedSize = ReadData<uint64_t>(file, sizeof(uint64_t), offset);
+
+    if (codec == ECodec::None)
+    {
+        ERR(storedSize != rawSize, "Uncompressed asset section has an invalid size.");
+        ReadData<T>(file, rawSize, offset, (uintptr_t)data.data());
+        return;
+    }
+
+    //Shuffled sections are decoded into the scratch buffer, then unshuffled into place.
+    const bool shuffled = filter == EFilter::Shuffle;
+    scratch.resize(storedSize + (shuffled ? rawSize : 0));
+    ReadData<uint8_t>(file, storedSize, offset, (uintptr_t)scratch.data());
+
+    Time timer;
+    timer.Reset();
+
+    uint8_t* decoded = shuffled ? scratch.data() + storedSize : (uint8_t*)data.data();
+    const bool valid = Engine::Compression::Decompress(scratch.data(), storedSize, decoded, rawSize);
+    ERR(!valid, "Asset section is corrupt.");
+
+    if (shuffled)
+    {
+        Engine::Compression::Unshuffle(decoded, (uint8_t*)data.data(), rawSize, sizeof(float));
+    }
+
+    timer.Tick();
+    stats.seconds += timer.DeltaTime();
+    stats.rawBytes += rawSize;
+    stats.storedBytes += storedSize;
+}
+
 /**
  * \brief Imports a model from file. (SLOW)
  * \param filePath The path to the Model to import
@@ -78,6 +212,7 @@ void ReadData(std::ifstream& file, uint64_t size, uint64_t& offset, uintptr_t bu
  */
 Engine::Model ImportModel(std::basic_string<char> filePath)
 {
+    PROFILE_SCOPE("Import");
 
     Engine::Model output = {};
     //Initialize an Asset Importer
@@ -314,14 +449,14 @@ void SerializeMaterialData(std::fstream& outfile, const Engine::MeshRenderer& re
             WriteData<float>(outfile, 1, sizeof(float), ((Engine::Blinn*)mat)->SpecularPower);
 
             //Diffuse Map (8 bytes *)
-            WriteData<uint64_t>(outfile, 1, sizeof(uint64_t), ((Engine::Blinn*)mat)->DiffuseMap.length());
-            WriteData<const wchar_t>(outfile, ((Engine::Blinn*)mat)->DiffuseMap.length(), sizeof(wchar_t), ((Engine::Blinn*)mat)->DiffuseMap.data());
+            WriteData<uint64_t>(outfile, 1, sizeof(uint64_t), ((Engine::Blinn*)mat)->DiffuseMap.GetPath().length());
+            WriteData<const wchar_t>(outfile, ((Engine::Blinn*)mat)->DiffuseMap.GetPath().length(), sizeof(wchar_t), ((Engine::Blinn*)mat)->DiffuseMap.GetPath().data());
             //Normal Map (8 bytes *)
-            WriteData<uint64_t>(outfile, 1, sizeof(uint64_t), ((Engine::Blinn*)mat)->NormalMap.length());
-            WriteData<const wchar_t>(outfile, ((Engine::Blinn*)mat)->NormalMap.length(), sizeof(wchar_t), ((Engine::Blinn*)mat)->NormalMap.data());
+            WriteData<uint64_t>(outfile, 1, sizeof(uint64_t), ((Engine::Blinn*)mat)->NormalMap.GetPath().length());
+            WriteData<const wchar_t>(outfile, ((Engine::Blinn*)mat)->NormalMap.GetPath().length(), sizeof(wchar_t), ((Engine::Blinn*)mat)->NormalMap.GetPath().data());
             //Specular Map (8 bytes *)
-            WriteData<uint64_t>(outfile, 1, sizeof(uint64_t), ((Engine::Blinn*)mat)->SpecularMap.length());
-            WriteData<const wchar_t>(outfile, ((Engine::Blinn*)mat)->SpecularMap.length(), sizeof(wchar_t), ((Engine::Blinn*)mat)->SpecularMap.data());
+            WriteData<uint64_t>(outfile, 1, sizeof(uint64_t), ((Engine::Blinn*)mat)->SpecularMap.GetPath().length());
+            WriteData<const wchar_t>(outfile, ((Engine::Blinn*)mat)->SpecularMap.GetPath().length(), sizeof(wchar_t), ((Engine::Blinn*)mat)->SpecularMap.GetPath().data());
             
 
 
@@ -329,8 +464,11 @@ void SerializeMaterialData(std::fstream& outfile, const Engine::MeshRenderer& re
     }
 }
 
-void SerializeModelData(const Engine::Model& model, const std::basic_string<char> fileName, uint16_t version = ASSET_VERSION)
+void SerializeModelData(const Engine::Model& model, const std::basic_string<char> fileName, ECodec codec = ECodec::LZ, uint16_t version = ASSET_VERSION)
 {
+    PROFILE_SCOPE("Serialize Model");
+    SectionStats stats = {};
+
     //Create a file stream
     std::fstream outFile(fileName.c_str(), std::ios::out | std::ios::binary);
 
@@ -349,46 +487,34 @@ void SerializeModelData(const Engine::Model& model, const std::basic_string<char
         WriteData<uint64_t>(outFile, 1, sizeof(uint64_t), &numMeshes);
 
         //Write the mesh data 
-        for (auto mesh : model.meshes)
+        for (const auto& mesh : model.meshes)
         {
             //Mesh name (8 bytes *)
             WriteData<uint64_t>(outFile, 1, sizeof(uint64_t), mesh.Name.length());
             WriteData<const char>(outFile, mesh.Name.length(), sizeof(char), mesh.Name.c_str());
 
-            //Vertices (10 bytes *)
-            WriteData<uint64_t>(outFile, 1, sizeof(uint64_t), mesh.Vertices.size());
-            WriteData<uint16_t>(outFile, 1, sizeof(uint16_t), sizeof(Engine::Vector3f));
-            WriteData<Engine::Vector3f>(outFile, mesh.Vertices.size(), sizeof(Engine::Vector3f), mesh.Vertices.data());
-
-            //Indices (10 bytes *)
-            WriteData<uint64_t>(outFile, 1, sizeof(uint64_t), mesh.Indices.size());
-            WriteData<uint16_t>(outFile, 1, sizeof(uint16_t), sizeof(uint32_t));
-            WriteData<uint32_t>(outFile, mesh.Indices.size(), sizeof(uint32_t), mesh.Indices.data());
-
-            //TexCoords (10 bytes *)
-            WriteData<uint64_t>(outFile, 1, sizeof(uint64_t), mesh.TexCoords.size());
-            WriteData<uint16_t>(outFile, 1, sizeof(uint16_t), sizeof(Engine::Vector2f));
-            WriteData<Engine::Vector2f>(outFile, mesh.TexCoords.size(), sizeof(Engine::Vector2f), mesh.TexCoords.data());
-
-            //Normals (10 bytes *)
-            WriteData<uint64_t>(outFile, 1, sizeof(uint64_t), mesh.Normals.size());
-            WriteData<uint16_t>(outFile, 1, sizeof(uint16_t), sizeof(Engine::Vector3f));
-            WriteData<Engine::Vector3f>(outFile, mesh.Normals.size(), sizeof(Engine::Vector3f), mesh.Normals.data());
-
-            //Tangents (10 bytes *)
-            WriteData<uint64_t>(outFile, 1, sizeof(uint64_t), mesh.Tangents.size());
-            WriteData<uint16_t>(outFile, 1, sizeof(uint16_t), sizeof(Engine::Vector3f));
-            WriteData<Engine::Vector3f>(outFile, mesh.Tangents.size(), sizeof(Engine::Vector3f), mesh.Tangents.data());
-
-            //Binormals (10 bytes *)
-            WriteData<uint64_t>(outFile, 1, sizeof(uint64_t), mesh.Binormals.size());
-            WriteData<uint16_t>(outFile, 1, sizeof(uint16_t), sizeof(Engine::Vector3f));
-            WriteData<Engine::Vector3f>(outFile, mesh.Binormals.size(), sizeof(Engine::Vector3f), mesh.Binormals.data());
-
-            //Vertex Colours (10 bytes *)
-            WriteData<uint64_t>(outFile, 1, sizeof(uint64_t), mesh.VertexColours.size());
-            WriteData<uint16_t>(outFile, 1, sizeof(uint16_t), sizeof(Engine::Vector4f));
-            WriteData<Engine::Vector4f>(outFile, mesh.VertexColours.size(), sizeof(Engine::Vector4f), mesh.VertexColours.data());
+            //Vertex attribute streams are byte-shuffled before compression
+            WriteSection(outFile, mesh.Vertices, codec, EFilter::Shuffle, stats);
+            WriteSection(outFile, mesh.Indices, codec, EFilter::None, stats);
+            WriteSection(outFile, mesh.TexCoords, codec, EFilter::Shuffle, stats);
+            WriteSection(outFile, mesh.Normals, codec, EFilter::Shuffle, stats);
+            WriteSection(outFile, mesh.Tangents, codec, EFilter::Shuffle, stats);
+            WriteSection(outFile, mesh.Binormals, codec, EFilter::Shuffle, stats);
+            WriteSection(outFile, mesh.VertexColours, codec, EFilter::Shuffle, stats);
+
+            //LODs (8 bytes *)
+            WriteData<uint64_t>(outFile, 1, sizeof(uint64_t), mesh.LODs.size());
+            for (const auto& lod : mesh.LODs)
+            {
+                //Error (4 bytes)
+                WriteData<float>(outFile, 1, sizeof(float), lod.Error);
+                WriteSection(outFile, lod.Indices, codec, EFilter::None, stats);
+            }
+
+            //Meshlets
+            WriteSection(outFile, mesh.Meshlets, codec, EFilter::None, stats);
+            WriteSection(outFile, mesh.MeshletVertices, codec, EFilter::None, stats);
+            WriteSection(outFile, mesh.MeshletTriangles, codec, EFilter::None, stats);
         }
 
         //Write the renderer data
@@ -405,12 +531,16 @@ void SerializeModelData(const Engine::Model& model, const std::basic_string<char
             SerializeMaterialData(outFile, renderer);
         }
 
+        if (stats.rawBytes > 0)
+        {
+            LOG_TRACE("Serialized %llu bytes of mesh data as %llu bytes (ratio %f)\n", stats.rawBytes, stats.storedBytes, (double)stats.rawBytes / (double)stats.storedBytes);
+        }
     }
 }
 
 bool VersionCheck(const uint16_t version)
 {
-    if(version < ASSET_VERSION)
+    if(version < ASSET_MIN_VERSION || version > ASSET_VERSION)
     {
         return false;
     }
@@ -419,11 +549,13 @@ bool VersionCheck(const uint16_t version)
 
 Engine::Model LoadModelAsset(std::basic_string<char> filePath)
 {
+    PROFILE_SCOPE("Load Model Asset");
     Engine::Model m = {};
     
 
-    std::ifstream inFile(filePath, std::ios::in | std::ios::binary);
-    if (inFile.is_open()) {
+    auto file = OpenFile(filePath);
+    std::istream& inFile = *file;
+    if (inFile.good()) {
         uint64_t offset = 0; //= ReadData<uint64_t>(inFile, sizeof(uint64_t), offset);
 
         //Perform a Version Check
@@ -443,7 +575,8 @@ Engine::Model LoadModelAsset(std::basic_string<char> filePath)
         uint64_t numMeshes = ReadData<uint64_t>(inFile, sizeof(uint64_t), offset);
         m.meshes.resize(numMeshes);
 
-        uint16_t byteWidth = 0;
+        SectionStats stats = {};
+        std::vector<uint8_t> scratch;
 
         for (auto mesh = 0; mesh < numMeshes; mesh++)
         {
@@ -451,40 +584,38 @@ Engine::Model LoadModelAsset(std::basic_string<char> filePath)
             m.meshes[mesh].Name.resize(ReadData<uint64_t>(inFile, sizeof(uint64_t), offset));
             ReadData<char>(inFile, m.meshes[mesh].Name.length() * sizeof(char), offset, (uintptr_t)m.meshes[mesh].Name.data());
 
-            //Load Vertices
-            m.meshes[mesh].Vertices.resize(ReadData<uint64_t>(inFile, sizeof(uint64_t), offset));
-            ReadData<uint16_t>(inFile, sizeof(uint16_t), offset, (uintptr_t)&byteWidth);
-            ReadData<Engine::Vector3f>(inFile,  m.meshes[mesh].Vertices.size() * byteWidth, offset, (uintptr_t)m.meshes[mesh].Vertices.data());            
-
-            //Load Indices
-            m.meshes[mesh].Indices.resize(ReadData<uint64_t>(inFile, sizeof(uint64_t), offset));
-            ReadData<uint16_t>(inFile, sizeof(uint16_t), offset, (uintptr_t)&byteWidth);
-            ReadData<uint32_t>(inFile, m.meshes[mesh].Indices.size() * byteWidth, offset, (uintptr_t)m.meshes[mesh].Indices.data());
-
-            //Load Texcoords
-            m.meshes[mesh].TexCoords.resize(ReadData<uint64_t>(inFile, sizeof(uint64_t), offset));
-            ReadData<uint16_t>(inFile, sizeof(uint16_t), offset, (uintptr_t)&byteWidth);
-            ReadData<Engine::Vector2f>(inFile, m.meshes[mesh].TexCoords.size() * byteWidth, offset, (uintptr_t)m.meshes[mesh].TexCoords.data());
-
-            //Load Normals
-            m.meshes[mesh].Normals.resize(ReadData<uint64_t>(inFile, sizeof(uint64_t), offset));
-            ReadData<uint16_t>(inFile, sizeof(uint16_t), offset, (uintptr_t)&byteWidth);
-            ReadData<Engine::Vector3f>(inFile, m.meshes[mesh].Normals.size() * byteWidth, offset, (uintptr_t)m.meshes[mesh].Normals.data());
-
-            //Load Tangents
-            m.meshes[mesh].Tangents.resize(ReadData<uint64_t>(inFile, sizeof(uint64_t), offset));
-            ReadData<uint16_t>(inFile, sizeof(uint16_t), offset, (uintptr_t)&byteWidth);
-            ReadData<Engine::Vector3f>(inFile, m.meshes[mesh].Tangents.size() * byteWidth, offset, (uintptr_t)m.meshes[mesh].Tangents.data());
-
-            //Load Binormals
-            m.meshes[mesh].Binormals.resize(ReadData<uint64_t>(inFile, sizeof(uint64_t), offset));
-            ReadData<uint16_t>(inFile, sizeof(uint16_t), offset, (uintptr_t)&byteWidth);
-            ReadData<Engine::Vector3f>(inFile, m.meshes[mesh].Binormals.size() * byteWidth, offset, (uintptr_t)m.meshes[mesh].Binormals.data());
-
-            //Load VertexColours
-            m.meshes[mesh].VertexColours.resize(ReadData<uint64_t>(inFile, sizeof(uint64_t), offset));
-            ReadData<uint16_t>(inFile, sizeof(uint16_t), offset, (uintptr_t)&byteWidth);
-            ReadData<Engine::Vector4f>(inFile, m.meshes[mesh].VertexColours.size() * byteWidth, offset, (uintptr_t)m.meshes[mesh].VertexColours.data());
+            //Load Vertex Data
+            ReadSection(inFile, offset, version, m.meshes[mesh].Vertices, scratch, stats);
+            ReadSection(inFile, offset, version, m.meshes[mesh].Indices, scratch, stats);
+            ReadSection(inFile, offset, version, m.meshes[mesh].TexCoords, scratch, stats);
+            ReadSection(inFile, offset, version, m.meshes[mesh].Normals, scratch, stats);
+            ReadSection(inFile, offset, version, m.meshes[mesh].Tangents, scratch, stats);
+            ReadSection(inFile, offset, version, m.meshes[mesh].Binormals, scratch, stats);
+            ReadSection(inFile, offset, version, m.meshes[mesh].VertexColours, scratch, stats);
+
+            //Load LODs (Version 2+)
+            if (version >= 2)
+            {
+                m.meshes[mesh].LODs.resize(ReadData<uint64_t>(inFile, sizeof(uint64_t), offset));
+                for (auto& lod : m.meshes[mesh].LODs)
+                {
+                    lod.Error = ReadData<float>(inFile, sizeof(float), offset);
+                    ReadSection(inFile, offset, version, lod.Indices, scratch, stats);
+                }
+            }
+
+            //Load Meshlets (Version 3+)
+            if (version >= 3)
+            {
+                ReadSection(inFile, offset, version, m.meshes[mesh].Meshlets, scratch, stats);
+                ReadSection(inFile, offset, version, m.meshes[mesh].MeshletVertices, scratch, stats);
+                ReadSection(inFile, offset, version, m.meshes[mesh].MeshletTriangles, scratch, stats);
+            }
+        }
+
+        if (stats.seconds > 0.0)
+        {
+            LOG_TRACE("Decompressed %llu -> %llu bytes in %fs (%f GB/s)\n", stats.storedBytes, stats.rawBytes, stats.seconds, (double)stats.rawBytes / stats.seconds / 1e9);
         }
 
         //Load Material Data
@@ -547,7 +678,7 @@ Engine::Model LoadModelAsset(std::basic_string<char> filePath)
 
 void Engine::Importer::LoadFromFile(Model& model, const std::basic_string<char>& filePath)
 {
-    Engine::Log("Loading model %s...\n", filePath.c_str());
+    LOG_INFO("Loading model %s...\n", filePath.c_str());
     Time timer;
     timer.Reset();
     timer.Tick();
@@ -563,7 +694,7 @@ void Engine::Importer::LoadFromFile(Model& model, const std::basic_string<char>&
         model = ImportModel(filePath);
     }
     timer.Tick();
-    Engine::Log("Finished loading model %s in %fs\n", filePath.c_str(), timer.DeltaTime());
+    LOG_INFO("Finished loading model %s in %fs\n", filePath.c_str(), timer.DeltaTime());
 }
 
 
@@ -583,8 +714,9 @@ void Engine::Importer::LoadFromFile(Font& font, const std::basic_string<char> fi
 
     Font out = {};
 
-    std::ifstream inFile(filePath, std::ios::in | std::ios::binary);
-    if (inFile.is_open()) {
+    auto file = OpenFile(filePath);
+    std::istream& inFile = *file;
+    if (inFile.good()) {
         uint64_t offset = 0;
 
         //Bytes 1-4 can be skipped
@@ -629,33 +761,53 @@ void Engine::Importer::LoadFromFile(Font& font, const std::basic_string<char> fi
             g.y = ReadData<uint16_t>(inFile, sizeof(uint16_t), offset) / (float)texHeight;
             g.width = (float)ReadData<uint16_t>(inFile, sizeof(uint16_t), offset) ;
             g.height = (float)ReadData<uint16_t>(inFile, sizeof(uint16_t), offset) ;
-            g.offsetX = ReadData<uint16_t>(inFile, sizeof(uint16_t), offset);
-            g.offsetY = ReadData<uint16_t>(inFile, sizeof(uint16_t), offset);
-            g.advanceX = ReadData<uint16_t>(inFile, sizeof(uint16_t), offset);
+            g.offsetX = ReadData<int16_t>(inFile, sizeof(int16_t), offset);
+            g.offsetY = ReadData<int16_t>(inFile, sizeof(int16_t), offset);
+            g.advanceX = ReadData<int16_t>(inFile, sizeof(int16_t), offset);
 
             offset += 2;
 
-            out.m_Glyphs.emplace(id, g);
+            out.AddGlyph(id, g);
         }
 
-        //The fifth block contains kerning pairs
-        //TODO: kerning pairs
+        //The fifth block contains kerning pairs, and is only present if the font is kerned
+        inFile.seekg(0, std::ios::end);
+        const uint64_t fileSize = (uint64_t)inFile.tellg();
 
+        if (offset + 5 <= fileSize)
+        {
+            block = ReadData<uint8_t>(inFile, sizeof(uint8_t), offset);
+            size = ReadData<uint32_t>(inFile, sizeof(uint32_t), offset);
+
+            if (block == 5 && offset + size <= fileSize)
+            {
+                for (uint32_t i = 0; i < size; i += 10)
+                {
+                    auto first = ReadData<uint32_t>(inFile, sizeof(uint32_t), offset);
+                    auto second = ReadData<uint32_t>(inFile, sizeof(uint32_t), offset);
+                    auto amount = ReadData<int16_t>(inFile, sizeof(int16_t), offset);
+
+                    out.AddKerning(first, second, amount);
+                }
+            }
+        }
     }
 
     font = out;
 }
 
-void Engine::Importer::ImportModelFromMemory(Model& model, std::basic_string<char> destPath)
+void Engine::Importer::ImportModelFromMemory(Model& model, std::basic_string<char> destPath, Compression::ECodec codec)
 {
+    PROFILE_SCOPE("Import Model From Memory");
     if (!destPath.ends_with(".Asset")) {
         destPath.append(".Asset");
     }
-    SerializeModelData(model, destPath);
+    SerializeModelData(model, destPath, codec);
 }
 
-Engine::Model Engine::Importer::ImportModelFromFile(const std::basic_string<char>& filePath, std::basic_string<char> destPath)
+Engine::Model Engine::Importer::ImportModelFromFile(const std::basic_string<char>& filePath, std::basic_string<char> destPath, Compression::ECodec codec)
 {
+    PROFILE_SCOPE("Import Model From File");
     Engine::Model m = {};
 
     m.source = filePath;
@@ -682,7 +834,7 @@ Engine::Model Engine::Importer::ImportModelFromFile(const std::basic_string<char
         }
         auto i = std::rename(fileName.c_str(), newName.c_str());// != 0, ("File <%s> Renaming Failed", newName.c_str());
     }
-    Log("Importing <%s> -> <%s>\n", filePath.c_str(), fileName.c_str());
+    LOG_INFO("Importing <%s> -> <%s>\n", filePath.c_str(), fileName.c_str());
 
 
     //Load the model
@@ -691,12 +843,30 @@ Engine::Model Engine::Importer::ImportModelFromFile(const std::basic_string<char
     Time timer;
     timer.Reset();
 
-    Engine::Log("Serializing Asset %s...\n", filePath.c_str());
+    //Generate a chain of simplified LODs, and the meshlets used for cluster culling, for each mesh
+    LOG_INFO("Generating LODs for %s...\n", filePath.c_str());
+    for (auto& mesh : m.meshes)
+    {
+        MeshOptimizer::GenerateLODs(mesh);
+        MeshOptimizer::BuildMeshlets(mesh);
+        LOG_TRACE("\t<%s> %u meshlets\n", mesh.Name.c_str(), (uint32_t)mesh.Meshlets.size());
+
+        for (const auto& lod : mesh.LODs)
+        {
+            LOG_TRACE("\t<%s> LOD: %u -> %u triangles (error %f)\n", mesh.Name.c_str(), (uint32_t)(mesh.Indices.size() / 3), (uint32_t)(lod.Indices.size() / 3), lod.Error);
+        }
+    }
+    timer.Tick();
+    LOG_INFO("LOD generation <%s> finished in %fs\n", filePath.c_str(), timer.DeltaTime());
+
+    timer.Reset();
+
+    LOG_INFO("Serializing Asset %s...\n", filePath.c_str());
 
-    SerializeModelData(m, fileName);
+    SerializeModelData(m, fileName, codec);
 
     timer.Tick();
-    Engine::Log("Asset Serialization <%s> finished in %fs\n", fileName.c_str(), timer.DeltaTime());
+    LOG_INFO("Asset Serialization <%s> finished in %fs\n", fileName.c_str(), timer.DeltaTime());
     
     return m;
 }
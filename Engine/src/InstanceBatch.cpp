@@ -0,0 +1,58 @@
+#include "../inc/Graphics/InstanceBatch.h"
+
+using namespace Engine;
+
+void Engine::InstanceBatch::Begin()
+{
+    m_Queued.clear();
+    m_QueuedGroups.clear();
+    m_Groups.clear();
+    m_GroupIDs.clear();
+    m_LastGroup = UINT32_MAX;
+}
+
+void Engine::InstanceBatch::Add(const MeshFilter& mesh, const MeshRenderer& renderer, const Matrix4x4& world)
+{
+    //Consecutive instances usually share a group
+    uint32_t group = m_LastGroup;
+    if (group == UINT32_MAX || m_Groups[group].Mesh != &mesh || m_Groups[group].Renderer != &renderer)
+    {
+        auto it = m_GroupIDs.find({ &mesh, &renderer });
+        if (it == m_GroupIDs.end())
+        {
+            it = m_GroupIDs.emplace(GroupKey{ &mesh, &renderer }, (uint32_t)m_Groups.size()).first;
+            m_Groups.push_back({ &mesh, &renderer, 0, 0 });
+        }
+
+        group = it->second;
+        m_LastGroup = group;
+    }
+
+    m_Groups[group].InstanceCount++;
+    m_Queued.push_back(world);
+    m_QueuedGroups.push_back(group);
+}
+
+void Engine::InstanceBatch::End()
+{
+    //Lay the groups out contiguously, in the order they were first added
+    uint32_t first = 0;
+    for (auto& group : m_Groups)
+    {
+        group.FirstInstance = first;
+        first += group.InstanceCount;
+    }
+
+    //Scatter each instance into its group. Each group is filled in the order its instances were added.
+    m_Instances.resize(m_Queued.size());
+    m_NextInstance.resize(m_Groups.size());
+    for (size_t i = 0; i < m_Groups.size(); i++)
+    {
+        m_NextInstance[i] = m_Groups[i].FirstInstance;
+    }
+
+    for (size_t i = 0; i < m_Queued.size(); i++)
+    {
+        m_Instances[m_NextInstance[m_QueuedGroups[i]]++] = m_Queued[i];
+    }
+}
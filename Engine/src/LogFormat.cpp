@@ -0,0 +1,298 @@
+#include "../inc/IO/LogFormat.h"
+#include <algorithm>
+#include <cstdio>
+#include <unordered_map>
+#include <vector>
+
+using namespace Engine;
+
+uint32_t LogFormat::EncodeString(uint8_t* out, uint32_t capacity, const char* value)
+{
+    if (capacity < 1 + sizeof(uint16_t))
+    {
+        return 0;
+    }
+
+    //Strings which don't fit are truncated
+    const size_t length = value != nullptr ? strlen(value) : 0;
+    const uint16_t stored = (uint16_t)std::min<size_t>({ length, capacity - 1 - sizeof(uint16_t), UINT16_MAX });
+
+    out[0] = (uint8_t)EArgType::String;
+    memcpy(out + 1, &stored, sizeof(uint16_t));
+    memcpy(out + 1 + sizeof(uint16_t), value, stored);
+    return 1 + sizeof(uint16_t) + stored;
+}
+
+/**
+ * \brief Reads a value from encoded arguments.
+ */
+template<typename T>
+static bool ReadValue(const uint8_t* args, size_t size, size_t& offset, T& value)
+{
+    if (offset + sizeof(T) > size)
+    {
+        return false;
+    }
+
+    memcpy(&value, args + offset, sizeof(T));
+    offset += sizeof(T);
+    return true;
+}
+
+std::basic_string<char> LogFormat::Format(std::string_view format, const uint8_t* args, size_t size)
+{
+    std::basic_string<char> out;
+    size_t offset = 0;
+
+    size_t i = 0;
+    while (i < format.size())
+    {
+        const size_t percent = format.find('%', i);
+        out.append(format.substr(i, percent - i));
+        if (percent == std::string_view::npos)
+        {
+            break;
+        }
+
+        if (percent + 1 < format.size() && format[percent + 1] == '%')
+        {
+            out.push_back('%');
+            i = percent + 2;
+            continue;
+        }
+
+        //Find the conversion, and rebuild the specification without its length modifiers
+        size_t end = percent + 1;
+        std::basic_string<char> spec = "%";
+        bool supported = true;
+        while (end < format.size() && strchr("diouxXeEfFgGaAcsp", format[end]) == nullptr)
+        {
+            const char c = format[end++];
+            if (strchr("hljztL", c) == nullptr)
+            {
+                spec.push_back(c);
+            }
+            if (c == '*' || c == 'n')
+            {
+                supported = false;
+            }
+        }
+
+        if (end == format.size() || !supported)
+        {
+            out.append(format.substr(percent, end - percent + 1));
+            i = end + 1;
+            continue;
+        }
+
+        const char conversion = format[end];
+        i = end + 1;
+
+        if (offset >= size)
+        {
+            out.append("<missing>");
+            continue;
+        }
+
+        char buffer[512];
+        int written = -1;
+        const EArgType type = (EArgType)args[offset++];
+        const bool isInteger = strchr("diouxXc", conversion) != nullptr;
+        const bool isFloat = strchr("eEfFgGaA", conversion) != nullptr;
+
+        switch (type)
+        {
+        case EArgType::Int32:
+        case EArgType::UInt32:
+        {
+            uint32_t value;
+            if (isInteger && ReadValue(args, size, offset, value))
+            {
+                spec.push_back(conversion);
+                written = type == EArgType::Int32 ? snprintf(buffer, sizeof(buffer), spec.c_str(), (int)value) : snprintf(buffer, sizeof(buffer), spec.c_str(), (unsigned int)value);
+            }
+            break;
+        }
+        case EArgType::Int64:
+        case EArgType::UInt64:
+        {
+            uint64_t value;
+            if (isInteger && conversion != 'c' && ReadValue(args, size, offset, value))
+            {
+                spec.append("ll");
+                spec.push_back(conversion);
+                written = type == EArgType::Int64 ? snprintf(buffer, sizeof(buffer), spec.c_str(), (long long)value) : snprintf(buffer, sizeof(buffer), spec.c_str(), (unsigned long long)value);
+            }
+            break;
+        }
+        case EArgType::Double:
+        {
+            double value;
+            if (isFloat && ReadValue(args, size, offset, value))
+            {
+                spec.push_back(conversion);
+                written = snprintf(buffer, sizeof(buffer), spec.c_str(), value);
+            }
+            break;
+        }
+        case EArgType::Pointer:
+        {
+            uint64_t value;
+            if (conversion == 'p' && ReadValue(args, size, offset, value))
+            {
+                spec.push_back(conversion);
+                written = snprintf(buffer, sizeof(buffer), spec.c_str(), (void*)(uintptr_t)value);
+            }
+            break;
+        }
+        case EArgType::String:
+        {
+            uint16_t length;
+            if (conversion == 's' && ReadValue(args, size, offset, length) && offset + length <= size)
+            {
+                const std::basic_string<char> value((const char*)args + offset, length);
+                offset += length;
+                spec.push_back(conversion);
+                written = snprintf(buffer, sizeof(buffer), spec.c_str(), value.c_str());
+            }
+            break;
+        }
+        default:
+            break;
+        }
+
+        if (written < 0)
+        {
+            //The argument doesn't match its conversion, so the remaining arguments can't be trusted
+            out.append("<bad argument>");
+            offset = size;
+            continue;
+        }
+
+        out.append(buffer, std::min<size_t>(written, sizeof(buffer) - 1));
+    }
+
+    return out;
+}
+
+std::basic_string<char> LogFormat::FormatTime(std::time_t time)
+{
+    const auto t = std::localtime(&time);
+    if (t == nullptr)
+    {
+        return {};
+    }
+
+    char buffer[64];
+    snprintf(buffer, sizeof(buffer), "\n[%04d/%02d/%02d - %02d:%02d:%02d]\n", t->tm_year + 1900, t->tm_mon + 1, t->tm_mday, t->tm_hour, t->tm_min, t->tm_sec);
+    return buffer;
+}
+
+template<typename T>
+static bool Read(std::istream& in, T& value)
+{
+    return (bool)in.read((char*)&value, sizeof(T));
+}
+
+bool LogFormat::Decode(std::istream& in, std::ostream& out)
+{
+    //Logs opened several times hold several headers, one per session
+    std::unordered_map<uint32_t, std::basic_string<char>> formats;
+    std::vector<uint8_t> data;
+
+    char magic[sizeof(BINARY_MAGIC)];
+    uint32_t version;
+    if (!in.read(magic, sizeof(magic)) || memcmp(magic, BINARY_MAGIC, sizeof(magic)) != 0 || !Read(in, version) || version != BINARY_VERSION)
+    {
+        return false;
+    }
+
+    uint8_t tag;
+    while (Read(in, tag))
+    {
+        switch ((EBinaryRecord)tag)
+        {
+        case EBinaryRecord::Format:
+        {
+            uint32_t id;
+            uint16_t length;
+            if (!Read(in, id) || !Read(in, length))
+            {
+                return false;
+            }
+            std::basic_string<char> format(length, '\0');
+            if (!in.read(format.data(), length))
+            {
+                return false;
+            }
+            formats[id] = std::move(format);
+            break;
+        }
+        case EBinaryRecord::Message:
+        {
+            uint32_t id;
+            uint16_t size;
+            if (!Read(in, id) || !Read(in, size))
+            {
+                return false;
+            }
+            data.resize(size);
+            if (!in.read((char*)data.data(), size))
+            {
+                return false;
+            }
+
+            auto it = formats.find(id);
+            if (it == formats.end())
+            {
+                return false;
+            }
+            out << Format(it->second, data.data(), data.size());
+            break;
+        }
+        case EBinaryRecord::Text:
+        {
+            uint16_t length;
+            if (!Read(in, length))
+            {
+                return false;
+            }
+            data.resize(length);
+            if (!in.read((char*)data.data(), length))
+            {
+                return false;
+            }
+            out.write((const char*)data.data(), length);
+            break;
+        }
+        case EBinaryRecord::Time:
+        {
+            int64_t time;
+            if (!Read(in, time))
+            {
+                return false;
+            }
+            //Times which can't be represented, e.g. from a corrupt record, can't be formatted
+            const std::basic_string<char> text = FormatTime((std::time_t)time);
+            if (text.empty())
+            {
+                return false;
+            }
+            out << text;
+            break;
+        }
+        default:
+        {
+            //The header of a later session
+            if (tag != (uint8_t)BINARY_MAGIC[0] || !in.read(magic + 1, sizeof(magic) - 1) || memcmp(magic + 1, BINARY_MAGIC + 1, sizeof(magic) - 1) != 0 || !Read(in, version) || version != BINARY_VERSION)
+            {
+                return false;
+            }
+            formats.clear();
+            break;
+        }
+        }
+    }
+
+    return true;
+}
@@ -1,43 +1,539 @@
 #include "../inc/IO/Logger.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
 
-void Engine::Log(const char* fmt, ...)
+using namespace Engine;
+
+//Messages are formatted on the calling thread, then queued for a background thread to write.
+//Deferred messages queue their encoded arguments instead, and are formatted by the writer, or not at all in binary logs.
+//The queue is a bounded ring which any thread may push to without locking, and only the writer pops from.
+
+#ifdef _WIN32
+static constexpr bool DEBUG_OUTPUT = true;      //Every message is also sent to the VS output window
+#else
+static constexpr bool DEBUG_OUTPUT = false;
+#endif
+
+/**
+ * \brief Deferred formats, indexed by ID. Formats are never removed.
+ */
+struct LogFormats
 {
-    if (ENABLE_LOGGING) {
-        static char buffer[1 << 11] = { 0 };
+    std::mutex Mutex;
+    std::vector<const char*> Formats;
+};
 
-        //Format string
-        va_list params;
-        va_start(params, fmt);
-        vsprintf_s(buffer, fmt, params);
-        va_end(params);
+static LogFormats& GetFormats()
+{
+    static LogFormats formats;
+    return formats;
+}
+
+/**
+ * \brief A queued piece of a message. Long messages are split across several records, which are queued together.
+ */
+struct LogRecord
+{
+    static constexpr uint32_t TEXT_SIZE = 500;
+
+    enum class EType : uint32_t
+    {
+        Text = 0,
+        Time,       //Written as a timestamp, taken when the record was queued
+        Deferred,   //Text holds encoded arguments for the format
+    };
+
+    std::chrono::system_clock::time_point Timestamp;   //Only set for timestamps
+    EType Type;
+    uint32_t Length;
+    uint32_t Format;    //Only set for deferred messages
+    bool Continued;     //Set if the message continues in the next record
+    char Text[TEXT_SIZE];
+};
+
+class LogWriter
+{
+public:
+    LogWriter() : m_Cells(new Cell[CAPACITY])
+    {
+        for (uint64_t i = 0; i < CAPACITY; i++)
+        {
+            m_Cells[i].Sequence.store(i, std::memory_order_relaxed);
+        }
+
+        m_Thread = std::thread(&LogWriter::WriterMain, this);
+    }
+
+    ~LogWriter()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Stopping = true;
+        }
+        m_Wake.notify_one();
+        m_Thread.join();
+    }
+
+    /**
+     * \brief Queues a message's records. Its cells are claimed at once, so that its records are written together,
+     * rather than interleaved with other threads' messages, and are either all queued, or all dropped.
+     * \param count The number of records, at most CAPACITY.
+     * \param fill Fills each record in place, once the cells have been claimed. Called with the record, and its index in the message.
+     * \return False if the queue was full, and the message was dropped.
+     */
+    template<typename Fill>
+    bool Push(uint32_t count, Fill&& fill)
+    {
+        assert(count > 0 && count <= CAPACITY);
+
+        uint64_t position = m_Head.load(std::memory_order_relaxed);
+
+        while (true)
+        {
+            const uint64_t sequence = m_Cells[position & (CAPACITY - 1)].Sequence.load(std::memory_order_acquire);
+            const int64_t difference = (int64_t)sequence - (int64_t)position;
+
+            //The writer frees cells in order, so the message fits if its last cell is free
+            const uint64_t last = position + count - 1;
+            const int64_t lastDifference = (int64_t)m_Cells[last & (CAPACITY - 1)].Sequence.load(std::memory_order_acquire) - (int64_t)last;
+
+            if (difference == 0 && lastDifference == 0)
+            {
+                //The cells are free. Claim them, unless another thread got there first.
+                if (m_Head.compare_exchange_weak(position, position + count, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if (difference < 0 || (difference == 0 && lastDifference < 0))
+            {
+                //The cells still hold records from the previous lap, so the queue is full
+                if (m_Overflow.load(std::memory_order_relaxed) == ELogOverflow::Drop)
+                {
+                    m_Dropped.fetch_add(1, std::memory_order_relaxed);
+                    return false;
+                }
+
+                m_Wake.notify_one();
+                std::this_thread::yield();
+                position = m_Head.load(std::memory_order_relaxed);
+            }
+            else
+            {
+                position = m_Head.load(std::memory_order_relaxed);
+            }
+        }
+
+        for (uint32_t i = 0; i < count; i++)
+        {
+            Cell& cell = m_Cells[(position + i) & (CAPACITY - 1)];
+            fill(cell.Record, i);
+            cell.Record.Continued = i + 1 < count;
+            cell.Sequence.store(position + i + 1, std::memory_order_release);
+        }
+        return true;
+    }
+
+    /**
+     * \brief Blocks until every record queued before the call has been written.
+     */
+    void Flush()
+    {
+        const uint64_t target = m_Head.load(std::memory_order_acquire);
+
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        m_FlushTarget = std::max(m_FlushTarget, target);
+        m_Wake.notify_one();
+        m_Flushed.wait(lock, [&] { return m_Written >= target || m_Stopping; });
+    }
+
+    void SetOverflow(ELogOverflow policy)
+    {
+        m_Overflow.store(policy, std::memory_order_relaxed);
+    }
+
+    void SetFormat(ELogFormat format)
+    {
+        m_Format.store(format, std::memory_order_relaxed);
+    }
+
+private:
+    static constexpr uint64_t CAPACITY = 1 << 12;   //Records. Must be a power of two.
+    static constexpr std::chrono::milliseconds IDLE_INTERVAL{ 2 };
+
+    struct Cell
+    {
+        std::atomic<uint64_t> Sequence;     //Equal to the position a producer may write at, or one past the position the writer may read
+        LogRecord Record;
+    };
+
+    void WriterMain()
+    {
+        uint64_t tail = 0;
+        bool continued = false;     //Set while part of a message has yet to be written
+        while (true)
+        {
+            //Drain every published record, then flush the file once
+            bool wrote = false;
+            while (true)
+            {
+                Cell& cell = m_Cells[tail & (CAPACITY - 1)];
+                if (cell.Sequence.load(std::memory_order_acquire) != tail + 1)
+                {
+                    break;
+                }
+
+                Write(cell.Record);
+                continued = cell.Record.Continued;
+                cell.Sequence.store(tail + CAPACITY, std::memory_order_release);
+                tail++;
+                wrote = true;
+            }
+
+            //Messages are published a record at a time, so the note waits until the rest of a message has been written
+            const uint64_t dropped = continued ? 0 : m_Dropped.exchange(0, std::memory_order_relaxed);
+            if (dropped != 0)
+            {
+                LogRecord note = { std::chrono::system_clock::now(), LogRecord::EType::Text, 0, 0, false, {} };
+                note.Length = (uint32_t)snprintf(note.Text, LogRecord::TEXT_SIZE, "\n[Log queue full: %llu messages dropped]\n", (unsigned long long)dropped);
+                Write(note);
+                wrote = true;
+            }
+
+            if (wrote)
+            {
+                for (FILE* fp : { m_TextFile, m_BinaryFile })
+                {
+                    if (fp != nullptr)
+                    {
+                        fflush(fp);
+                    }
+                }
+            }
+
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            m_Written = tail;
+            m_Flushed.notify_all();
+
+            if (m_Stopping && m_Head.load(std::memory_order_acquire) == tail)
+            {
+                break;
+            }
+
+            //Sleep unless a flush is waiting on records which have yet to be written
+            if (!wrote && m_FlushTarget <= tail)
+            {
+                m_Wake.wait_for(lock, IDLE_INTERVAL);
+            }
+        }
+
+        for (FILE* fp : { m_TextFile, m_BinaryFile })
+        {
+            if (fp != nullptr)
+            {
+                fclose(fp);
+            }
+        }
+    }
+
+    void Write(const LogRecord& record)
+    {
+        const bool binary = m_Format.load(std::memory_order_relaxed) == ELogFormat::Binary;
+        if (binary)
+        {
+            WriteBinary(record);
+            if (!DEBUG_OUTPUT)
+            {
+                return;
+            }
+        }
+
+        std::basic_string<char> text;
+        if (record.Type == LogRecord::EType::Time)
+        {
+            text = LogFormat::FormatTime(std::chrono::system_clock::to_time_t(record.Timestamp));
+        }
+        else if (record.Type == LogRecord::EType::Deferred)
+        {
+            text = LogFormat::Format(GetFormat(record.Format), (const uint8_t*)record.Text, record.Length);
+        }
+        else
+        {
+            text.assign(record.Text, record.Length);
+        }
 
         //Output to VS output window
 #ifdef _WIN32
-        OutputDebugStringA(buffer);
+        OutputDebugStringA(text.c_str());
 #endif
 
         //Output to Logfile
-        if (LOG_TO_FILE) {
-            FILE* fp;
-            fopen_s(&fp, "Log.txt", "a+");
-            if (fp != nullptr) {
-                fprintf(fp, "%s", buffer);
-                fclose(fp);
+        if (!binary && OpenFile(m_TextFile, m_TextFailed, "Log.txt", "a+"))
+        {
+            fwrite(text.data(), 1, text.size(), m_TextFile);
+        }
+    }
+
+    void WriteBinary(const LogRecord& record)
+    {
+        const bool opened = m_BinaryFile != nullptr;
+        if (!OpenFile(m_BinaryFile, m_BinaryFailed, "Log.bin", "ab"))
+        {
+            return;
+        }
+
+        //Each session starts with a header, as the file is appended to
+        if (!opened)
+        {
+            fwrite(LogFormat::BINARY_MAGIC, 1, sizeof(LogFormat::BINARY_MAGIC), m_BinaryFile);
+            fwrite(&LogFormat::BINARY_VERSION, sizeof(LogFormat::BINARY_VERSION), 1, m_BinaryFile);
+        }
+
+        //Binary records are written in the machine's byte order, as the decoder runs on the same machines as the engine
+        const auto write = [&](const auto& value) { fwrite(&value, sizeof(value), 1, m_BinaryFile); };
+
+        switch (record.Type)
+        {
+        case LogRecord::EType::Time:
+            write(LogFormat::EBinaryRecord::Time);
+            write((int64_t)std::chrono::system_clock::to_time_t(record.Timestamp));
+            break;
+        case LogRecord::EType::Deferred:
+            //Each format is written before its first message, so the log can be decoded without the engine
+            if (record.Format >= m_Defined.size())
+            {
+                m_Defined.resize(record.Format + 1, false);
+            }
+            if (!m_Defined[record.Format])
+            {
+                const std::string_view format = GetFormat(record.Format);
+                write(LogFormat::EBinaryRecord::Format);
+                write(record.Format);
+                write((uint16_t)std::min<size_t>(format.size(), UINT16_MAX));
+                fwrite(format.data(), 1, std::min<size_t>(format.size(), UINT16_MAX), m_BinaryFile);
+                m_Defined[record.Format] = true;
             }
+
+            write(LogFormat::EBinaryRecord::Message);
+            write(record.Format);
+            write((uint16_t)record.Length);
+            fwrite(record.Text, 1, record.Length, m_BinaryFile);
+            break;
+        default:
+            write(LogFormat::EBinaryRecord::Text);
+            write((uint16_t)record.Length);
+            fwrite(record.Text, 1, record.Length, m_BinaryFile);
+            break;
+        }
+    }
+
+    /**
+     * \brief Opens a log file on first use.
+     * \return False if logging to file is disabled, or the file couldn't be opened.
+     */
+    static bool OpenFile(FILE*& fp, bool& failed, const char* path, const char* mode)
+    {
+        if (fp == nullptr && LOG_TO_FILE && !failed)
+        {
+            fp = fopen(path, mode);
+            failed = fp == nullptr;     //Only tried once, rather than for every message
+        }
+
+        return fp != nullptr;
+    }
+
+    /**
+     * \brief Looks up a deferred format, copying newly registered formats from the registry.
+     */
+    std::string_view GetFormat(uint32_t id)
+    {
+        if (id >= m_Formats.size())
+        {
+            LogFormats& formats = GetFormats();
+            std::lock_guard<std::mutex> lock(formats.Mutex);
+            m_Formats = formats.Formats;
         }
+
+        return id < m_Formats.size() ? m_Formats[id] : "<unregistered format>";
+    }
+
+    std::unique_ptr<Cell[]> m_Cells;
+    alignas(64) std::atomic<uint64_t> m_Head = 0;      //The next position producers claim
+    alignas(64) std::atomic<uint64_t> m_Dropped = 0;
+    std::atomic<ELogOverflow> m_Overflow = ELogOverflow::Drop;
+    std::atomic<ELogFormat> m_Format = ELogFormat::Text;
+
+    //Only used by the writer's thread
+    FILE* m_TextFile = nullptr;
+    FILE* m_BinaryFile = nullptr;
+    bool m_TextFailed = false;
+    bool m_BinaryFailed = false;
+    std::vector<const char*> m_Formats;
+    std::vector<bool> m_Defined;        //Formats written to the binary log
+
+    std::mutex m_Mutex;
+    std::condition_variable m_Wake;
+    std::condition_variable m_Flushed;
+    uint64_t m_Written = 0;         //Records written and flushed to the file
+    uint64_t m_FlushTarget = 0;
+    bool m_Stopping = false;
+
+    std::thread m_Thread;
+};
+
+/**
+ * \brief The writer starts on first use, and drains the queue when the process exits.
+ */
+static LogWriter& GetWriter()
+{
+    static LogWriter writer;
+    return writer;
+}
+
+/**
+ * \brief Formats a message, and queues its records together.
+ * \param timestamped Queues the current time ahead of the message, with its records.
+ */
+static void LogMessage(bool timestamped, const char* fmt, va_list params)
+{
+    static thread_local char buffer[1 << 11] = { 0 };
+
+    //Format string
+    const int formatted = vsnprintf(buffer, sizeof(buffer), fmt, params);
+    if (formatted <= 0)
+    {
+        return;
+    }
+
+    const uint32_t length = std::min((uint32_t)formatted, (uint32_t)sizeof(buffer) - 1);
+    const uint32_t first = timestamped ? 1 : 0;
+    const uint32_t count = first + (length + LogRecord::TEXT_SIZE - 1) / LogRecord::TEXT_SIZE;
+
+    //The time is taken now, and formatted by the writer
+    const auto timestamp = std::chrono::system_clock::now();
+
+    GetWriter().Push(count, [&](LogRecord& record, uint32_t index)
+    {
+        if (index < first)
+        {
+            record.Timestamp = timestamp;
+            record.Type = LogRecord::EType::Time;
+            record.Length = 0;
+            return;
+        }
+
+        const uint32_t offset = (index - first) * LogRecord::TEXT_SIZE;
+        record.Type = LogRecord::EType::Text;
+        record.Length = std::min(length - offset, LogRecord::TEXT_SIZE);
+        memcpy(record.Text, buffer + offset, record.Length);
+    });
+}
+
+static void LogTimestamped(const char* fmt, ...)
+{
+    va_list params;
+    va_start(params, fmt);
+    LogMessage(true, fmt, params);
+    va_end(params);
+}
+
+void Engine::Log(const char* fmt, ...)
+{
+    if (ENABLE_LOGGING) {
+        va_list params;
+        va_start(params, fmt);
+        LogMessage(false, fmt, params);
+        va_end(params);
     }
 }
 
 void Engine::LogTime()
 {
-    auto now = Timing::Now();
-    auto t = std::localtime(&now);
-    int year = t->tm_year + 1900;
-    int month = t->tm_mon + 1;
-    int day = t->tm_mday;
-    int hours = t->tm_hour;
-    int minutes = t->tm_min;
-    int seconds = t->tm_sec;
+    if (ENABLE_LOGGING) {
+        //The time is taken now, and formatted by the writer
+        const auto timestamp = std::chrono::system_clock::now();
+        GetWriter().Push(1, [&](LogRecord& record, uint32_t)
+        {
+            record.Timestamp = timestamp;
+            record.Type = LogRecord::EType::Time;
+            record.Length = 0;
+        });
+    }
+}
+
+void Engine::FlushLog()
+{
+    if (ENABLE_LOGGING) {
+        GetWriter().Flush();
+    }
+}
+
+void Engine::SetLogOverflow(ELogOverflow policy)
+{
+    if (ENABLE_LOGGING) {
+        GetWriter().SetOverflow(policy);
+    }
+}
+
+void Engine::SetLogFormat(ELogFormat format)
+{
+    if (ENABLE_LOGGING) {
+        GetWriter().SetFormat(format);
+    }
+}
 
-    Log("\n[%04d/%02d/%02d - %02d:%02d:%02d]\n", year, month, day, hours, minutes, seconds);
+uint32_t Engine::RegisterLogFormat(const char* fmt)
+{
+    LogFormats& formats = GetFormats();
+    std::lock_guard<std::mutex> lock(formats.Mutex);
+    formats.Formats.push_back(fmt);
+    return (uint32_t)formats.Formats.size() - 1;
+}
+
+void Engine::LogEncoded(uint32_t format, const uint8_t* args, uint32_t size)
+{
+    if (ENABLE_LOGGING) {
+        static_assert(LOG_ARGS_SIZE <= LogRecord::TEXT_SIZE);
+
+        GetWriter().Push(1, [&](LogRecord& record, uint32_t)
+        {
+            record.Type = LogRecord::EType::Deferred;
+            record.Format = format;
+            record.Length = size;
+            memcpy(record.Text, args, size);
+        });
+    }
+}
+
+void Engine::SetLogLevel(ELogCategory category, ELogLevel level)
+{
+    LogLevels[(size_t)category].store(level, std::memory_order_relaxed);
+}
+
+void Engine::SetLogLevel(ELogLevel level)
+{
+    for (auto& threshold : LogLevels)
+    {
+        threshold.store(level, std::memory_order_relaxed);
+    }
+}
+
+void Engine::LogReport(ELogLevel level, const char* msg, const char* file, int line)
+{
+    if (ENABLE_LOGGING) {
+        //The time is queued with the report, so that another thread's message can't be written between them
+        LogTimestamped("\n%s: %s\nFILE:\t%s\nLINE:\t%d\n", level == ELogLevel::Error ? "Error" : "Warning", msg, file, line);
+    }
+
+    if (level == ELogLevel::Error)
+    {
+        FlushLog();
+    }
 }
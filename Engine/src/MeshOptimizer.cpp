@@ -0,0 +1,774 @@
+#define LOG_CATEGORY Importer
+#include "../inc/IO/MeshOptimizer.h"
+#include "../inc/IO/Logger.h"
+#include <algorithm>
+#include <cfloat>
+#include <cstring>
+#include <unordered_map>
+
+using namespace Engine;
+
+constexpr uint32_t MAX_ATTRIBUTES = 8;  //Position (3) + Normal (3) + TexCoord (2)
+
+/**
+ * \brief Generalized quadric (Garland & Heckbert 1998), in up to MAX_ATTRIBUTES dimensions.
+ * Q(v) = v'Av + 2b'v + c. A is symmetric, so only its upper triangle is stored.
+ */
+struct Quadric
+{
+    float A[MAX_ATTRIBUTES * (MAX_ATTRIBUTES + 1) / 2];
+    float b[MAX_ATTRIBUTES];
+    float c;
+};
+
+static void QuadricAdd(Quadric& q, const Quadric& r, uint32_t dims)
+{
+    for (uint32_t i = 0; i < dims * (dims + 1) / 2; i++)
+    {
+        q.A[i] += r.A[i];
+    }
+    for (uint32_t i = 0; i < dims; i++)
+    {
+        q.b[i] += r.b[i];
+    }
+    q.c += r.c;
+}
+
+static float QuadricError(const Quadric& q, const float* v, uint32_t dims)
+{
+    float vAv = 0.0f;
+    float bv = 0.0f;
+    uint32_t k = 0;
+
+    for (uint32_t i = 0; i < dims; i++)
+    {
+        vAv += q.A[k++] * v[i] * v[i];
+        for (uint32_t j = i + 1; j < dims; j++)
+        {
+            vAv += 2.0f * q.A[k++] * v[i] * v[j];
+        }
+        bv += q.b[i] * v[i];
+    }
+
+    //Rounding can push the error slightly below zero
+    return std::max(vAv + 2.0f * bv + q.c, 0.0f);
+}
+
+/**
+ * \brief Builds the quadric measuring the squared distance to the plane spanned by a triangle, weighted by its area.
+ * \return false if the triangle is degenerate.
+ */
+static bool QuadricFromTriangle(Quadric& q, const float* p0, const float* p1, const float* p2, uint32_t dims, float weight)
+{
+    float e1[MAX_ATTRIBUTES];
+    float e2[MAX_ATTRIBUTES];
+
+    //Build an orthonormal basis (e1, e2) of the triangle's plane
+    float len = 0.0f;
+    for (uint32_t i = 0; i < dims; i++)
+    {
+        e1[i] = p1[i] - p0[i];
+        len += e1[i] * e1[i];
+    }
+    if (len <= 0.0f)
+    {
+        return false;
+    }
+    len = sqrtf(len);
+    for (uint32_t i = 0; i < dims; i++)
+    {
+        e1[i] /= len;
+    }
+
+    float d = 0.0f;
+    for (uint32_t i = 0; i < dims; i++)
+    {
+        e2[i] = p2[i] - p0[i];
+        d += e1[i] * e2[i];
+    }
+    len = 0.0f;
+    for (uint32_t i = 0; i < dims; i++)
+    {
+        e2[i] -= d * e1[i];
+        len += e2[i] * e2[i];
+    }
+    if (len <= 0.0f)
+    {
+        return false;
+    }
+    len = sqrtf(len);
+    for (uint32_t i = 0; i < dims; i++)
+    {
+        e2[i] /= len;
+    }
+
+    float pe1 = 0.0f;
+    float pe2 = 0.0f;
+    float pp = 0.0f;
+    for (uint32_t i = 0; i < dims; i++)
+    {
+        pe1 += p0[i] * e1[i];
+        pe2 += p0[i] * e2[i];
+        pp += p0[i] * p0[i];
+    }
+
+    //A = I - e1e1' - e2e2'
+    uint32_t k = 0;
+    for (uint32_t i = 0; i < dims; i++)
+    {
+        for (uint32_t j = i; j < dims; j++)
+        {
+            q.A[k++] = weight * ((i == j ? 1.0f : 0.0f) - e1[i] * e1[j] - e2[i] * e2[j]);
+        }
+        //b = (p.e1)e1 + (p.e2)e2 - p
+        q.b[i] = weight * (pe1 * e1[i] + pe2 * e2[i] - p0[i]);
+    }
+    //c = p.p - (p.e1)^2 - (p.e2)^2
+    q.c = weight * (pp - pe1 * pe1 - pe2 * pe2);
+
+    return true;
+}
+
+static Vector3f TriangleNormal(const Vector3f& a, const Vector3f& b, const Vector3f& c)
+{
+    return Math::Cross(b - a, c - a);
+}
+
+float MeshOptimizer::Simplify(const MeshFilter& mesh, const std::vector<uint32_t>& indices, uint32_t targetIndexCount, std::vector<uint32_t>& output, const LODSettings& settings)
+{
+    output = indices;
+
+    const size_t vertexCount = mesh.Vertices.size();
+    if (vertexCount == 0 || indices.size() <= targetIndexCount)
+    {
+        return 0.0f;
+    }
+
+    const bool useNormals = mesh.Normals.size() == vertexCount && settings.NormalWeight > 0.0f;
+    const bool useTexCoords = mesh.TexCoords.size() == vertexCount && settings.TexCoordWeight > 0.0f;
+    const uint32_t dims = 3 + (useNormals ? 3 : 0) + (useTexCoords ? 2 : 0);
+
+    //Normalize positions into a unit cube, so attribute weights are independent of the mesh's scale
+    Vector3f minExtent = mesh.Vertices[0];
+    Vector3f maxExtent = mesh.Vertices[0];
+    for (const auto& v : mesh.Vertices)
+    {
+        minExtent = { std::min(minExtent.x, v.x), std::min(minExtent.y, v.y), std::min(minExtent.z, v.z) };
+        maxExtent = { std::max(maxExtent.x, v.x), std::max(maxExtent.y, v.y), std::max(maxExtent.z, v.z) };
+    }
+    const float extent = std::max({ maxExtent.x - minExtent.x, maxExtent.y - minExtent.y, maxExtent.z - minExtent.z, 1e-6f });
+    const float invExtent = 1.0f / extent;
+
+    std::vector<float> attributes(vertexCount * MAX_ATTRIBUTES);
+    for (size_t i = 0; i < vertexCount; i++)
+    {
+        float* a = &attributes[i * MAX_ATTRIBUTES];
+        a[0] = (mesh.Vertices[i].x - minExtent.x) * invExtent;
+        a[1] = (mesh.Vertices[i].y - minExtent.y) * invExtent;
+        a[2] = (mesh.Vertices[i].z - minExtent.z) * invExtent;
+
+        uint32_t k = 3;
+        if (useNormals)
+        {
+            a[k++] = mesh.Normals[i].x * settings.NormalWeight;
+            a[k++] = mesh.Normals[i].y * settings.NormalWeight;
+            a[k++] = mesh.Normals[i].z * settings.NormalWeight;
+        }
+        if (useTexCoords)
+        {
+            a[k++] = mesh.TexCoords[i].x * settings.TexCoordWeight;
+            a[k++] = mesh.TexCoords[i].y * settings.TexCoordWeight;
+        }
+    }
+
+    //Weld vertices by position. Vertices which share a position with another vertex lie on an attribute seam.
+    std::vector<uint32_t> positionID(vertexCount);
+    std::vector<bool> locked(vertexCount, false);
+    {
+        std::unordered_map<uint64_t, uint32_t> positions;
+        positions.reserve(vertexCount);
+
+        for (uint32_t i = 0; i < (uint32_t)vertexCount; i++)
+        {
+            uint32_t bits[3];
+            memcpy(bits, &mesh.Vertices[i], sizeof(bits));
+            const uint64_t key = ((uint64_t)bits[0] * 73856093ull) ^ ((uint64_t)bits[1] * 19349663ull << 16) ^ ((uint64_t)bits[2] * 83492791ull << 32);
+
+            //Resolve hash collisions by probing
+            uint64_t slot = key;
+            while (true)
+            {
+                auto it = positions.find(slot);
+                if (it == positions.end())
+                {
+                    positions.emplace(slot, i);
+                    positionID[i] = i;
+                    break;
+                }
+                if (memcmp(&mesh.Vertices[it->second], &mesh.Vertices[i], sizeof(Vector3f)) == 0)
+                {
+                    positionID[i] = it->second;
+                    //Seam vertices are locked, to avoid opening cracks between attribute charts.
+                    locked[i] = true;
+                    locked[it->second] = true;
+                    break;
+                }
+                slot++;
+            }
+        }
+    }
+
+    //Lock vertices on open borders; a border edge has no opposing half-edge.
+    {
+        std::unordered_map<uint64_t, uint32_t> halfEdges;
+        halfEdges.reserve(indices.size());
+        for (size_t i = 0; i + 2 < indices.size(); i += 3)
+        {
+            for (uint32_t e = 0; e < 3; e++)
+            {
+                const uint64_t a = positionID[indices[i + e]];
+                const uint64_t b = positionID[indices[i + (e + 1) % 3]];
+                halfEdges[(a << 32) | b]++;
+            }
+        }
+        for (size_t i = 0; i + 2 < indices.size(); i += 3)
+        {
+            for (uint32_t e = 0; e < 3; e++)
+            {
+                const uint64_t a = positionID[indices[i + e]];
+                const uint64_t b = positionID[indices[i + (e + 1) % 3]];
+                if (!halfEdges.contains((b << 32) | a))
+                {
+                    locked[indices[i + e]] = true;
+                    locked[indices[i + (e + 1) % 3]] = true;
+                }
+            }
+        }
+    }
+
+    //Accumulate the attribute and position quadrics of each vertex from its faces.
+    //Attribute quadrics are area weighted and rank collapses. Position quadrics are unweighted, so that
+    //the square root of their error bounds the distance to every original plane around the vertex.
+    std::vector<Quadric> attributeQuadrics(vertexCount);
+    std::vector<Quadric> positionQuadrics(vertexCount);
+    memset(attributeQuadrics.data(), 0, sizeof(Quadric) * vertexCount);
+    memset(positionQuadrics.data(), 0, sizeof(Quadric) * vertexCount);
+
+    for (size_t i = 0; i + 2 < indices.size(); i += 3)
+    {
+        const float* p0 = &attributes[indices[i] * MAX_ATTRIBUTES];
+        const float* p1 = &attributes[indices[i + 1] * MAX_ATTRIBUTES];
+        const float* p2 = &attributes[indices[i + 2] * MAX_ATTRIBUTES];
+
+        const Vector3f n = TriangleNormal({ p0[0], p0[1], p0[2] }, { p1[0], p1[1], p1[2] }, { p2[0], p2[1], p2[2] });
+        const float area = Math::VectorLength(n) * 0.5f;
+
+        Quadric q = {};
+        if (QuadricFromTriangle(q, p0, p1, p2, dims, area))
+        {
+            for (uint32_t v = 0; v < 3; v++)
+            {
+                QuadricAdd(attributeQuadrics[indices[i + v]], q, dims);
+            }
+        }
+        q = {};
+        if (QuadricFromTriangle(q, p0, p1, p2, 3, 1.0f))
+        {
+            for (uint32_t v = 0; v < 3; v++)
+            {
+                QuadricAdd(positionQuadrics[indices[i + v]], q, 3);
+            }
+        }
+    }
+
+    struct Collapse
+    {
+        uint32_t from;
+        uint32_t to;
+        float cost;
+        float error;
+    };
+
+    std::vector<Collapse> collapses;
+    std::vector<uint64_t> edges;
+    std::vector<uint32_t> remap(vertexCount);
+    std::vector<bool> touched(vertexCount);
+    std::vector<uint32_t> adjacencyOffsets(vertexCount + 1);
+    std::vector<uint32_t> adjacency;
+
+    const float maxError = settings.MaxError;
+    float resultError = 0.0f;   //Squared, in normalized units
+
+    while (output.size() > targetIndexCount)
+    {
+        //Gather the unique edges of the current triangle list
+        edges.clear();
+        for (size_t i = 0; i + 2 < output.size(); i += 3)
+        {
+            for (uint32_t e = 0; e < 3; e++)
+            {
+                const uint64_t a = output[i + e];
+                const uint64_t b = output[i + (e + 1) % 3];
+                edges.emplace_back(a < b ? (a << 32) | b : (b << 32) | a);
+            }
+        }
+        std::sort(edges.begin(), edges.end());
+        edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+        //Pick the cheapest direction of each edge. Collapses move a vertex onto the other endpoint.
+        collapses.clear();
+        for (const auto edge : edges)
+        {
+            const uint32_t a = (uint32_t)(edge >> 32);
+            const uint32_t b = (uint32_t)(edge & 0xffffffff);
+
+            Collapse best = { 0, 0, FLT_MAX, 0.0f };
+            for (uint32_t dir = 0; dir < 2; dir++)
+            {
+                const uint32_t from = dir == 0 ? a : b;
+                const uint32_t to = dir == 0 ? b : a;
+                if (locked[from])
+                {
+                    continue;
+                }
+
+                Quadric q = attributeQuadrics[from];
+                QuadricAdd(q, attributeQuadrics[to], dims);
+                const float cost = QuadricError(q, &attributes[to * MAX_ATTRIBUTES], dims);
+
+                if (cost < best.cost)
+                {
+                    Quadric p = positionQuadrics[from];
+                    QuadricAdd(p, positionQuadrics[to], 3);
+                    best = { from, to, cost, QuadricError(p, &attributes[to * MAX_ATTRIBUTES], 3) };
+                }
+            }
+
+            if (best.cost != FLT_MAX && best.error <= maxError * maxError)
+            {
+                collapses.emplace_back(best);
+            }
+        }
+
+        if (collapses.empty())
+        {
+            break;
+        }
+
+        std::sort(collapses.begin(), collapses.end(), [](const Collapse& l, const Collapse& r) { return l.cost < r.cost; });
+
+        //Build vertex -> triangle adjacency, for flip tests
+        std::fill(adjacencyOffsets.begin(), adjacencyOffsets.end(), 0);
+        for (const auto index : output)
+        {
+            adjacencyOffsets[index + 1]++;
+        }
+        for (size_t i = 0; i < vertexCount; i++)
+        {
+            adjacencyOffsets[i + 1] += adjacencyOffsets[i];
+        }
+        adjacency.resize(output.size());
+        {
+            std::vector<uint32_t> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+            for (uint32_t i = 0; i < (uint32_t)output.size(); i++)
+            {
+                adjacency[fill[output[i]]++] = i / 3;
+            }
+        }
+
+        auto _flips = [&](uint32_t from, uint32_t to)
+        {
+            const Vector3f& target = mesh.Vertices[to];
+            for (uint32_t i = adjacencyOffsets[from]; i < adjacencyOffsets[from + 1]; i++)
+            {
+                const uint32_t* tri = &output[adjacency[i] * 3];
+                if (tri[0] == to || tri[1] == to || tri[2] == to)
+                {
+                    continue;   //This triangle collapses to a degenerate and will be removed
+                }
+
+                Vector3f v[3] = { mesh.Vertices[tri[0]], mesh.Vertices[tri[1]], mesh.Vertices[tri[2]] };
+                const Vector3f before = TriangleNormal(v[0], v[1], v[2]);
+                for (uint32_t k = 0; k < 3; k++)
+                {
+                    if (tri[k] == from)
+                    {
+                        v[k] = target;
+                    }
+                }
+                const Vector3f after = TriangleNormal(v[0], v[1], v[2]);
+
+                if (Math::Dot(before, after) <= 0.0f)
+                {
+                    return true;
+                }
+            }
+            return false;
+        };
+
+        //Apply the cheapest independent collapses. Each collapse removes roughly two triangles.
+        for (uint32_t i = 0; i < (uint32_t)vertexCount; i++)
+        {
+            remap[i] = i;
+        }
+        std::fill(touched.begin(), touched.end(), false);
+
+        const size_t collapseGoal = (output.size() - targetIndexCount) / 6 + 1;
+        size_t applied = 0;
+
+        for (const auto& c : collapses)
+        {
+            if (applied >= collapseGoal)
+            {
+                break;
+            }
+            if (touched[c.from] || touched[c.to] || _flips(c.from, c.to))
+            {
+                continue;
+            }
+
+            remap[c.from] = c.to;
+            QuadricAdd(attributeQuadrics[c.to], attributeQuadrics[c.from], dims);
+            QuadricAdd(positionQuadrics[c.to], positionQuadrics[c.from], 3);
+            touched[c.from] = true;
+            touched[c.to] = true;
+
+            resultError = std::max(resultError, c.error);
+            applied++;
+        }
+
+        if (applied == 0)
+        {
+            break;
+        }
+
+        //Rewrite the triangle list, discarding triangles which became degenerate
+        size_t write = 0;
+        for (size_t i = 0; i + 2 < output.size(); i += 3)
+        {
+            const uint32_t a = remap[output[i]];
+            const uint32_t b = remap[output[i + 1]];
+            const uint32_t c = remap[output[i + 2]];
+
+            if (a != b && b != c && a != c)
+            {
+                output[write++] = a;
+                output[write++] = b;
+                output[write++] = c;
+            }
+        }
+        output.resize(write);
+    }
+
+    return sqrtf(resultError) * extent;
+}
+
+void MeshOptimizer::GenerateLODs(MeshFilter& mesh, const LODSettings& settings)
+{
+    mesh.LODs.clear();
+    mesh.LODs.reserve(settings.MaxLODs);
+
+    //Every level is simplified from the full mesh, so that its error is measured against the original surface,
+    //rather than against a level which has already moved away from it.
+    const size_t triangles = mesh.Indices.size() / 3;
+    size_t previous = mesh.Indices.size();
+    float reduction = settings.Reduction;
+    for (uint32_t lod = 0; lod < settings.MaxLODs; lod++, reduction *= settings.Reduction)
+    {
+        const uint32_t target = (uint32_t)(triangles * reduction) * 3;
+        if (target < 3)
+        {
+            break;
+        }
+
+        MeshLOD level = {};
+        level.Error = Simplify(mesh, mesh.Indices, target, level.Indices, settings);
+
+        //Stop once simplification stalls, as the remaining levels would be duplicates.
+        if (level.Indices.size() >= previous * 0.9f)
+        {
+            break;
+        }
+
+        //A coarser level may measure a smaller error than its predecessor. Keep the errors increasing, so that SelectLOD() never prefers it at a distance where its predecessor is rejected.
+        if (!mesh.LODs.empty())
+        {
+            level.Error = std::max(level.Error, mesh.LODs.back().Error);
+        }
+
+        previous = level.Indices.size();
+        mesh.LODs.emplace_back(std::move(level));
+    }
+}
+
+float MeshOptimizer::ScreenSpaceError(float error, float distance, const Frustrum& frustrum, float screenHeight)
+{
+    distance = std::max(distance, frustrum.NearPlane);
+    const float projectionScale = screenHeight / (2.0f * tanf(Math::DegToRad(frustrum.FoVDegrees) * 0.5f));
+
+    return error / distance * projectionScale;
+}
+
+uint32_t MeshOptimizer::SelectLOD(const MeshFilter& mesh, float distance, const Frustrum& frustrum, float screenHeight, float pixelThreshold)
+{
+    for (uint32_t lod = (uint32_t)mesh.LODs.size(); lod > 0; lod--)
+    {
+        if (ScreenSpaceError(mesh.LODs[lod - 1].Error, distance, frustrum, screenHeight) <= pixelThreshold)
+        {
+            return lod;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * \brief Computes the bounding sphere and backface cone of a meshlet.
+ */
+static void ComputeMeshletBounds(const MeshFilter& mesh, Meshlet& meshlet)
+{
+    const uint32_t* vertices = &mesh.MeshletVertices[meshlet.VertexOffset];
+    const uint8_t* triangles = &mesh.MeshletTriangles[meshlet.TriangleOffset];
+
+    //Bounding sphere (Ritter). Start from the two most distant points found from an arbitrary vertex.
+    auto _farthest = [&](const Vector3f& from)
+    {
+        Vector3f result = from;
+        float best = -1.0f;
+        for (uint32_t i = 0; i < meshlet.VertexCount; i++)
+        {
+            const Vector3f& v = mesh.Vertices[vertices[i]];
+            const float d = Math::Dot(v - from, v - from);
+            if (d > best)
+            {
+                best = d;
+                result = v;
+            }
+        }
+        return result;
+    };
+
+    const Vector3f a = _farthest(mesh.Vertices[vertices[0]]);
+    const Vector3f b = _farthest(a);
+
+    Vector3f center = (a + b) * 0.5f;
+    float radius = Math::VectorLength(b - a) * 0.5f;
+
+    for (uint32_t i = 0; i < meshlet.VertexCount; i++)
+    {
+        const Vector3f& v = mesh.Vertices[vertices[i]];
+        const float d = Math::VectorLength(v - center);
+        if (d > radius)
+        {
+            //Grow the sphere to enclose the point
+            const float newRadius = (radius + d) * 0.5f;
+            center = center + (v - center) * ((newRadius - radius) / d);
+            radius = newRadius;
+        }
+    }
+    meshlet.Bounds = { center, radius };
+
+    //Backface cone, from the meshlet's triangle normals
+    std::vector<Vector3f> normals;
+    std::vector<Vector3f> corners;
+    normals.reserve(meshlet.TriangleCount);
+    corners.reserve(meshlet.TriangleCount);
+
+    Vector3f axis = {};
+    for (uint32_t i = 0; i < meshlet.TriangleCount; i++)
+    {
+        const Vector3f& p0 = mesh.Vertices[vertices[triangles[i * 3]]];
+        const Vector3f& p1 = mesh.Vertices[vertices[triangles[i * 3 + 1]]];
+        const Vector3f& p2 = mesh.Vertices[vertices[triangles[i * 3 + 2]]];
+
+        const Vector3f n = TriangleNormal(p0, p1, p2);
+        if (Math::VectorLength(n) <= 0.0f)
+        {
+            continue;
+        }
+        normals.emplace_back(Math::Normalize(n));
+        corners.emplace_back(p0);
+        axis = axis + normals.back();
+    }
+
+    meshlet.ConeApex = center;
+    meshlet.ConeAxis = {};
+    meshlet.ConeCutoff = 1.0f;  //Never cull
+
+    if (normals.empty() || Math::VectorLength(axis) <= 0.0f)
+    {
+        return;
+    }
+    axis = Math::Normalize(axis);
+
+    float minDot = 1.0f;
+    for (const auto& n : normals)
+    {
+        minDot = std::min(minDot, Math::Dot(n, axis));
+    }
+
+    //Cones wider than ~85 degrees are rarely culled, so skip them.
+    if (minDot <= 0.1f)
+    {
+        return;
+    }
+
+    //Place the apex such that every triangle's plane lies in front of it
+    float maxT = 0.0f;
+    for (size_t i = 0; i < normals.size(); i++)
+    {
+        const float dc = Math::Dot(center - corners[i], normals[i]);
+        const float dn = Math::Dot(axis, normals[i]);
+        maxT = std::max(maxT, dc / dn);
+    }
+
+    meshlet.ConeApex = center - axis * maxT;
+    meshlet.ConeAxis = axis;
+    meshlet.ConeCutoff = sqrtf(1.0f - minDot * minDot);
+}
+
+void MeshOptimizer::BuildMeshlets(MeshFilter& mesh, uint32_t maxVertices, uint32_t maxTriangles)
+{
+    //Local indices are 8-bit, so the vertex limit is clamped rather than only reported, as reports don't stop release builds
+    WARN(maxVertices > 256 || maxVertices < 3, "Meshlet vertex limit must be between 3 and 256, and has been clamped.");
+    WARN(maxTriangles < 1, "Meshlet triangle limit must be at least 1, and has been clamped.");
+    maxVertices = std::clamp(maxVertices, 3u, 256u);
+    maxTriangles = std::max(maxTriangles, 1u);
+
+    mesh.Meshlets.clear();
+    mesh.MeshletVertices.clear();
+    mesh.MeshletTriangles.clear();
+
+    if (mesh.Indices.empty())
+    {
+        return;
+    }
+
+    //Maps mesh vertices to their index within the current meshlet
+    std::vector<uint8_t> localIndex(mesh.Vertices.size(), 0xff);
+    std::vector<bool> inMeshlet(mesh.Vertices.size(), false);
+
+    Meshlet current = {};
+
+    auto _flush = [&]()
+    {
+        for (uint32_t i = 0; i < current.VertexCount; i++)
+        {
+            inMeshlet[mesh.MeshletVertices[current.VertexOffset + i]] = false;
+        }
+
+        ComputeMeshletBounds(mesh, current);
+        mesh.Meshlets.emplace_back(current);
+
+        current = {};
+        current.VertexOffset = (uint32_t)mesh.MeshletVertices.size();
+        current.TriangleOffset = (uint32_t)mesh.MeshletTriangles.size();
+    };
+
+    //Greedily append triangles in index order, flushing whenever a limit would be exceeded
+    for (size_t i = 0; i + 2 < mesh.Indices.size(); i += 3)
+    {
+        const uint32_t* tri = &mesh.Indices[i];
+
+        uint32_t newVertices = 0;
+        for (uint32_t v = 0; v < 3; v++)
+        {
+            const bool duplicate = (v > 0 && tri[v] == tri[0]) || (v > 1 && tri[v] == tri[1]);
+            if (!inMeshlet[tri[v]] && !duplicate)
+            {
+                newVertices++;
+            }
+        }
+
+        if (current.VertexCount + newVertices > maxVertices || current.TriangleCount + 1 > maxTriangles)
+        {
+            _flush();
+        }
+
+        for (uint32_t v = 0; v < 3; v++)
+        {
+            if (!inMeshlet[tri[v]])
+            {
+                inMeshlet[tri[v]] = true;
+                localIndex[tri[v]] = (uint8_t)current.VertexCount++;
+                mesh.MeshletVertices.emplace_back(tri[v]);
+            }
+            mesh.MeshletTriangles.emplace_back(localIndex[tri[v]]);
+        }
+        current.TriangleCount++;
+    }
+
+    if (current.TriangleCount > 0)
+    {
+        _flush();
+    }
+}
+
+uint32_t MeshOptimizer::CullMeshlets(const MeshFilter& mesh, const Matrix4x4& world, const Matrix4x4& view, const Vector3f& cameraPosition, const Frustrum& frustrum, std::vector<uint32_t>& visible, MeshletCullStats* stats)
+{
+    visible.clear();
+
+    const Matrix4x4 worldView = Math::MatrixMultiply(world, view);
+
+    //Spheres are scaled by the largest axis of the world matrix
+    const float scale = std::max({
+        Math::VectorLength({ world._matrix._11, world._matrix._12, world._matrix._13 }),
+        Math::VectorLength({ world._matrix._21, world._matrix._22, world._matrix._23 }),
+        Math::VectorLength({ world._matrix._31, world._matrix._32, world._matrix._33 }) });
+
+    //Side planes of the view frustrum pass through the origin in view space
+    const float tanY = tanf(Math::DegToRad(frustrum.FoVDegrees) * 0.5f);
+    const float tanX = tanY * frustrum.AspectRatio;
+    const float invLenX = 1.0f / sqrtf(1.0f + tanX * tanX);
+    const float invLenY = 1.0f / sqrtf(1.0f + tanY * tanY);
+
+    MeshletCullStats s = {};
+    s.Meshlets = (uint32_t)mesh.Meshlets.size();
+
+    for (uint32_t i = 0; i < (uint32_t)mesh.Meshlets.size(); i++)
+    {
+        const Meshlet& m = mesh.Meshlets[i];
+        s.Triangles += m.TriangleCount;
+
+        //Frustrum test, in view space
+        const Vector4f c = Math::MatrixMultiply(Vector4f{ m.Bounds.Position.x, m.Bounds.Position.y, m.Bounds.Position.z, 1.0f }, worldView);
+        const float r = m.Bounds.Radius * scale;
+
+        const bool outside =
+            (c.z + r < frustrum.NearPlane) ||
+            (c.z - r > frustrum.FarPlane) ||
+            ((fabsf(c.x) - c.z * tanX) * invLenX > r) ||
+            ((fabsf(c.y) - c.z * tanY) * invLenY > r);
+
+        if (outside)
+        {
+            s.FrustrumCulledMeshlets++;
+            s.CulledTriangles += m.TriangleCount;
+            continue;
+        }
+
+        //Backface cone test, in world space
+        if (m.ConeCutoff < 1.0f)
+        {
+            const Vector4f apex = Math::MatrixMultiply(Vector4f{ m.ConeApex.x, m.ConeApex.y, m.ConeApex.z, 1.0f }, world);
+            const Vector3f axis = Math::Normalize(Math::MatrixMultiply(m.ConeAxis, world));
+            const Vector3f toApex = Math::Normalize(Vector3f{ apex.x, apex.y, apex.z } - cameraPosition);
+
+            if (Math::Dot(toApex, axis) >= m.ConeCutoff)
+            {
+                s.BackfaceCulledMeshlets++;
+                s.CulledTriangles += m.TriangleCount;
+                continue;
+            }
+        }
+
+        visible.emplace_back(i);
+    }
+
+    if (stats != nullptr)
+    {
+        *stats = s;
+    }
+
+    return (uint32_t)visible.size();
+}
@@ -0,0 +1,540 @@
+#include "../inc/Graphics/Backends/Null_GFX.h"
+#include <algorithm>
+#include <cstring>
+
+using namespace Engine;
+
+/**
+ * \brief Initializes the backend. The window is unused, as nothing is presented to it.
+ */
+bool Null_GFX::Init([[maybe_unused]] Engine::Window& window, Engine::GraphicsMode mode)
+{
+    return Init(mode);
+}
+
+bool Null_GFX::Init(Engine::GraphicsMode mode)
+{
+    m_gMode = mode;
+    return true;
+}
+
+/**
+ * \brief Nothing is drawn, so there's nothing to clear.
+ */
+void Null_GFX::Clear([[maybe_unused]] uint8_t r, [[maybe_unused]] uint8_t g, [[maybe_unused]] uint8_t b, [[maybe_unused]] uint8_t a)
+{
+}
+
+/**
+ * \brief Ends the frame, publishing its statistics.
+ */
+void Null_GFX::Present()
+{
+    //Fence the frame's transient geometry
+    m_Frame++;
+    m_TransientVertices.EndFrame(m_Frame);
+    m_TransientIndices.EndFrame(m_Frame);
+    if (m_Frame > FRAMES_IN_FLIGHT)
+    {
+        m_TransientVertices.Retire(m_Frame - FRAMES_IN_FLIGHT);
+        m_TransientIndices.Retire(m_Frame - FRAMES_IN_FLIGHT);
+    }
+
+    //Materials may be edited before the next frame
+    m_State.Material = nullptr;
+
+    m_FrameStats = m_State.Stats;
+    m_State.Stats = {};
+    Profiler::EndFrame();
+}
+
+void Null_GFX::SetGraphicsMode([[maybe_unused]] const Window& window, GraphicsMode mode)
+{
+    m_gMode = mode;
+}
+
+void Null_GFX::SetSubmissionThreads(uint32_t threadCount)
+{
+    Graphics::SetSubmissionThreads(threadCount);
+
+    m_Recorders.clear();
+    if (threadCount > 1)
+    {
+        m_Recorders.resize(threadCount);
+    }
+}
+
+void Null_GFX::ReleaseResources()
+{
+    s_MeshBuffers.Clear();
+    m_TransientVertices.Reset(0);
+    m_TransientIndices.Reset(0);
+
+    //Nothing cached remains bound
+    const RenderStats stats = m_State.Stats;
+    m_State = {};
+    m_State.Stats = stats;
+
+    for (auto& recorder : m_Recorders)
+    {
+        recorder = {};
+    }
+}
+
+/**
+ * \brief Forgets the state bound to a context, as a device does once a command list is recorded or executed.
+ */
+void Null_GFX::ResetState(NullState& state)
+{
+    NullState reset;
+    reset.Textures = std::move(state.Textures);
+    reset.Stats = state.Stats;
+    state = std::move(reset);
+}
+
+/**
+ * \brief Whether a renderer's material differs from the one last set, for draws which aren't sorted into a queue.
+ */
+bool Null_GFX::MaterialChanged(const NullState& state, const MeshRenderer& renderer)
+{
+    return state.Shader != (uint32_t)renderer.shader || state.Technique != renderer.technique || state.Material != renderer.material;
+}
+
+void Null_GFX::Draw(Matrix4x4& worldMatrix, const MeshFilter& mesh, const MeshRenderer& renderer, Camera& camera)
+{
+    PROFILE_SCOPE("Draw Mesh");
+    BindMesh(m_State, mesh, renderer.shader);
+    SetShaderState(m_State, renderer, worldMatrix, camera, MaterialChanged(m_State, renderer));
+    BindTopology(m_State, renderer.topology);
+    DrawMesh(m_State, mesh);
+}
+
+void Null_GFX::Draw(Matrix4x4& worldMatrix, const Sprite& sprite, Camera& camera)
+{
+    PROFILE_SCOPE("Draw Sprite");
+    DrawTransient(worldMatrix, sprite.m_Sprite, sprite.m_Renderer, camera);
+}
+
+void Null_GFX::Draw(Matrix4x4& worldMatrix, const Text& text, Camera& camera)
+{
+    PROFILE_SCOPE("Draw Text");
+    if (text.m_Mesh.Indices.empty())
+    {
+        return;
+    }
+
+    DrawTransient(worldMatrix, text.m_Mesh, text.m_Renderer, camera);
+}
+
+/**
+ * \brief Draws a mesh which only lives for the frame, streaming it through the upload rings as DX11_GFX does.
+ */
+void Null_GFX::DrawTransient(Matrix4x4& worldMatrix, const MeshFilter& mesh, const MeshRenderer& renderer, Camera& camera)
+{
+    PROFILE_SCOPE("Draw Transient");
+    const uint32_t stride = sizeof(float) * VertexLayout::GetVertexSize(renderer.shader);
+    if (mesh.Vertices.empty() || stride == 0)
+    {
+        return;
+    }
+
+    VertexLayout::Interleave(mesh, renderer.shader, m_Vertices);
+    WriteTransient(m_TransientVertices, (uint32_t)(m_Vertices.size() * sizeof(float)), stride);
+    BindVertexBuffer(m_State, TRANSIENT_VERTEX_BUFFER, stride);
+
+    if (!mesh.Indices.empty())
+    {
+        WriteTransient(m_TransientIndices, (uint32_t)(mesh.Indices.size() * sizeof(uint32_t)), sizeof(uint32_t));
+        BindIndexBuffer(m_State, TRANSIENT_INDEX_BUFFER);
+    }
+
+    SetShaderState(m_State, renderer, worldMatrix, camera, MaterialChanged(m_State, renderer));
+    BindTopology(m_State, renderer.topology);
+    DrawMesh(m_State, mesh);
+}
+
+/**
+ * \brief Sub-allocates an upload ring. Frames are treated as finished FRAMES_IN_FLIGHT frames after they're presented.
+ * \return The allocation's offset, in bytes.
+ */
+uint32_t Null_GFX::WriteTransient(UploadRing& ring, uint32_t size, uint32_t alignment)
+{
+    uint32_t offset = 0;
+    while (!ring.Allocate(size, alignment, offset))
+    {
+        //Where a device backend would wait for the GPU
+        if (ring.HasFramesInFlight())
+        {
+            ring.Retire(ring.GetOldestFence());
+            continue;
+        }
+
+        const uint32_t capacity = std::max({ ring.GetCapacity() * 2, TRANSIENT_BUFFER_SIZE, size });
+        ring.Reset(capacity);
+    }
+
+    m_State.Stats.BytesUploaded += size;
+    return offset;
+}
+
+void Null_GFX::Draw(const SpriteBatch& batch, Camera& camera)
+{
+    PROFILE_SCOPE("Draw SpriteBatch");
+    if (batch.GetRanges().empty())
+    {
+        return;
+    }
+
+    m_State.Stats.BytesUploaded += batch.GetVertices().size() * sizeof(SpriteVertex);
+    m_State.Stats.BytesUploaded += batch.GetIndices().size() * sizeof(uint32_t);
+    BindVertexBuffer(m_State, SPRITE_VERTEX_BUFFER, sizeof(SpriteVertex));
+    BindIndexBuffer(m_State, SPRITE_INDEX_BUFFER);
+
+    Engine::SpriteRenderer material;
+    Engine::MeshRenderer renderer = { Engine::EPrimitiveTopology::TriangleList, Engine::EShaderType::SpriteRenderer, &material, "" };
+    Matrix4x4 world;
+
+    BindTopology(m_State, renderer.topology);
+
+    const SpriteBatchRange* previous = nullptr;
+    for (const auto& range : batch.GetRanges())
+    {
+        //The material is reused for every atlas, so it's compared by the range's atlas rather than by its address
+        const bool materialChanged = previous == nullptr || previous->Texture != range.Texture || previous->Technique != range.Technique;
+        if (materialChanged)
+        {
+            material.TextureAtlas = batch.GetTexture(range.Texture);
+            renderer.technique = batch.GetTechnique(range.Technique);
+        }
+
+        SetShaderState(m_State, renderer, world, camera, materialChanged);
+        m_State.Stats.DrawCalls++;
+        previous = &range;
+    }
+
+    m_State.Material = nullptr;
+}
+
+void Null_GFX::Draw(const RenderQueue& queue, Camera& camera)
+{
+    PROFILE_SCOPE("Draw RenderQueue");
+    const auto& commands = queue.GetCommands();
+
+    if (m_Workers != nullptr)
+    {
+        queue.Partition((uint32_t)m_Recorders.size(), MIN_COMMANDS_PER_THREAD, m_Ranges);
+    }
+
+    if (m_Workers == nullptr || m_Ranges.size() < 2)
+    {
+        RecordCommands(m_State, commands, camera);
+        return;
+    }
+
+    PrepareCommands(queue);
+
+    m_Workers->Run((uint32_t)m_Ranges.size(), [&](uint32_t i)
+    {
+        const CommandRange& range = m_Ranges[i];
+
+        //Each range starts from cleared state, as a deferred context would
+        ResetState(m_Recorders[i]);
+        RecordCommands(m_Recorders[i], std::span(commands).subspan(range.FirstCommand, range.CommandCount), camera);
+    });
+
+    //Execute the recorded ranges in queue order
+    for (size_t i = 0; i < m_Ranges.size(); i++)
+    {
+        m_State.Stats += m_Recorders[i].Stats;
+        m_Recorders[i].Stats = {};
+    }
+
+    ResetState(m_State);
+}
+
+/**
+ * \brief Interleaves the meshes a queue uses on the calling thread, so that recording threads only read the mesh cache.
+ */
+void Null_GFX::PrepareCommands(const RenderQueue& queue)
+{
+    const RenderCommand* previous = nullptr;
+
+    for (const auto& command : queue.GetCommands())
+    {
+        if (previous == nullptr || previous->Mesh != command.Mesh || previous->Renderer->shader != command.Renderer->shader)
+        {
+            LoadMesh(m_State, *command.Mesh, command.Renderer->shader);
+        }
+
+        previous = &command;
+    }
+}
+
+void Null_GFX::RecordCommands(NullState& state, std::span<const RenderCommand> commands, Camera& camera)
+{
+    const RenderCommand* previous = nullptr;
+
+    for (const auto& command : commands)
+    {
+        const MeshRenderer& renderer = *command.Renderer;
+        const bool shaderChanged = previous == nullptr || previous->Renderer->shader != renderer.shader;
+        const bool materialChanged = shaderChanged || previous->Technique != command.Technique || previous->Material != command.Material;
+
+        if (shaderChanged || previous->Mesh != command.Mesh)
+        {
+            BindMesh(state, *command.Mesh, renderer.shader);
+        }
+
+        SetShaderState(state, renderer, command.World, camera, materialChanged);
+
+        if (previous == nullptr || previous->Renderer->topology != renderer.topology)
+        {
+            BindTopology(state, renderer.topology);
+        }
+
+        DrawMesh(state, *command.Mesh);
+        previous = &command;
+    }
+}
+
+void Null_GFX::DrawInstanced(const MeshFilter& mesh, const MeshRenderer& renderer, std::span<const Matrix4x4> worlds, Camera& camera)
+{
+    PROFILE_SCOPE("Draw Instanced");
+    if (worlds.empty())
+    {
+        return;
+    }
+
+    m_State.Stats.BytesUploaded += worlds.size_bytes();
+    DrawInstances(mesh, renderer, (uint32_t)worlds.size(), camera);
+}
+
+void Null_GFX::Draw(const InstanceBatch& batch, Camera& camera)
+{
+    PROFILE_SCOPE("Draw InstanceBatch");
+    if (batch.GetGroups().empty())
+    {
+        return;
+    }
+
+    m_State.Stats.BytesUploaded += batch.GetInstances().size() * sizeof(Matrix4x4);
+
+    for (const auto& group : batch.GetGroups())
+    {
+        DrawInstances(*group.Mesh, *group.Renderer, group.InstanceCount, camera);
+    }
+}
+
+void Null_GFX::DrawInstances(const MeshFilter& mesh, const MeshRenderer& renderer, [[maybe_unused]] uint32_t instanceCount, Camera& camera)
+{
+    MeshRenderer instanced = renderer;
+    instanced.technique = (renderer.technique.empty() ? "main" : renderer.technique) + "Instanced";
+
+    BindMesh(m_State, mesh, renderer.shader);
+    BindInstanceBuffer(m_State, INSTANCE_BUFFER);
+
+    Matrix4x4 world;
+    SetShaderState(m_State, instanced, world, camera, true, true);
+
+    BindTopology(m_State, renderer.topology);
+    DrawMesh(m_State, mesh);
+}
+
+void Null_GFX::DrawMesh(NullState& state, const MeshFilter& mesh)
+{
+    if (!mesh.Indices.empty() || !mesh.Vertices.empty())
+    {
+        state.Stats.DrawCalls++;
+    }
+}
+
+/**
+ * \brief Retrieves a mesh's buffers, interleaving and "uploading" them if they aren't cached.
+ */
+Null_GFX::MeshBuffers Null_GFX::LoadMesh(NullState& state, const MeshFilter& mesh, EShaderType type)
+{
+    //The handle travels with the mesh, as it does for DX11_GFX
+    if (const MeshBuffers* cached = s_MeshBuffers.Get(mesh.Buffers))
+    {
+        return *cached;
+    }
+
+    MeshBuffers buffers = {};
+    VertexLayout::Interleave(mesh, type, m_Vertices);
+    state.Stats.BytesUploaded += m_Vertices.size() * sizeof(float);
+    buffers.VertexBuffer = s_NextBuffer++;
+
+    if (!mesh.Indices.empty())
+    {
+        state.Stats.BytesUploaded += mesh.Indices.size() * sizeof(uint32_t);
+        buffers.IndexBuffer = s_NextBuffer++;
+    }
+
+    mesh.Buffers = s_MeshBuffers.Add(buffers);
+    return buffers;
+}
+
+void Null_GFX::BindMesh(NullState& state, const MeshFilter& mesh, EShaderType type)
+{
+    const MeshBuffers buffers = LoadMesh(state, mesh, type);
+
+    BindVertexBuffer(state, buffers.VertexBuffer, VertexLayout::GetVertexSize(type) * sizeof(float));
+    if (buffers.IndexBuffer != 0)
+    {
+        BindIndexBuffer(state, buffers.IndexBuffer);
+    }
+}
+
+void Null_GFX::BindVertexBuffer(NullState& state, uint32_t buffer, uint32_t stride)
+{
+    if (state.VertexBuffer == buffer && state.VertexStride == stride)
+    {
+        state.Stats.SkippedBinds++;
+        return;
+    }
+
+    state.VertexBuffer = buffer;
+    state.VertexStride = stride;
+    state.Stats.Binds++;
+}
+
+void Null_GFX::BindIndexBuffer(NullState& state, uint32_t buffer)
+{
+    if (state.IndexBuffer == buffer)
+    {
+        state.Stats.SkippedBinds++;
+        return;
+    }
+
+    state.IndexBuffer = buffer;
+    state.Stats.Binds++;
+}
+
+void Null_GFX::BindInstanceBuffer(NullState& state, uint32_t buffer)
+{
+    if (state.InstanceBuffer == buffer)
+    {
+        state.Stats.SkippedBinds++;
+        return;
+    }
+
+    state.InstanceBuffer = buffer;
+    state.Stats.Binds++;
+}
+
+void Null_GFX::BindTopology(NullState& state, EPrimitiveTopology topology)
+{
+    if (state.Topology == (uint32_t)topology)
+    {
+        state.Stats.SkippedBinds++;
+        return;
+    }
+
+    state.Topology = (uint32_t)topology;
+    state.Stats.Binds++;
+}
+
+void Null_GFX::BindTexture(NullState& state, EShaderType type, uint32_t slot, const ResourceID& texture)
+{
+    if (texture.IsNull())
+    {
+        return;
+    }
+
+    auto& bound = state.Textures[((uint32_t)type << 8) | slot];
+    if (bound == texture)
+    {
+        state.Stats.SkippedBinds++;
+        return;
+    }
+
+    bound = texture;
+    state.PassDirty = true;
+    state.Stats.Binds++;
+}
+
+/**
+ * \brief Tracks the pass, input layout and variables a device backend would set, mirroring DX11_GFX.
+ */
+void Null_GFX::SetShaderState(NullState& state, const MeshRenderer& renderer, const Matrix4x4& world, Camera& camera, bool materialChanged, bool instanced)
+{
+    PROFILE_SCOPE("SetShaderState");
+    if (state.Shader != (uint32_t)renderer.shader || state.Technique != renderer.technique)
+    {
+        state.Shader = (uint32_t)renderer.shader;
+        state.Technique = renderer.technique;
+        state.PassDirty = true;
+        state.Material = nullptr;
+        state.ObjectSet = false;
+        state.Stats.Binds++;
+    }
+    else
+    {
+        state.Stats.SkippedBinds++;
+    }
+
+    if (materialChanged)
+    {
+        const uint32_t layout = ((uint32_t)renderer.shader << 1) | (instanced ? 1 : 0);
+        if (state.InputLayout == layout)
+        {
+            state.Stats.SkippedBinds++;
+        }
+        else
+        {
+            state.InputLayout = layout;
+            state.Stats.Binds++;
+        }
+    }
+
+    //Per-object variables, unless they're unchanged from the last object
+    const Matrix4x4 worldViewProj = renderer.shader == EShaderType::SpriteRenderer ? Engine::Math::MatrixMultiply(world, camera.orthoProjMatrix) : Engine::Math::MatrixMultiply(world, Engine::Math::MatrixMultiply(camera.viewMatrix, camera.projMatrix));
+    if (!state.ObjectSet || memcmp(&state.World, &world, sizeof(Matrix4x4)) != 0 || memcmp(&state.WorldViewProjection, &worldViewProj, sizeof(Matrix4x4)) != 0)
+    {
+        state.ObjectSet = true;
+        state.World = world;
+        state.WorldViewProjection = worldViewProj;
+        state.PassDirty = true;
+        state.Stats.Binds++;
+    }
+    else
+    {
+        state.Stats.SkippedBinds++;
+    }
+
+    //Material variables
+    if (materialChanged)
+    {
+        switch (renderer.shader)
+        {
+            using enum EShaderType;
+        case(Basic):
+            state.PassDirty = true;     //Colour
+            break;
+        case(Blinn):
+            state.PassDirty = true;     //Colours and lighting
+            BindTexture(state, renderer.shader, 0, ((Engine::Blinn*)renderer.material)->DiffuseMap);
+            BindTexture(state, renderer.shader, 1, ((Engine::Blinn*)renderer.material)->NormalMap);
+            BindTexture(state, renderer.shader, 2, ((Engine::Blinn*)renderer.material)->SpecularMap);
+            break;
+        case SpriteRenderer:
+            BindTexture(state, renderer.shader, 0, ((Engine::SpriteRenderer*)renderer.material)->TextureAtlas);
+            break;
+        default:
+            break;
+        }
+
+        state.Material = renderer.material;
+    }
+
+    //Apply the pass
+    if (state.PassDirty)
+    {
+        state.PassDirty = false;
+        state.Stats.Binds++;
+    }
+    else
+    {
+        state.Stats.SkippedBinds++;
+    }
+}
@@ -0,0 +1,194 @@
+#include "../inc/Core/Profiler.h"
+#include "../inc/IO/Logger.h"
+#include <algorithm>
+#include <mutex>
+
+using namespace Engine;
+
+static constexpr uint32_t ROOT = UINT32_MAX;
+
+/**
+ * \brief A zone at one position in the tree. Nodes are never removed, so that open zones can refer to them by index.
+ */
+struct ZoneNode
+{
+    const Profiler::Zone* Zone;
+    uint32_t Depth;
+    std::vector<uint32_t> Children;
+
+    //Accumulated this frame
+    uint32_t Calls;
+    uint64_t Inclusive;
+    uint64_t Exclusive;
+};
+
+struct OpenZone
+{
+    uint32_t Node;
+    uint64_t Begin;
+    uint64_t Children;      //Ticks spent in child zones
+};
+
+/**
+ * \brief A thread's buffer, and the zones it has open. Buffers outlive their threads until they've been drained.
+ */
+struct ThreadState
+{
+    std::shared_ptr<Profiler::ThreadBuffer> Buffer;
+    std::vector<OpenZone> Stack;
+};
+
+struct ProfilerState
+{
+    std::mutex Mutex;
+    std::vector<ThreadState> Threads;
+    std::vector<ZoneNode> Nodes;
+    std::vector<uint32_t> Roots;
+    std::vector<Profiler::ZoneStats> Frame;
+
+    //The tick rate is measured against the steady clock, over the whole run
+    const uint64_t StartTicks = Profiler::ReadTicks();
+    const std::chrono::steady_clock::time_point StartTime = std::chrono::steady_clock::now();
+};
+
+static ProfilerState& GetState()
+{
+    static ProfilerState state;
+    return state;
+}
+
+static thread_local std::shared_ptr<Profiler::ThreadBuffer> OwnedBuffer;
+
+Profiler::ThreadBuffer* Engine::Profiler::RegisterThread()
+{
+    OwnedBuffer = std::make_shared<ThreadBuffer>();
+    LocalBuffer = OwnedBuffer.get();
+
+    ProfilerState& state = GetState();
+    std::lock_guard<std::mutex> lock(state.Mutex);
+    state.Threads.push_back({ OwnedBuffer, {} });
+    return LocalBuffer;
+}
+
+void Engine::Profiler::SetEnabled(bool enabled)
+{
+    Enabled.store(enabled, std::memory_order_relaxed);
+}
+
+/**
+ * \brief Finds a zone's node beneath a parent, creating it on first use.
+ */
+static uint32_t FindNode(ProfilerState& state, uint32_t parent, const Profiler::Zone* zone)
+{
+    std::vector<uint32_t>& siblings = parent == ROOT ? state.Roots : state.Nodes[parent].Children;
+    for (uint32_t node : siblings)
+    {
+        if (state.Nodes[node].Zone == zone)
+        {
+            return node;
+        }
+    }
+
+    const uint32_t node = (uint32_t)state.Nodes.size();
+    state.Nodes.push_back({ zone, parent == ROOT ? 0 : state.Nodes[parent].Depth + 1, {}, 0, 0, 0 });
+
+    //The parent's reference may have been invalidated by the push
+    (parent == ROOT ? state.Roots : state.Nodes[parent].Children).push_back(node);
+    return node;
+}
+
+/**
+ * \brief Appends a node and its descendants which were used this frame, depth first.
+ * Nodes which are still open are kept if any of their descendants ended this frame.
+ */
+static void AppendStats(const ProfilerState& state, uint32_t node, double millisecondsPerTick, std::vector<Profiler::ZoneStats>& stats)
+{
+    const ZoneNode& zone = state.Nodes[node];
+    const size_t position = stats.size();
+
+    stats.push_back({ zone.Zone->Name, zone.Depth, zone.Calls, zone.Inclusive * millisecondsPerTick, zone.Exclusive * millisecondsPerTick });
+    for (uint32_t child : zone.Children)
+    {
+        AppendStats(state, child, millisecondsPerTick, stats);
+    }
+
+    if (zone.Calls == 0 && stats.size() == position + 1)
+    {
+        stats.pop_back();
+    }
+}
+
+void Engine::Profiler::EndFrame()
+{
+    ProfilerState& state = GetState();
+    std::lock_guard<std::mutex> lock(state.Mutex);
+
+    for (auto& node : state.Nodes)
+    {
+        node.Calls = 0;
+        node.Inclusive = 0;
+        node.Exclusive = 0;
+    }
+
+    for (auto& thread : state.Threads)
+    {
+        ThreadBuffer& buffer = *thread.Buffer;
+        const uint64_t write = buffer.m_Write.load(std::memory_order_acquire);
+        uint64_t read = buffer.m_Read.load(std::memory_order_relaxed);
+
+        for (; read < write; read++)
+        {
+            const ThreadBuffer::Event& event = buffer.m_Events[read & (ThreadBuffer::CAPACITY - 1)];
+            if (event.Opened != nullptr)
+            {
+                const uint32_t parent = thread.Stack.empty() ? ROOT : thread.Stack.back().Node;
+                thread.Stack.push_back({ FindNode(state, parent, event.Opened), event.Ticks, 0 });
+                continue;
+            }
+
+            const OpenZone open = thread.Stack.back();
+            thread.Stack.pop_back();
+
+            const uint64_t duration = event.Ticks - open.Begin;
+            ZoneNode& node = state.Nodes[open.Node];
+            node.Calls++;
+            node.Inclusive += duration;
+            node.Exclusive += duration - std::min(open.Children, duration);
+
+            if (!thread.Stack.empty())
+            {
+                thread.Stack.back().Children += duration;
+            }
+        }
+
+        buffer.m_Read.store(read, std::memory_order_release);
+    }
+
+    //Threads which have exited hold the last reference to their buffer, which has now been drained
+    std::erase_if(state.Threads, [](const ThreadState& thread) { return thread.Buffer.use_count() == 1; });
+
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - state.StartTime).count();
+    const uint64_t ticks = ReadTicks() - state.StartTicks;
+    const double millisecondsPerTick = ticks != 0 ? seconds * 1000.0 / (double)ticks : 0.0;
+
+    state.Frame.clear();
+    for (uint32_t root : state.Roots)
+    {
+        AppendStats(state, root, millisecondsPerTick, state.Frame);
+    }
+}
+
+std::vector<Profiler::ZoneStats> Engine::Profiler::GetFrameStats()
+{
+    ProfilerState& state = GetState();
+    std::lock_guard<std::mutex> lock(state.Mutex);
+    return state.Frame;
+}
+
+void Engine::Profiler::LogFrame()
+{
+    for (const auto& zone : GetFrameStats())
+    {
+        LOG_INFO("%*s%s: %.3fms (%.3fms exclusive, %u calls)\n", zone.Depth * 2, "", zone.Name, zone.Inclusive, zone.Exclusive, zone.Calls);
+    }
+}
@@ -0,0 +1,206 @@
+#include "../inc/Graphics/RenderQueue.h"
+#include <algorithm>
+#include <cstring>
+
+using namespace Engine;
+
+/**
+ * \brief Quantizes a depth to DEPTH_BITS, preserving its order.
+ */
+static uint64_t QuantizeDepth(float depth)
+{
+    //Also catches NaN
+    if (!(depth > 0.0f))
+    {
+        return 0;
+    }
+
+    //Positive floats order the same as their bit patterns, so the top bits can be used directly
+    uint32_t bits;
+    memcpy(&bits, &depth, sizeof(bits));
+    return bits >> (31 - RenderQueue::DEPTH_BITS);
+}
+
+void Engine::RenderQueue::Begin(const Vector3f& viewPosition, const Vector3f& viewForward)
+{
+    m_Commands.clear();
+    m_Sorted.clear();
+    m_MaterialIDs.clear();
+
+    m_ViewPosition = viewPosition;
+    m_ViewForward = viewForward;
+}
+
+void Engine::RenderQueue::Submit(const Matrix4x4& world, const MeshFilter& mesh, const MeshRenderer& renderer, ERenderLayer layer)
+{
+    RenderCommand command;
+    command.Mesh = &mesh;
+    command.Renderer = &renderer;
+    command.Material = GetMaterialID(renderer.material);
+    command.Technique = GetTechniqueID(renderer.technique);
+    command.World = world;
+
+    //Sort by the distance of the mesh's origin along the view direction
+    const Vector3f origin = { world._matrix._41, world._matrix._42, world._matrix._43 };
+    const float depth = Math::Dot(origin - m_ViewPosition, m_ViewForward);
+
+    command.Key = MakeKey(layer, renderer.shader, command.Technique, command.Material, depth, (uint32_t)m_Commands.size());
+    m_Commands.push_back(command);
+}
+
+void Engine::RenderQueue::End()
+{
+    Sort();
+
+    m_Sorted.resize(m_Commands.size());
+    for (size_t i = 0; i < m_Entries.size(); i++)
+    {
+        m_Sorted[i] = m_Commands[m_Entries[i].Command];
+    }
+}
+
+void Engine::RenderQueue::Partition(uint32_t maxRanges, uint32_t minCommands, std::vector<CommandRange>& ranges) const
+{
+    ranges.clear();
+
+    const uint32_t count = (uint32_t)m_Sorted.size();
+    if (count == 0 || maxRanges == 0)
+    {
+        return;
+    }
+
+    const uint32_t rangeCount = std::clamp(count / std::max(minCommands, 1u), 1u, maxRanges);
+
+    //Boundaries may move up to a quarter of a range forward to land on a state change
+    const uint32_t slack = count / rangeCount / 4;
+
+    auto _stateChanges = [&](uint32_t i)
+    {
+        const RenderCommand& a = m_Sorted[i - 1];
+        const RenderCommand& b = m_Sorted[i];
+        return a.Renderer->shader != b.Renderer->shader || a.Technique != b.Technique || a.Material != b.Material;
+    };
+
+    uint32_t first = 0;
+    for (uint32_t i = 1; i < rangeCount; i++)
+    {
+        const uint32_t target = (uint32_t)((uint64_t)count * i / rangeCount);
+        const uint32_t limit = std::min(target + slack, count - 1);
+
+        uint32_t boundary = target;
+        for (uint32_t b = target; b <= limit; b++)
+        {
+            if (_stateChanges(b))
+            {
+                boundary = b;
+                break;
+            }
+        }
+
+        if (boundary > first)
+        {
+            ranges.push_back({ first, boundary - first });
+            first = boundary;
+        }
+    }
+
+    ranges.push_back({ first, count - first });
+}
+
+uint64_t Engine::RenderQueue::MakeKey(ERenderLayer layer, EShaderType shader, uint32_t technique, uint32_t material, float depth, uint32_t sequence)
+{
+    //IDs which overflow their field share a key with others. Replay compares the command's own state, so this only costs sorting quality.
+    const uint64_t layerBits = (uint64_t)layer & ((1ull << LAYER_BITS) - 1);
+    const uint64_t shaderBits = (uint64_t)shader & ((1ull << SHADER_BITS) - 1);
+    const uint64_t techniqueBits = technique & ((1ull << TECHNIQUE_BITS) - 1);
+    const uint64_t materialBits = material & ((1ull << MATERIAL_BITS) - 1);
+    const uint64_t depthBits = QuantizeDepth(depth);
+
+    uint64_t key = layerBits << (64 - LAYER_BITS);
+
+    switch (layer)
+    {
+    case ERenderLayer::Opaque:
+        //State-major, so that each shader and material is bound once. Front-to-back within each, to reduce overdraw.
+        key |= shaderBits << (TECHNIQUE_BITS + MATERIAL_BITS + DEPTH_BITS);
+        key |= techniqueBits << (MATERIAL_BITS + DEPTH_BITS);
+        key |= materialBits << DEPTH_BITS;
+        key |= depthBits;
+        break;
+
+    case ERenderLayer::Transparent:
+        //Back-to-front, for correct blending
+        key |= (~depthBits & ((1ull << DEPTH_BITS) - 1)) << (SHADER_BITS + TECHNIQUE_BITS + MATERIAL_BITS);
+        key |= shaderBits << (TECHNIQUE_BITS + MATERIAL_BITS);
+        key |= techniqueBits << MATERIAL_BITS;
+        key |= materialBits;
+        break;
+
+    case ERenderLayer::Overlay:
+        key |= sequence;
+        break;
+    }
+
+    return key;
+}
+
+void Engine::RenderQueue::Sort()
+{
+    const size_t count = m_Commands.size();
+
+    m_Entries.resize(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        m_Entries[i] = { m_Commands[i].Key, (uint32_t)i };
+    }
+
+    //Stable LSD radix sort with 8-bit digits
+    m_SortScratch.resize(count);
+    for (uint32_t shift = 0; shift < 64; shift += 8)
+    {
+        uint32_t histogram[257] = {};
+        for (const auto& entry : m_Entries)
+        {
+            histogram[((entry.Key >> shift) & 0xff) + 1]++;
+        }
+
+        //Skip digits which every key shares. Most are, as a frame rarely fills every field.
+        const uint32_t digit = (m_Entries.empty() ? 0 : (m_Entries[0].Key >> shift) & 0xff);
+        if (histogram[digit + 1] == count)
+        {
+            continue;
+        }
+
+        for (uint32_t i = 1; i < 257; i++)
+        {
+            histogram[i] += histogram[i - 1];
+        }
+        for (const auto& entry : m_Entries)
+        {
+            m_SortScratch[histogram[(entry.Key >> shift) & 0xff]++] = entry;
+        }
+        m_Entries.swap(m_SortScratch);
+    }
+}
+
+uint32_t Engine::RenderQueue::GetMaterialID(const MaterialData* material)
+{
+    auto it = m_MaterialIDs.find(material);
+    if (it == m_MaterialIDs.end())
+    {
+        it = m_MaterialIDs.emplace(material, (uint32_t)m_MaterialIDs.size()).first;
+    }
+
+    return it->second;
+}
+
+uint32_t Engine::RenderQueue::GetTechniqueID(const std::basic_string<char>& technique)
+{
+    auto it = m_TechniqueIDs.find(technique);
+    if (it == m_TechniqueIDs.end())
+    {
+        it = m_TechniqueIDs.emplace(technique, (uint32_t)m_TechniqueIDs.size()).first;
+    }
+
+    return it->second;
+}
@@ -0,0 +1,57 @@
+#define LOG_CATEGORY ResourcePool
+#include "../inc/IO/ResourceID.h"
+#include "../inc/IO/Archive.h"
+#include "../inc/IO/Logger.h"
+#include "../inc/IO/TypeConversion.h"
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+
+using namespace Engine;
+
+//Interned paths are never removed, so references to them remain valid
+static std::unordered_map<uint64_t, std::basic_string<wchar_t>> Paths;
+static std::shared_mutex PathMutex;
+static const std::basic_string<wchar_t> EmptyPath;
+
+Engine::ResourceID::ResourceID(std::wstring_view path)
+{
+    if (path.empty())
+    {
+        return;
+    }
+
+    std::basic_string<wchar_t> rPath;
+    //Convert the path to a relative path, whichever separators it uses
+    if (Archive::NormalizePath(path).starts_with("resources\\") == false) {
+        rPath = L"Resources\\";
+    }
+    rPath.append(path);
+
+    m_Hash = Archive::HashPath(rPath);
+
+    {
+        std::shared_lock lock(PathMutex);
+        auto it = Paths.find(m_Hash);
+        if (it != Paths.end())
+        {
+            //Paths which only differ by case or separators normalize to the same resource
+            ERR(Archive::NormalizePath(it->second) != Archive::NormalizePath(rPath), ("Resource path hash collision: " + WStringToString(rPath)).c_str());
+            return;
+        }
+    }
+
+    std::unique_lock lock(PathMutex);
+    Paths.try_emplace(m_Hash, std::move(rPath));
+}
+
+const std::basic_string<wchar_t>& Engine::ResourceID::GetPath() const
+{
+    if (m_Hash == 0)
+    {
+        return EmptyPath;
+    }
+
+    std::shared_lock lock(PathMutex);
+    return Paths.at(m_Hash);
+}
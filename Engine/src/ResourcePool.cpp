@@ -1,4 +1,10 @@
+#define LOG_CATEGORY ResourcePool
 #include "../inc/IO/ResourcePool.h"
+#include <algorithm>
+#include <atomic>
+#include <future>
+#include <mutex>
+#include <shared_mutex>
 
 using namespace Engine;
 using namespace ResourcePool;
@@ -8,21 +14,269 @@ static std::unordered_map<EShaderType, std::basic_string<wchar_t>> ShaderPaths =
     {EShaderType::Blinn, L"Resources\\Shaders\\FX\\Blinn"},
     {EShaderType::SpriteRenderer, L"Resources\\Shaders\\FX\\Sprite"}
 };
-static std::unordered_map<EShaderType, shader> Shaders;
 static std::unordered_map<EShaderType, inputLayout> InputLayouts;
-static std::unordered_map<std::basic_string<wchar_t>, texture> Textures;
-static std::unordered_map<uintptr_t, vBuffer> VertexBuffers;
-static std::unordered_map<uintptr_t, iBuffer> IndexBuffers;
+static std::mutex InputLayoutMutex;
 
-static uint32_t nextVBufferID;
-static uint32_t nextIBufferID;
+struct TextureEntry
+{
+    texture Texture;
+    ResourceID ID;
+    uint64_t Bytes = 0;
+    uint64_t LastUsed = 0;      //The frame the texture was last resolved in
+};
+
+struct MeshEntry
+{
+    vBuffer VertexBuffer;
+    iBuffer IndexBuffer;
+    uint64_t VertexBytes = 0;
+    uint64_t IndexBytes = 0;
+    uint64_t LastUsed = 0;
+};
+
+static SlotMap<shader, ShaderTag> Shaders;
+static SlotMap<TextureEntry, TextureTag> Textures;
+static SlotMap<MeshEntry, MeshTag> Meshes;
+
+//Lookups by name, for resolving handles the first time
+static std::unordered_map<EShaderType, ShaderHandle> ShaderHandles;
+static std::unordered_map<ResourceID, TextureHandle> TextureHandles;
+
+//Resources being loaded, which other threads requesting them wait on
+static std::unordered_map<EShaderType, std::shared_future<ShaderHandle>> PendingShaders;
+static std::unordered_map<ResourceID, std::shared_future<TextureHandle>> PendingTextures;
+
+/**
+ * \brief A reader-writer lock split into shards, with each thread reading through its own.
+ * A single shared_mutex still has every reader increment the same counter, so threads resolving handles
+ * while recording contend on its cache line. Readers here only touch their own shard, while writers take
+ * every shard. Adding and removing resources costs more, but is rare next to resolving them.
+ */
+class ShardedMutex
+{
+public:
+    static constexpr uint32_t SHARD_COUNT = 16;
+
+    void lock()
+    {
+        for (auto& shard : m_Shards)
+        {
+            shard.Mutex.lock();
+        }
+    }
+
+    bool try_lock()
+    {
+        for (uint32_t i = 0; i < SHARD_COUNT; i++)
+        {
+            if (!m_Shards[i].Mutex.try_lock())
+            {
+                while (i > 0)
+                {
+                    m_Shards[--i].Mutex.unlock();
+                }
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void unlock()
+    {
+        for (uint32_t i = SHARD_COUNT; i > 0; i--)
+        {
+            m_Shards[i - 1].Mutex.unlock();
+        }
+    }
+
+    void lock_shared()
+    {
+        m_Shards[GetShard()].Mutex.lock_shared();
+    }
+
+    void unlock_shared()
+    {
+        m_Shards[GetShard()].Mutex.unlock_shared();
+    }
+
+private:
+    /**
+     * \brief Threads are assigned shards in the order they first read, so up to SHARD_COUNT readers never share one.
+     */
+    static uint32_t GetShard()
+    {
+        static std::atomic<uint32_t> s_NextShard = 0;
+        thread_local const uint32_t shard = s_NextShard.fetch_add(1, std::memory_order_relaxed) % SHARD_COUNT;
+        return shard;
+    }
+
+    //Each shard has its own cache line, so that readers on different shards don't share one
+    struct alignas(64) Shard
+    {
+        std::shared_mutex Mutex;
+    };
+    Shard m_Shards[SHARD_COUNT];
+};
+
+//Each pool has its own lock, so resolving one kind of resource doesn't wait on another being added.
+//Lookups only take shared locks, on their thread's shard, so they never wait on or contend with each other.
+static ShardedMutex ShaderMutex;
+static ShardedMutex TextureMutex;
+static ShardedMutex MeshMutex;
+
+//Residency
+static std::atomic<uint64_t> MemoryUsage[(size_t)EResourceCategory::COUNT] = {};
+static std::atomic<uint64_t> MemoryBudget = 0;
+static std::atomic<uint32_t> EvictionAge = 1;
+static std::atomic<uint64_t> Frame = 1;
+static bool OverBudget = false;
+
+/**
+ * \brief Marks a resource as used this frame.
+ * Resources are resolved while recording on multiple threads, which all store the same frame. The frame is
+ * only stored the first time, so that resolving a resource many times doesn't write to its entry each time.
+ */
+static void Touch(uint64_t& lastUsed)
+{
+    std::atomic_ref<uint64_t> used(lastUsed);
+    const uint64_t frame = Frame.load(std::memory_order_relaxed);
+    if (used.load(std::memory_order_relaxed) != frame)
+    {
+        used.store(frame, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * \brief The size of a format's pixels, or of its 4x4 blocks for block compressed formats.
+ * \param blockCompressed Set if the format is block compressed.
+ */
+static uint32_t GetFormatSize(DXGI_FORMAT format, bool& blockCompressed)
+{
+    blockCompressed = false;
+
+    switch (format)
+    {
+    case DXGI_FORMAT_BC1_TYPELESS: case DXGI_FORMAT_BC1_UNORM: case DXGI_FORMAT_BC1_UNORM_SRGB:
+    case DXGI_FORMAT_BC4_TYPELESS: case DXGI_FORMAT_BC4_UNORM: case DXGI_FORMAT_BC4_SNORM:
+        blockCompressed = true;
+        return 8;
+    case DXGI_FORMAT_BC2_TYPELESS: case DXGI_FORMAT_BC2_UNORM: case DXGI_FORMAT_BC2_UNORM_SRGB:
+    case DXGI_FORMAT_BC3_TYPELESS: case DXGI_FORMAT_BC3_UNORM: case DXGI_FORMAT_BC3_UNORM_SRGB:
+    case DXGI_FORMAT_BC5_TYPELESS: case DXGI_FORMAT_BC5_UNORM: case DXGI_FORMAT_BC5_SNORM:
+    case DXGI_FORMAT_BC6H_TYPELESS: case DXGI_FORMAT_BC6H_UF16: case DXGI_FORMAT_BC6H_SF16:
+    case DXGI_FORMAT_BC7_TYPELESS: case DXGI_FORMAT_BC7_UNORM: case DXGI_FORMAT_BC7_UNORM_SRGB:
+        blockCompressed = true;
+        return 16;
+    case DXGI_FORMAT_R32G32B32A32_TYPELESS: case DXGI_FORMAT_R32G32B32A32_FLOAT: case DXGI_FORMAT_R32G32B32A32_UINT: case DXGI_FORMAT_R32G32B32A32_SINT:
+        return 16;
+    case DXGI_FORMAT_R32G32B32_TYPELESS: case DXGI_FORMAT_R32G32B32_FLOAT: case DXGI_FORMAT_R32G32B32_UINT: case DXGI_FORMAT_R32G32B32_SINT:
+        return 12;
+    case DXGI_FORMAT_R16G16B16A16_TYPELESS: case DXGI_FORMAT_R16G16B16A16_FLOAT: case DXGI_FORMAT_R16G16B16A16_UNORM:
+    case DXGI_FORMAT_R16G16B16A16_UINT: case DXGI_FORMAT_R16G16B16A16_SNORM: case DXGI_FORMAT_R16G16B16A16_SINT:
+    case DXGI_FORMAT_R32G32_TYPELESS: case DXGI_FORMAT_R32G32_FLOAT: case DXGI_FORMAT_R32G32_UINT: case DXGI_FORMAT_R32G32_SINT:
+        return 8;
+    case DXGI_FORMAT_R8G8_TYPELESS: case DXGI_FORMAT_R8G8_UNORM: case DXGI_FORMAT_R8G8_UINT: case DXGI_FORMAT_R8G8_SNORM: case DXGI_FORMAT_R8G8_SINT:
+    case DXGI_FORMAT_R16_TYPELESS: case DXGI_FORMAT_R16_FLOAT: case DXGI_FORMAT_R16_UNORM: case DXGI_FORMAT_R16_UINT: case DXGI_FORMAT_R16_SNORM: case DXGI_FORMAT_R16_SINT:
+    case DXGI_FORMAT_B5G6R5_UNORM: case DXGI_FORMAT_B5G5R5A1_UNORM: case DXGI_FORMAT_B4G4R4A4_UNORM:
+        return 2;
+    case DXGI_FORMAT_R8_TYPELESS: case DXGI_FORMAT_R8_UNORM: case DXGI_FORMAT_R8_UINT: case DXGI_FORMAT_R8_SNORM: case DXGI_FORMAT_R8_SINT: case DXGI_FORMAT_A8_UNORM:
+        return 1;
+    default:
+        //Most remaining formats, including the common 8-bit RGBA formats, are 32 bits per pixel
+        return 4;
+    }
+}
+
+/**
+ * \brief Computes the memory a texture occupies, including its mips and array slices.
+ */
+static uint64_t GetTextureBytes(ID3D11ShaderResourceView* view)
+{
+    Microsoft::WRL::ComPtr<ID3D11Resource> resource;
+    view->GetResource(resource.GetAddressOf());
+
+    Microsoft::WRL::ComPtr<ID3D11Texture2D> texture2D;
+    if (FAILED(resource.As(&texture2D)))
+    {
+        return 0;
+    }
+
+    D3D11_TEXTURE2D_DESC desc = {};
+    texture2D->GetDesc(&desc);
+
+    bool blockCompressed;
+    const uint64_t formatSize = GetFormatSize(desc.Format, blockCompressed);
+
+    uint64_t bytes = 0;
+    for (UINT mip = 0; mip < desc.MipLevels; mip++)
+    {
+        uint64_t width = std::max(desc.Width >> mip, 1u);
+        uint64_t height = std::max(desc.Height >> mip, 1u);
+        if (blockCompressed)
+        {
+            width = (width + 3) / 4;
+            height = (height + 3) / 4;
+        }
+        bytes += width * height * formatSize;
+    }
+
+    return bytes * desc.ArraySize;
+}
+
+static uint64_t GetBufferBytes(ID3D11Buffer* buffer)
+{
+    if (buffer == nullptr)
+    {
+        return 0;
+    }
+
+    D3D11_BUFFER_DESC desc = {};
+    buffer->GetDesc(&desc);
+    return desc.ByteWidth;
+}
+
+static uint64_t GetTotalMemoryUsage()
+{
+    uint64_t total = 0;
+    for (const auto& usage : MemoryUsage)
+    {
+        total += usage;
+    }
+    return total;
+}
 
-void ResourcePool::Init()
+void ResourcePool::Init(const std::basic_string<char>& packPath)
 {
+    if (!packPath.empty())
+    {
+        WARN(!Archive::Mount(packPath), "Resource pack could not be mounted. Falling back to loose files.");
+    }
 }
 
 void ResourcePool::Shutdown()
 {
+    {
+        std::scoped_lock lock(ShaderMutex, TextureMutex, MeshMutex, InputLayoutMutex);
+        Meshes.Clear();
+        Textures.Clear();
+        Shaders.Clear();
+        TextureHandles.clear();
+        ShaderHandles.clear();
+        InputLayouts.clear();
+
+        for (auto& usage : MemoryUsage)
+        {
+            usage = 0;
+        }
+        OverBudget = false;
+    }
+
+    Archive::UnmountAll();
+}
+
+std::span<const uint8_t> ResourcePool::GetPackedData(const std::basic_string<wchar_t>& path)
+{
+    return Archive::Find(path);
 }
 
 std::basic_string<wchar_t> ResourcePool::GetShaderPath(EShaderType type)
@@ -36,86 +290,368 @@ std::basic_string<wchar_t> ResourcePool::GetShaderPath(EShaderType type)
      return ShaderPaths.at(type) + L".cso";
 }
 
+ bool ResourcePool::GetShaderType(const std::basic_string<wchar_t>& path, EShaderType& type)
+{
+     const std::basic_string<char> normalized = Archive::NormalizePath(path);
+     for (const auto& [shaderType, shaderPath] : ShaderPaths)
+     {
+         const std::basic_string<char> base = Archive::NormalizePath(shaderPath);
+         if (normalized == base + ".fx" || normalized == base + ".cso")
+         {
+             type = shaderType;
+             return true;
+         }
+     }
+     return false;
+}
+
+
+ ShaderHandle ResourcePool::FindShader(EShaderType type)
+{
+    std::shared_lock lock(ShaderMutex);
+    auto it = ShaderHandles.find(type);
+    return it != ShaderHandles.end() ? it->second : ShaderHandle{};
+}
+
+ ResourcePool::shader ResourcePool::GetShader(ShaderHandle handle)
+{
+     std::shared_lock lock(ShaderMutex);
+     const shader* effect = Shaders.Get(handle);
+     return effect != nullptr ? *effect : nullptr;
+}
+
+ ShaderHandle ResourcePool::AddShader(shader shader, EShaderType type)
+{
+     std::unique_lock lock(ShaderMutex);
+     ShaderHandle& handle = ShaderHandles[type];
+     Shaders.Remove(handle);
+     handle = Shaders.Add(shader);
+     return handle;
+}
 
- shader ResourcePool::GetShader(EShaderType type)
+ bool ResourcePool::ReplaceShader(EShaderType type, shader shader)
 {
-    if(!Shaders.contains(type))
+     std::unique_lock lock(ShaderMutex);
+     auto it = ShaderHandles.find(type);
+     ResourcePool::shader* entry = it != ShaderHandles.end() ? Shaders.Get(it->second) : nullptr;
+     if (entry == nullptr)
+     {
+         return false;
+     }
+
+     *entry = shader;
+     return true;
+}
+
+/**
+ * \brief Finds a resource, or loads it if no other thread is loading it already. Otherwise, waits for that thread.
+ * \param find Returns the resource's handle if it has been added. Called with the pool locked.
+ * \param load Loads the resource, and adds it to the pool. Called without the pool locked.
+ */
+template<typename HandleType, typename Key, typename Find, typename Load>
+static HandleType Acquire(ShardedMutex& mutex, std::unordered_map<Key, std::shared_future<HandleType>>& pending, const Key& key, Find&& find, Load&& load)
+{
+    {
+        std::shared_lock lock(mutex);
+        HandleType handle = find();
+        if (!handle.IsNull())
+        {
+            return handle;
+        }
+    }
+
+    std::promise<HandleType> promise;
+    std::shared_future<HandleType> loading;
+    {
+        //The resource may have been added while the lock was released
+        std::unique_lock lock(mutex);
+        HandleType handle = find();
+        if (!handle.IsNull())
+        {
+            return handle;
+        }
+
+        auto it = pending.find(key);
+        if (it != pending.end())
+        {
+            loading = it->second;
+        }
+        else
+        {
+            pending.emplace(key, promise.get_future().share());
+        }
+    }
+
+    if (loading.valid())
+    {
+        return loading.get();
+    }
+
+    HandleType handle = load();
     {
-        return (shader)0;
+        std::unique_lock lock(mutex);
+        pending.erase(key);
     }
-     return Shaders.at(type);
+    promise.set_value(handle);
+    return handle;
 }
 
- void ResourcePool::AddShader(shader shader, EShaderType type)
+ ShaderHandle ResourcePool::AcquireShader(EShaderType type, const std::function<shader()>& load)
 {
-     Shaders.emplace(type, shader);
+     auto find = [&]
+     {
+         auto it = ShaderHandles.find(type);
+         return it != ShaderHandles.end() ? it->second : ShaderHandle{};
+     };
+
+     return Acquire(ShaderMutex, PendingShaders, type, find, [&]
+     {
+         shader effect = load();
+         return effect != nullptr ? AddShader(effect, type) : ShaderHandle{};
+     });
 }
 
  inputLayout ResourcePool::GetInputLayout(EShaderType type)
  {
-     if (!InputLayouts.contains(type))
+     std::lock_guard<std::mutex> lock(InputLayoutMutex);
+     auto it = InputLayouts.find(type);
+     if (it == InputLayouts.end())
      {
          return (inputLayout)0;
      }
-     return InputLayouts.at(type);
+     return it->second;
  }
 
  void ResourcePool::AddInputLayout(inputLayout layout, EShaderType type)
  {
+     std::lock_guard<std::mutex> lock(InputLayoutMutex);
      InputLayouts.emplace(type, layout);
  }
 
 
- texture ResourcePool::GetTexture(std::basic_string<wchar_t> path)
+ TextureHandle ResourcePool::FindTexture(const ResourceID& id)
 {
-     if (!Textures.contains(path))
+     std::shared_lock lock(TextureMutex);
+     auto it = TextureHandles.find(id);
+     return it != TextureHandles.end() ? it->second : TextureHandle{};
+}
+
+ ResourcePool::texture ResourcePool::GetTexture(TextureHandle handle)
+{
+     std::shared_lock lock(TextureMutex);
+     TextureEntry* entry = Textures.Get(handle);
+     if (entry == nullptr)
      {
-         return (texture)0;
+         return nullptr;
      }
-     return Textures.at(path);
+
+     Touch(entry->LastUsed);
+     return entry->Texture;
 }
 
+/**
+ * \brief Removes a texture, and its lookup by ID. TextureMutex must be held exclusively.
+ */
+static bool RemoveTextureLocked(TextureHandle handle)
+{
+     const TextureEntry* entry = Textures.Get(handle);
+     if (entry == nullptr)
+     {
+         return false;
+     }
 
- void ResourcePool::AddTexture(texture tex, std::basic_string<wchar_t> path)
+     MemoryUsage[(size_t)EResourceCategory::Texture] -= entry->Bytes;
+     TextureHandles.erase(entry->ID);
+     return Textures.Remove(handle);
+}
+
+ TextureHandle ResourcePool::AddTexture(texture tex, const ResourceID& id)
 {
-     Textures.emplace(path, tex);
+     //Measure the texture before locking, as it queries the device
+     const uint64_t bytes = tex != nullptr ? GetTextureBytes(tex.Get()) : 0;
+
+     std::unique_lock lock(TextureMutex);
+
+     //Replaces any texture previously loaded for the resource
+     auto it = TextureHandles.find(id);
+     if (it != TextureHandles.end())
+     {
+         RemoveTextureLocked(it->second);
+     }
+
+     MemoryUsage[(size_t)EResourceCategory::Texture] += bytes;
+
+     TextureHandle handle = Textures.Add({ tex, id, bytes, Frame });
+     TextureHandles[id] = handle;
+     return handle;
 }
 
+ TextureHandle ResourcePool::AcquireTexture(const ResourceID& id, const std::function<texture()>& load)
+{
+     auto find = [&]
+     {
+         auto it = TextureHandles.find(id);
+         return it != TextureHandles.end() ? it->second : TextureHandle{};
+     };
 
+     return Acquire(TextureMutex, PendingTextures, id, find, [&]
+     {
+         texture tex = load();
+         return tex != nullptr ? AddTexture(tex, id) : TextureHandle{};
+     });
+}
 
- vBuffer ResourcePool::GetVertexBuffer(const Engine::MeshFilter* mesh)
+ bool ResourcePool::ReplaceTexture(const ResourceID& id, texture tex)
 {
-     ERR(mesh == nullptr, "Mesh is invalid.");
-     if (!VertexBuffers.contains((uintptr_t)mesh))
+     const uint64_t bytes = tex != nullptr ? GetTextureBytes(tex.Get()) : 0;
+
+     std::unique_lock lock(TextureMutex);
+     auto it = TextureHandles.find(id);
+     TextureEntry* entry = it != TextureHandles.end() ? Textures.Get(it->second) : nullptr;
+     if (entry == nullptr)
      {
-         return (vBuffer)0;
+         return false;
      }
-     return VertexBuffers.at((uintptr_t)mesh);
+
+     MemoryUsage[(size_t)EResourceCategory::Texture] -= entry->Bytes;
+     MemoryUsage[(size_t)EResourceCategory::Texture] += bytes;
+     entry->Texture = tex;
+     entry->Bytes = bytes;
+     return true;
 }
 
- void ResourcePool::AddVertexBuffer(vBuffer vertexBuffer, const Engine::MeshFilter* mesh)
+ bool ResourcePool::RemoveTexture(TextureHandle handle)
 {
-     ERR(mesh == nullptr, "Mesh is invalid.");
-     VertexBuffers.emplace((uintptr_t)mesh, vertexBuffer);
+     std::unique_lock lock(TextureMutex);
+     return RemoveTextureLocked(handle);
 }
 
 
+ ResourcePool::MeshBuffers ResourcePool::GetMesh(MeshHandle handle)
+{
+     std::shared_lock lock(MeshMutex);
+     MeshEntry* entry = Meshes.Get(handle);
+     if (entry == nullptr)
+     {
+         return {};
+     }
+
+     Touch(entry->LastUsed);
+     return { entry->VertexBuffer, entry->IndexBuffer };
+}
 
- iBuffer ResourcePool::GetIndexBuffer(const Engine::MeshFilter* mesh)
+ MeshHandle ResourcePool::AddMesh(vBuffer vertexBuffer, iBuffer indexBuffer)
 {
-     ERR(mesh == nullptr, "Mesh is invalid.");
-     if (!IndexBuffers.contains((uintptr_t)mesh))
+     ERR(vertexBuffer == nullptr, "Mesh requires a vertex buffer.");
+
+     const uint64_t vertexBytes = GetBufferBytes(vertexBuffer.Get());
+     const uint64_t indexBytes = GetBufferBytes(indexBuffer.Get());
+
+     std::unique_lock lock(MeshMutex);
+     MemoryUsage[(size_t)EResourceCategory::VertexBuffer] += vertexBytes;
+     MemoryUsage[(size_t)EResourceCategory::IndexBuffer] += indexBytes;
+
+     return Meshes.Add({ vertexBuffer, indexBuffer, vertexBytes, indexBytes, Frame });
+}
+
+/**
+ * \brief Removes a mesh. MeshMutex must be held exclusively.
+ */
+static bool RemoveMeshLocked(MeshHandle handle)
+{
+     const MeshEntry* entry = Meshes.Get(handle);
+     if (entry == nullptr)
      {
-         return (iBuffer)0;
+         return false;
      }
-     return IndexBuffers.at((uintptr_t)mesh);
+
+     MemoryUsage[(size_t)EResourceCategory::VertexBuffer] -= entry->VertexBytes;
+     MemoryUsage[(size_t)EResourceCategory::IndexBuffer] -= entry->IndexBytes;
+     return Meshes.Remove(handle);
+}
+
+ bool ResourcePool::RemoveMesh(MeshHandle handle)
+{
+     std::unique_lock lock(MeshMutex);
+     return RemoveMeshLocked(handle);
+}
+
+
+ void ResourcePool::SetMemoryBudget(uint64_t bytes)
+{
+     MemoryBudget = bytes;
 }
 
+ void ResourcePool::SetEvictionAge(uint32_t frames)
+{
+     EvictionAge = std::max(frames, 1u);
+}
 
- void ResourcePool::AddIndexBuffer(iBuffer indexBuffer, const Engine::MeshFilter* mesh)
+ uint64_t ResourcePool::GetMemoryUsage(EResourceCategory category)
 {
-     ERR(mesh == nullptr, "Mesh is invalid.");
-    IndexBuffers.emplace((uintptr_t)mesh, indexBuffer);
+     return MemoryUsage[(size_t)category];
 }
 
+ uint32_t ResourcePool::EndFrame()
+{
+     const uint64_t frame = Frame++;
+     const uint64_t budget = MemoryBudget;
+
+     uint64_t usage = GetTotalMemoryUsage();
+     if (budget == 0 || usage <= budget)
+     {
+         OverBudget = false;
+         return 0;
+     }
+
+     //Hold both pools, so that nothing can be resolved between choosing a resource and evicting it
+     std::scoped_lock lock(TextureMutex, MeshMutex);
+
+     //Gather the resources which have gone unused for long enough, oldest first
+     struct Candidate
+     {
+         uint64_t LastUsed;
+         uint64_t Bytes;
+         TextureHandle Texture;
+         MeshHandle Mesh;
+     };
+     std::vector<Candidate> candidates;
 
+     Textures.ForEach([&](TextureHandle handle, const TextureEntry& entry)
+     {
+         if (frame - entry.LastUsed >= EvictionAge)
+         {
+             candidates.push_back({ entry.LastUsed, entry.Bytes, handle, {} });
+         }
+     });
+     Meshes.ForEach([&](MeshHandle handle, const MeshEntry& entry)
+     {
+         if (frame - entry.LastUsed >= EvictionAge)
+         {
+             candidates.push_back({ entry.LastUsed, entry.VertexBytes + entry.IndexBytes, {}, handle });
+         }
+     });
+
+     std::sort(candidates.begin(), candidates.end(), [](const Candidate& a, const Candidate& b) { return a.LastUsed < b.LastUsed; });
+
+     uint32_t evicted = 0;
+     for (const Candidate& candidate : candidates)
+     {
+         if (usage <= budget)
+         {
+             break;
+         }
+
+         if (candidate.Texture.IsNull() ? RemoveMeshLocked(candidate.Mesh) : RemoveTextureLocked(candidate.Texture))
+         {
+             usage -= candidate.Bytes;
+             evicted++;
+         }
+     }
+
+     //Only warn when the pool first goes over budget, rather than every frame
+     WARN(usage > budget && !OverBudget, "Resource Pool is over budget, as its resources are still in use.");
+     OverBudget = usage > budget;
+
+     return evicted;
+}
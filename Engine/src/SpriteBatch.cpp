@@ -0,0 +1,188 @@
+#include "../inc/Graphics/SpriteBatch.h"
+#include <cstring>
+
+using namespace Engine;
+
+void Engine::SpriteBatch::Begin()
+{
+    m_Queued.clear();
+    m_Keys.clear();
+    m_Ranges.clear();
+    m_InOrder = true;
+}
+
+void Engine::SpriteBatch::Add(const Sprite& sprite)
+{
+    const Transform& t = sprite.transform;
+
+    //Rotated sprites go through the full world matrix
+    if (t.EulerRotation.x != 0.0f || t.EulerRotation.y != 0.0f || t.EulerRotation.z != 0.0f)
+    {
+        const Matrix4x4 world = Math::MatrixMultiply(Math::MatrixScaling(t.Scale), Math::MatrixMultiply(Math::MatrixRotation(t.EulerRotation), Math::MatrixTranslation(t.Position)));
+        Add(world, sprite);
+        return;
+    }
+
+    SpriteVertex* out = Queue(sprite);
+    for (uint32_t i = 0; i < 4; i++)
+    {
+        const Vector3f& v = sprite.m_Sprite.Vertices[i];
+        out[i].Position = { v.x * t.Scale.x + t.Position.x, v.y * t.Scale.y + t.Position.y, v.z * t.Scale.z + t.Position.z };
+        out[i].TexCoord = sprite.m_Sprite.TexCoords[i];
+    }
+}
+
+void Engine::SpriteBatch::Add(const Matrix4x4& world, const Sprite& sprite)
+{
+    const auto& m = world._matrix;
+
+    SpriteVertex* out = Queue(sprite);
+    for (uint32_t i = 0; i < 4; i++)
+    {
+        //Row vector * world
+        const Vector3f& v = sprite.m_Sprite.Vertices[i];
+        out[i].Position = {
+            v.x * m._11 + v.y * m._21 + v.z * m._31 + m._41,
+            v.x * m._12 + v.y * m._22 + v.z * m._32 + m._42,
+            v.x * m._13 + v.y * m._23 + v.z * m._33 + m._43
+        };
+        out[i].TexCoord = sprite.m_Sprite.TexCoords[i];
+    }
+}
+
+void Engine::SpriteBatch::End()
+{
+    const size_t count = m_Keys.size();
+
+    //Every sprite uses the same index pattern, so only newly used indices need writing
+    const size_t oldIndexCount = m_Indices.size();
+    m_Indices.resize(count * 6);
+    for (size_t i = oldIndexCount / 6; i < count; i++)
+    {
+        const uint32_t base = (uint32_t)i * 4;
+        uint32_t* index = &m_Indices[i * 6];
+        index[0] = base;
+        index[1] = base + 1;
+        index[2] = base + 2;
+        index[3] = base;
+        index[4] = base + 2;
+        index[5] = base + 3;
+    }
+
+    //Sprites added in sorted order are used as-is. Otherwise, quads are gathered in sorted order.
+    if (m_InOrder)
+    {
+        m_Vertices.swap(m_Queued);
+    }
+    else
+    {
+        Sort();
+
+        m_Vertices.resize(count * 4);
+        for (size_t i = 0; i < count; i++)
+        {
+            memcpy(&m_Vertices[i * 4], &m_Queued[(size_t)m_Entries[i].Sprite * 4], sizeof(SpriteVertex) * 4);
+        }
+    }
+
+    //Start a new range whenever the key changes
+    m_Ranges.clear();
+    for (size_t i = 0; i < count; i++)
+    {
+        const SpriteKey& key = m_InOrder ? m_Keys[i] : m_Keys[m_Entries[i].Sprite];
+        if (m_Ranges.empty() || m_Ranges.back().Texture != key.Texture || m_Ranges.back().Technique != key.Technique)
+        {
+            m_Ranges.push_back({ key.Texture, key.Technique, (uint32_t)i * 6, 0 });
+        }
+        m_Ranges.back().IndexCount += 6;
+    }
+}
+
+SpriteVertex* Engine::SpriteBatch::Queue(const Sprite& sprite)
+{
+    const SpriteKey key = {
+        GetTextureID(((const SpriteRenderer*)sprite.m_Renderer.material)->TextureAtlas),
+        GetTechniqueID(sprite.m_Renderer.technique)
+    };
+
+    //Track whether the sprites so far are already in (texture, technique) order
+    if (m_InOrder && !m_Keys.empty())
+    {
+        const SpriteKey& last = m_Keys.back();
+        m_InOrder = last.Texture < key.Texture || (last.Texture == key.Texture && last.Technique <= key.Technique);
+    }
+    m_Keys.push_back(key);
+
+    m_Queued.resize(m_Queued.size() + 4);
+    return &m_Queued[m_Queued.size() - 4];
+}
+
+void Engine::SpriteBatch::Sort()
+{
+    const size_t count = m_Keys.size();
+    const uint32_t techniqueCount = (uint32_t)m_Techniques.size();
+
+    m_Entries.resize(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        m_Entries[i] = { m_Keys[i].Texture * techniqueCount + m_Keys[i].Technique, (uint32_t)i };
+    }
+
+    //Stable LSD radix sort, over only as many bytes as the largest key needs
+    const uint32_t maxKey = (uint32_t)m_Textures.size() * techniqueCount;
+    m_SortScratch.resize(count);
+    for (uint32_t shift = 0; shift < 32 && (maxKey - 1) >> shift != 0; shift += 8)
+    {
+        uint32_t histogram[257] = {};
+        for (const auto& entry : m_Entries)
+        {
+            histogram[((entry.Key >> shift) & 0xff) + 1]++;
+        }
+        for (uint32_t i = 1; i < 257; i++)
+        {
+            histogram[i] += histogram[i - 1];
+        }
+        for (const auto& entry : m_Entries)
+        {
+            m_SortScratch[histogram[(entry.Key >> shift) & 0xff]++] = entry;
+        }
+        m_Entries.swap(m_SortScratch);
+    }
+}
+
+uint32_t Engine::SpriteBatch::GetTextureID(const ResourceID& texture)
+{
+    //Consecutive sprites usually share an atlas
+    if (m_LastTexture != UINT32_MAX && m_Textures[m_LastTexture] == texture)
+    {
+        return m_LastTexture;
+    }
+
+    auto it = m_TextureIDs.find(texture);
+    if (it == m_TextureIDs.end())
+    {
+        it = m_TextureIDs.emplace(texture, (uint32_t)m_Textures.size()).first;
+        m_Textures.push_back(texture);
+    }
+
+    m_LastTexture = it->second;
+    return m_LastTexture;
+}
+
+uint32_t Engine::SpriteBatch::GetTechniqueID(const std::basic_string<char>& technique)
+{
+    if (m_LastTechnique != UINT32_MAX && m_Techniques[m_LastTechnique] == technique)
+    {
+        return m_LastTechnique;
+    }
+
+    auto it = m_TechniqueIDs.find(technique);
+    if (it == m_TechniqueIDs.end())
+    {
+        it = m_TechniqueIDs.emplace(technique, (uint32_t)m_Techniques.size()).first;
+        m_Techniques.push_back(technique);
+    }
+
+    m_LastTechnique = it->second;
+    return m_LastTechnique;
+}
@@ -0,0 +1,88 @@
+#include "../inc/Graphics/UploadRing.h"
+
+using namespace Engine;
+
+void Engine::UploadRing::Reset(uint32_t capacity)
+{
+    m_Frames.clear();
+    m_Capacity = capacity;
+    m_Head = 0;
+    m_Tail = 0;
+    m_Used = 0;
+    m_FrameSize = 0;
+}
+
+bool Engine::UploadRing::Allocate(uint32_t size, uint32_t alignment, uint32_t& offset)
+{
+    if (alignment == 0)
+    {
+        alignment = 1;
+    }
+
+    //An empty ring can restart from the beginning. Frames in flight are empty, so end there too.
+    if (m_Used == 0)
+    {
+        m_Head = 0;
+        m_Tail = 0;
+        for (auto& frame : m_Frames)
+        {
+            frame.End = 0;
+        }
+    }
+
+    const uint64_t aligned = ((uint64_t)m_Head + alignment - 1) / alignment * alignment;
+    uint32_t start = 0;
+
+    if (m_Head >= m_Tail && (m_Used == 0 || m_Head != m_Tail))
+    {
+        //Free space runs from the head to the end, then wraps around to the tail
+        if (aligned + size <= m_Capacity)
+        {
+            start = (uint32_t)aligned;
+        }
+        else if (size <= m_Tail)
+        {
+            start = 0;
+        }
+        else
+        {
+            return false;
+        }
+    }
+    else
+    {
+        //Free space runs from the head to the tail
+        if (aligned + size > m_Tail)
+        {
+            return false;
+        }
+        start = (uint32_t)aligned;
+    }
+
+    //Padding, and the space skipped when wrapping, are consumed along with the allocation
+    const uint32_t end = start + size;
+    const uint32_t consumed = start >= m_Head ? end - m_Head : (m_Capacity - m_Head) + end;
+
+    m_Head = end;
+    m_Used += consumed;
+    m_FrameSize += consumed;
+
+    offset = start;
+    return true;
+}
+
+void Engine::UploadRing::EndFrame(uint64_t fence)
+{
+    m_Frames.push_back({ fence, m_Head, m_FrameSize });
+    m_FrameSize = 0;
+}
+
+void Engine::UploadRing::Retire(uint64_t fence)
+{
+    while (!m_Frames.empty() && m_Frames.front().Fence <= fence)
+    {
+        m_Tail = m_Frames.front().End;
+        m_Used -= m_Frames.front().Size;
+        m_Frames.pop_front();
+    }
+}
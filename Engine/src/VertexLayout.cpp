@@ -0,0 +1,100 @@
+#include "../inc/Graphics/VertexLayout.h"
+
+using namespace Engine;
+
+std::bitset<10> Engine::VertexLayout::GetAttributes(EShaderType type)
+{
+    std::bitset<10> attributeFlags;
+
+    //Set the attribute flags based on the shader type
+    switch (type)
+    {
+        using enum EShaderType;
+    case(Basic):
+        attributeFlags.set((size_t)EVertexAttributes::Position);
+        break;
+    case(Blinn):
+        attributeFlags.set((size_t)EVertexAttributes::Position);
+        attributeFlags.set((size_t)EVertexAttributes::TexCoord);
+        attributeFlags.set((size_t)EVertexAttributes::Normal);
+        attributeFlags.set((size_t)EVertexAttributes::Tangent);
+        attributeFlags.set((size_t)EVertexAttributes::Binormal);
+        break;
+    case SpriteRenderer:
+        attributeFlags.set((size_t)EVertexAttributes::Position);
+        attributeFlags.set((size_t)EVertexAttributes::TexCoord);
+        break;
+    default:
+        break;
+    }
+
+    return attributeFlags;
+}
+
+uint32_t Engine::VertexLayout::GetVertexSize(EShaderType type)
+{
+    const std::bitset<10> attributeFlags = GetAttributes(type);
+
+    uint32_t vertexSize = 0;
+    attributeFlags.test((size_t)EVertexAttributes::Position) ? vertexSize += 3 : 0;
+    attributeFlags.test((size_t)EVertexAttributes::TexCoord) ? vertexSize += 2 : 0;
+    attributeFlags.test((size_t)EVertexAttributes::Normal) ? vertexSize += 3 : 0;
+    attributeFlags.test((size_t)EVertexAttributes::Tangent) ? vertexSize += 3 : 0;
+    attributeFlags.test((size_t)EVertexAttributes::Binormal) ? vertexSize += 3 : 0;
+
+    return vertexSize;
+}
+
+void Engine::VertexLayout::Interleave(const MeshFilter& mesh, EShaderType type, std::vector<float>& vertices)
+{
+    const std::bitset<10> attributeFlags = GetAttributes(type);
+    const bool hasPosition = attributeFlags.test((size_t)EVertexAttributes::Position);
+    const bool hasTexCoord = attributeFlags.test((size_t)EVertexAttributes::TexCoord);
+    const bool hasNormal = attributeFlags.test((size_t)EVertexAttributes::Normal);
+    const bool hasTangent = attributeFlags.test((size_t)EVertexAttributes::Tangent);
+    const bool hasBinormal = attributeFlags.test((size_t)EVertexAttributes::Binormal);
+
+    //Size the output once, and write each vertex in place
+    vertices.resize(mesh.Vertices.size() * GetVertexSize(type));
+    float* out = vertices.data();
+
+    auto _write3 = [&](const std::vector<Vector3f>& attribute, size_t i)
+    {
+        //Meshes which lack the attribute are zeroed
+        const Vector3f value = i < attribute.size() ? attribute[i] : Vector3f{ 0.0f, 0.0f, 0.0f };
+        *out++ = value.x;
+        *out++ = value.y;
+        *out++ = value.z;
+    };
+
+    //Assume all models include vertex positions
+    for (size_t i = 0; i < mesh.Vertices.size(); i++)
+    {
+        if (hasPosition)
+        {
+            _write3(mesh.Vertices, i);
+        }
+
+        if (hasTexCoord)
+        {
+            const Vector2f texCoord = i < mesh.TexCoords.size() ? mesh.TexCoords[i] : Vector2f{ 0.0f, 0.0f };
+            *out++ = texCoord.x;
+            *out++ = texCoord.y;
+        }
+
+        if (hasNormal)
+        {
+            _write3(mesh.Normals, i);
+        }
+
+        if (hasTangent)
+        {
+            _write3(mesh.Tangents, i);
+        }
+
+        if (hasBinormal)
+        {
+            _write3(mesh.Binormals, i);
+        }
+    }
+}
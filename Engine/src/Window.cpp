@@ -1,3 +1,4 @@
+#define LOG_CATEGORY Graphics
 #include "../inc/graphics/Window.h"
 #include "../inc/Graphics/Backends/DX11_GFX.h"
 /**
@@ -165,8 +166,9 @@ HWND InitWindow(const std::basic_string<wchar_t> title, const HINSTANCE& hInst,
     rid[1].dwFlags = RIDEV_INPUTSINK;
     rid[1].hwndTarget = windowHandle;
 
-    RegisterRawInputDevices(rid, 2, sizeof(rid[0]));
-    //ERR((RegisterRawInputDevices(rid, 2, sizeof(rid[0])) == false), "Raw Input Device Registration Failed!");
+    if (RegisterRawInputDevices(rid, 2, sizeof(rid[0])) == FALSE) {
+        LOG_AT(Warning, Input, "Raw Input Device Registration Failed!\n");
+    }
 
     return windowHandle;
 }
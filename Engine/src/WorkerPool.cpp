@@ -0,0 +1,100 @@
+#include "../inc/Core/WorkerPool.h"
+
+using namespace Engine;
+
+Engine::WorkerPool::WorkerPool(uint32_t threadCount)
+{
+    ERR(threadCount == 0, "Worker Pool requires at least one thread.");
+
+    //The calling thread is one of the pool's threads
+    m_Workers.reserve(threadCount - 1);
+    for (uint32_t i = 1; i < threadCount; i++)
+    {
+        m_Workers.emplace_back(&WorkerPool::WorkerMain, this);
+    }
+}
+
+Engine::WorkerPool::~WorkerPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Stopping = true;
+    }
+    m_WorkAvailable.notify_all();
+
+    for (auto& worker : m_Workers)
+    {
+        worker.join();
+    }
+}
+
+void Engine::WorkerPool::Run(uint32_t taskCount, const std::function<void(uint32_t task)>& task)
+{
+    if (taskCount == 0)
+    {
+        return;
+    }
+
+    //A single task isn't worth waking the workers for
+    if (taskCount == 1 || m_Workers.empty())
+    {
+        for (uint32_t i = 0; i < taskCount; i++)
+        {
+            task(i);
+        }
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Task = &task;
+        m_TaskCount = taskCount;
+        m_NextTask = 0;
+        m_Busy = (uint32_t)m_Workers.size();
+        m_Job++;
+    }
+    m_WorkAvailable.notify_all();
+
+    RunTasks();
+
+    //The task must outlive every worker's use of it
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    m_WorkFinished.wait(lock, [&] { return m_Busy == 0; });
+    m_Task = nullptr;
+}
+
+void Engine::WorkerPool::RunTasks()
+{
+    //Tasks are claimed one at a time, so that uneven tasks balance across threads
+    for (uint32_t i = m_NextTask++; i < m_TaskCount; i = m_NextTask++)
+    {
+        (*m_Task)(i);
+    }
+}
+
+void Engine::WorkerPool::WorkerMain()
+{
+    uint64_t lastJob = 0;
+
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            m_WorkAvailable.wait(lock, [&] { return m_Stopping || m_Job != lastJob; });
+
+            if (m_Stopping)
+            {
+                return;
+            }
+            lastJob = m_Job;
+        }
+
+        RunTasks();
+
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Busy--;
+        }
+        m_WorkFinished.notify_one();
+    }
+}
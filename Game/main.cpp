@@ -5,9 +5,13 @@
 #include "Graphics/Window.h"
 #include "Graphics/Backends/DX11_GFX.h"
 #include "Core/Input.h"
+#include "IO/AssetLoader.h"
+#include "IO/HotReload.h"
 
 using namespace Engine;
 
+static const std::basic_string<char> MODEL_PATH = "Resources\\Models\\Model.Asset";
+
 int WINAPI WinMain(
     _In_ HINSTANCE inst,
     _In_ HINSTANCE prevInst,     //Unused 
@@ -22,21 +26,68 @@ int WINAPI WinMain(
     window.SetIcon(L"Resources/Catalyst_Icon.ico");
     window.Show(showCmd);
 
+    //Cooked resources are loaded from the pack when present, and from loose files otherwise
+    ResourcePool::Init("Resources.pak");
+
+#if defined(DEBUG) || defined(_DEBUG)
+    //Reload shaders and textures as they're edited
+    HotReload::Start();
+#endif
+
     DX11_GFX gfx;
     gfx.Init(window, { .xResolution = 1280, .yResolution = 720 });
 
-    Primitives::Cube cube;
-    Blinn* b = new Blinn;
-    b->Diffuse = { 0x0f, 0xff, 0xf0, 0xff };
-    b->Ambient = { 0xAA, 0xAA, 0xAA, 0xAA };
+    //Draw a cube until the cooked model has streamed in
+    Model model;
+    {
+        Primitives::Cube cube;
+        Blinn* b = new Blinn;
+        b->Diffuse = { 0x0f, 0xff, 0xf0, 0xff };
+        b->Ambient = { 0xAA, 0xAA, 0xAA, 0xAA };
+
+        MeshRenderer renderer;
+        renderer.material = b;
+        renderer.shader = EShaderType::Blinn;
+
+        model.meshes.push_back(cube);
+        model.renderers.push_back(renderer);
+    }
 
-    MeshRenderer renderer;
-    renderer.material = b;
-    renderer.shader = EShaderType::Blinn;
+    //Invoked from Poll() on this thread, so the model can be swapped between frames. Keeps the current model if the asset couldn't be read.
+    AssetLoader loader;
+    const LoadCallback onModelLoaded = [&model](LoadHandle, Model& loaded)
+    {
+        if (loaded.meshes.empty())
+        {
+            return;
+        }
 
-    Model model;
-    model.meshes.push_back(cube);
-    model.renderers.push_back(renderer);
+        //The old meshes' buffers are no longer drawn, so release them rather than waiting for them to be evicted
+        for (const auto& mesh : model.meshes)
+        {
+            ResourcePool::RemoveMesh(mesh.Buffers);
+        }
+
+        model.meshes = std::move(loaded.meshes);
+        model.renderers = std::move(loaded.renderers);
+    };
+    loader.Load(MODEL_PATH, 1.0f, onModelLoaded);
+
+#if defined(DEBUG) || defined(_DEBUG)
+    //Reload the model when its asset is re-cooked. The backend only reloads shaders and textures, as the model belongs to the game.
+    const uint32_t modelReloader = HotReload::Register([&loader, &onModelLoaded](const std::basic_string<wchar_t>& path) -> std::function<void()>
+    {
+        if (Archive::NormalizePath(path) != Archive::NormalizePath(MODEL_PATH))
+        {
+            return {};
+        }
+
+        return [&loader, &onModelLoaded]
+        {
+            loader.Load(MODEL_PATH, 1.0f, onModelLoaded);
+        };
+    });
+#endif
 
     Camera cam;
     cam.Position = { 0.0f, 0.0f, -2.0f };
@@ -60,6 +111,9 @@ int WINAPI WinMain(
             float dt = time.DeltaTime();
             Input::Advance();
 
+            //Swap in any models which finished loading since the last frame
+            loader.Poll();
+
             static float r = 0;
             r += 1.0f / 120000.0f;
 
@@ -77,10 +131,21 @@ int WINAPI WinMain(
             {
                 PostQuitMessage(0x04);
             }
+            if (Input::Keyboard::KeyPressed(Input::Keys::KB_KEY_P))
+            {
+                //Log the previous frame's profile
+                Profiler::LogFrame();
+            }
             for (auto i = 0; i < model.meshes.size(); i++) {
                 gfx.Draw(model.worldMatrix, model.meshes.at(i), model.renderers.at(i), cam);
             }
             gfx.Present();
         }
     }
+
+#if defined(DEBUG) || defined(_DEBUG)
+    HotReload::Unregister(modelReloader);
+    HotReload::Stop();
+#endif
+    ResourcePool::Shutdown();
 }
\ No newline at end of file
@@ -0,0 +1,182 @@
+#include "IO/AssetLoader.h"
+#include "IO/Importer.h"
+#include "Test.h"
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+//Asset Loader Test
+//Replaces the importer with a load which records the order requests start in, and which can be held,
+//then checks the loader's priority order, cancellation, re-prioritisation and in-flight limit.
+//Ewan Burnett - 2022
+
+using namespace Engine;
+
+/**
+ * \brief The loads the workers have started, in order. Loads wait while Hold is set.
+ */
+static std::mutex LoadMutex;
+static std::condition_variable LoadReleased;
+static std::vector<std::basic_string<char>> Started;
+static bool Hold = false;
+
+void Engine::Importer::LoadFromFile(Model& model, const std::basic_string<char>& filePath)
+{
+    std::unique_lock<std::mutex> lock(LoadMutex);
+    Started.push_back(filePath);
+    LoadReleased.wait(lock, [] { return !Hold; });
+
+    model.source = filePath;
+}
+
+/**
+ * \brief Holds loads as they start, or releases them. Holding also forgets the loads started so far.
+ */
+static void SetHold(bool hold)
+{
+    {
+        std::lock_guard<std::mutex> lock(LoadMutex);
+        Hold = hold;
+        if (hold)
+        {
+            Started.clear();
+        }
+    }
+    LoadReleased.notify_all();
+}
+
+static size_t GetStartedCount()
+{
+    std::lock_guard<std::mutex> lock(LoadMutex);
+    return Started.size();
+}
+
+/**
+ * \brief Waits for a condition, for up to a few seconds.
+ */
+template<typename Predicate>
+static bool WaitFor(Predicate&& predicate)
+{
+    const auto timeout = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!predicate())
+    {
+        if (std::chrono::steady_clock::now() > timeout)
+        {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+/**
+ * \brief Polls until every request has completed.
+ */
+static void PollAll(AssetLoader& loader)
+{
+    CHECK(WaitFor([&] { loader.Poll(); return loader.Pending() == 0; }));
+}
+
+static void TestOrder()
+{
+    AssetLoader loader(1, 16);
+    std::vector<std::basic_string<char>> completed;
+    const LoadCallback callback = [&](LoadHandle, Model& model) { completed.push_back(model.source); };
+
+    //Occupy the only worker, so that the rest queue up behind it
+    SetHold(true);
+    loader.Load("first", 0.0f, callback);
+    CHECK(WaitFor([] { return GetStartedCount() == 1; }));
+
+    loader.Load("low", 1.0f, callback);
+    loader.Load("high", 3.0f, callback);
+    loader.Load("medium", 2.0f, callback);
+    loader.Load("high again", 3.0f, callback);
+    const LoadHandle raised = loader.Load("raised", 0.5f, callback);
+    const LoadHandle cancelled = loader.Load("cancelled", 5.0f, callback);
+
+    //Requests may be raised above the rest, or cancelled, while they're queued
+    CHECK(loader.SetPriority(raised, 10.0f));
+    CHECK(loader.Cancel(cancelled));
+    CHECK(!loader.Cancel(cancelled));
+    CHECK(!loader.SetPriority(cancelled, 1.0f));
+
+    SetHold(false);
+    PollAll(loader);
+
+    //Highest priority first, with equal priorities in the order they were requested
+    const std::vector<std::basic_string<char>> expected = { "first", "raised", "high", "high again", "medium", "low" };
+    CHECK(Started == expected);
+    CHECK(completed == expected);
+}
+
+static void TestCancel()
+{
+    AssetLoader loader(1, 16);
+    std::vector<std::basic_string<char>> completed;
+    const LoadCallback callback = [&](LoadHandle, Model& model) { completed.push_back(model.source); };
+
+    //A load which is running finishes, but its result is discarded
+    SetHold(true);
+    const LoadHandle running = loader.Load("running", 0.0f, callback);
+    CHECK(WaitFor([] { return GetStartedCount() == 1; }));
+    CHECK(loader.Cancel(running));
+    SetHold(false);
+    CHECK(WaitFor([&] { return loader.Pending() == 0; }));
+
+    //A load which has completed, but hasn't been polled, never invokes its callback
+    const LoadHandle unpolled = loader.Load("unpolled", 0.0f, callback);
+    CHECK(WaitFor([&] { return GetStartedCount() == 2; }));
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    CHECK(loader.Cancel(unpolled));
+
+    CHECK(loader.Poll() == 0);
+    CHECK(completed.empty());
+    CHECK(!loader.Cancel(INVALID_LOAD_HANDLE));
+}
+
+static void TestInFlight()
+{
+    constexpr uint32_t MAX_IN_FLIGHT = 2;
+    constexpr uint32_t REQUEST_COUNT = 6;
+
+    AssetLoader loader(4, MAX_IN_FLIGHT);
+    std::vector<std::basic_string<char>> completed;
+    const LoadCallback callback = [&](LoadHandle, Model& model) { completed.push_back(model.source); };
+
+    //Loads aren't held, so each completes as soon as it starts
+    SetHold(true);
+    SetHold(false);
+    for (uint32_t i = 0; i < REQUEST_COUNT; i++)
+    {
+        loader.Load("request " + std::to_string(i), 0.0f, callback);
+    }
+
+    //Completed loads hold their slot until they're polled, so no more than the limit start
+    CHECK(WaitFor([] { return GetStartedCount() == MAX_IN_FLIGHT; }));
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    CHECK(GetStartedCount() == MAX_IN_FLIGHT);
+    CHECK(loader.Pending() == REQUEST_COUNT);
+
+    //Polling one frees one slot
+    CHECK(loader.Poll(1) == 1);
+    CHECK(WaitFor([] { return GetStartedCount() == MAX_IN_FLIGHT + 1; }));
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    CHECK(GetStartedCount() == MAX_IN_FLIGHT + 1);
+
+    PollAll(loader);
+    CHECK(completed.size() == REQUEST_COUNT);
+    CHECK(GetStartedCount() == REQUEST_COUNT);
+}
+
+int main()
+{
+    TestOrder();
+    TestCancel();
+    TestInFlight();
+
+    return Test::Failures;
+}
@@ -0,0 +1,252 @@
+#include "IO/Compression.h"
+#include "Test.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <vector>
+
+//Compression Test
+//Round-trips random, compressible and empty buffers through the LZ codec, checks that truncated and corrupt blocks
+//are rejected without writing outside of the output buffer, and that Unshuffle() reverses Shuffle() for
+//several element widths. Inputs are copied into buffers of their exact size, so that address sanitized builds
+//also catch reads past their end.
+//Ewan Burnett - 2022
+
+using namespace Engine;
+
+static constexpr size_t GUARD_SIZE = 64;           //Bytes after each output buffer, which must not be written
+static constexpr uint8_t GUARD_BYTE = 0xCD;
+
+/**
+ * \brief A buffer of exactly size bytes, followed by guard bytes.
+ */
+struct Buffer
+{
+    explicit Buffer(size_t size) : Size(size), Data(new uint8_t[size + GUARD_SIZE])
+    {
+        memset(Data.get(), GUARD_BYTE, size + GUARD_SIZE);
+    }
+
+    Buffer(const uint8_t* data, size_t size) : Size(size), Data(new uint8_t[size])
+    {
+        std::copy(data, data + size, Data.get());
+    }
+
+    bool GuardIntact() const
+    {
+        for (size_t i = 0; i < GUARD_SIZE; i++)
+        {
+            if (Data[Size + i] != GUARD_BYTE)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    size_t Size;
+    std::unique_ptr<uint8_t[]> Data;
+};
+
+/**
+ * \brief Compresses a buffer, returning the block.
+ */
+static std::vector<uint8_t> Compress(const std::vector<uint8_t>& data)
+{
+    //A byte of storage even for empty inputs, so that the source pointer is valid
+    const uint8_t empty = 0;
+    const uint8_t* src = data.empty() ? &empty : data.data();
+
+    std::vector<uint8_t> block(Compression::CompressBound(data.size()));
+    const size_t size = Compression::Compress(src, data.size(), block.data(), block.size());
+    CHECK_MSG(size > 0, "%zu bytes didn't compress", data.size());
+    block.resize(size);
+
+    //A buffer smaller than the bound is refused outright
+    CHECK(Compression::Compress(src, data.size(), block.data(), Compression::CompressBound(data.size()) - 1) == 0);
+    return block;
+}
+
+/**
+ * \brief Decompresses a block into a guarded buffer of dstSize bytes.
+ */
+static bool Decompress(const uint8_t* block, size_t blockSize, size_t dstSize, Buffer& dst)
+{
+    Buffer src(block, blockSize);
+    dst = Buffer(dstSize);
+    const bool valid = Compression::Decompress(src.Data.get(), src.Size, dst.Data.get(), dstSize);
+    CHECK_MSG(dst.GuardIntact(), "A block of %zu bytes wrote past %zu bytes of output", blockSize, dstSize);
+    return valid;
+}
+
+static void CheckRoundTrip(const char* name, const std::vector<uint8_t>& data)
+{
+    const std::vector<uint8_t> block = Compress(data);
+    CHECK_MSG(block.size() <= Compression::CompressBound(data.size()), "%s: %zu bytes", name, block.size());
+
+    Buffer dst(0);
+    CHECK_MSG(Decompress(block.data(), block.size(), data.size(), dst), "%s: %zu bytes didn't decompress", name, data.size());
+    CHECK_MSG(data.empty() || memcmp(dst.Data.get(), data.data(), data.size()) == 0, "%s: %zu bytes didn't round trip", name, data.size());
+
+    //The size must be exact
+    CHECK_MSG(!Decompress(block.data(), block.size(), data.size() + 1, dst), "%s: decompressed into a larger buffer", name);
+    if (!data.empty())
+    {
+        CHECK_MSG(!Decompress(block.data(), block.size(), data.size() - 1, dst), "%s: decompressed into a smaller buffer", name);
+    }
+}
+
+static std::vector<uint8_t> MakeRandom(size_t size, std::mt19937& rng)
+{
+    std::vector<uint8_t> data(size);
+    for (auto& b : data)
+    {
+        b = (uint8_t)rng();
+    }
+    return data;
+}
+
+/**
+ * \brief Repeated text with runs of a single byte, giving short, long and overlapping back-references.
+ */
+static std::vector<uint8_t> MakeCompressible(size_t size, std::mt19937& rng)
+{
+    static const char* WORDS[] = { "vertex ", "index ", "normal ", "tangent ", "texcoord ", "material " };
+
+    std::vector<uint8_t> data;
+    while (data.size() < size)
+    {
+        if (rng() % 8 == 0)
+        {
+            data.insert(data.end(), rng() % 1000, (uint8_t)rng());
+        }
+        else
+        {
+            const char* word = WORDS[rng() % 6];
+            data.insert(data.end(), word, word + strlen(word));
+        }
+    }
+    data.resize(size);
+    return data;
+}
+
+static void TestRoundTrip()
+{
+    std::mt19937 rng(1234);
+
+    CheckRoundTrip("Empty", {});
+    for (size_t size : { 1, 4, 5, 12, 13, 16, 17, 100, 4096, 70000, 300000 })
+    {
+        CheckRoundTrip("Random", MakeRandom(size, rng));
+        CheckRoundTrip("Compressible", MakeCompressible(size, rng));
+        CheckRoundTrip("Zero", std::vector<uint8_t>(size, 0));
+    }
+
+    //Compressible data compresses
+    const std::vector<uint8_t> data = MakeCompressible(100000, rng);
+    const size_t compressed = Compress(data).size();
+    CHECK_MSG(compressed < data.size() / 4, "%zu bytes compressed to %zu", data.size(), compressed);
+}
+
+static void TestTruncated()
+{
+    std::mt19937 rng(5678);
+
+    for (const auto& data : { MakeCompressible(2000, rng), MakeRandom(600, rng), std::vector<uint8_t>(3000, 7) })
+    {
+        const std::vector<uint8_t> block = Compress(data);
+        Buffer dst(0);
+        for (size_t size = 0; size < block.size(); size++)
+        {
+            CHECK_MSG(!Decompress(block.data(), size, data.size(), dst), "%zu of %zu bytes decompressed", size, block.size());
+        }
+    }
+}
+
+static void TestCorrupt()
+{
+    std::mt19937 rng(9012);
+    const std::vector<uint8_t> data = MakeCompressible(4000, rng);
+    const std::vector<uint8_t> block = Compress(data);
+    Buffer dst(0);
+
+    //Flipped bytes may still decode, but must stay within the buffers
+    for (uint32_t i = 0; i < 2000; i++)
+    {
+        std::vector<uint8_t> corrupt = block;
+        for (uint32_t j = 0; j <= i % 4; j++)
+        {
+            corrupt[rng() % corrupt.size()] ^= (uint8_t)(1 + rng() % 255);
+        }
+        Decompress(corrupt.data(), corrupt.size(), data.size(), dst);
+    }
+
+    //Crafted sequences
+    const std::vector<std::vector<uint8_t>> invalid = {
+        { 0x50, 'a', 'b', 'c', 'd' },                           //A literal run longer than the block
+        { 0xF0, 255, 255 },                                     //A literal length which runs off the end
+        { 0x40, 'a', 'b', 'c', 'd', 0x00, 0x00, 0x00 },         //A back-reference with no offset
+        { 0x40, 'a', 'b', 'c', 'd', 0x05, 0x00, 0x00 },         //A back-reference before the start of the output
+        { 0x4F, 'a', 'b', 'c', 'd', 0x04, 0x00, 200 },          //A back-reference past the end of the output
+        { 0x4F, 'a', 'b', 'c', 'd', 0x04, 0x00, 255 },          //A match length which runs off the end
+        { 0x40, 'a', 'b', 'c', 'd', 0x04 },                     //A truncated offset
+    };
+    for (size_t i = 0; i < invalid.size(); i++)
+    {
+        CHECK_MSG(!Decompress(invalid[i].data(), invalid[i].size(), 16, dst), "Invalid block %zu decompressed", i);
+    }
+}
+
+static void TestShuffle()
+{
+    std::mt19937 rng(3456);
+
+    for (size_t width : { 1, 2, 3, 4, 8, 12, 16 })
+    {
+        for (size_t size : { 0, 1, 7, 64, 1000, 4099 })
+        {
+            const std::vector<uint8_t> data = MakeRandom(size, rng);
+            const Buffer src(data.data(), size);
+            Buffer shuffled(size);
+            Buffer unshuffled(size);
+
+            Compression::Shuffle(src.Data.get(), shuffled.Data.get(), size, width);
+            Compression::Unshuffle(shuffled.Data.get(), unshuffled.Data.get(), size, width);
+
+            CHECK(shuffled.GuardIntact() && unshuffled.GuardIntact());
+            CHECK_MSG(size == 0 || memcmp(unshuffled.Data.get(), data.data(), size) == 0, "%zu bytes of width %zu", size, width);
+
+            //The first byte of every whole element comes first
+            if (size >= width * 2)
+            {
+                CHECK(shuffled.Data[1] == data[width]);
+            }
+        }
+    }
+
+    //Shuffling a float stream groups its exponents, so that it compresses further
+    std::vector<uint8_t> floats(4 * 20000);
+    for (size_t i = 0; i < 20000; i++)
+    {
+        const float f = sinf(i * 0.01f) * 100.0f;
+        memcpy(floats.data() + i * 4, &f, 4);
+    }
+    std::vector<uint8_t> shuffled(floats.size());
+    Compression::Shuffle(floats.data(), shuffled.data(), floats.size(), 4);
+
+    const size_t plain = Compress(floats).size();
+    const size_t filtered = Compress(shuffled).size();
+    CHECK_MSG(filtered < plain, "%zu bytes shuffled, %zu unshuffled", filtered, plain);
+}
+
+int main()
+{
+    TestRoundTrip();
+    TestTruncated();
+    TestCorrupt();
+    TestShuffle();
+
+    return Test::Failures;
+}
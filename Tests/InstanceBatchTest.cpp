@@ -0,0 +1,95 @@
+#include "Graphics/InstanceBatch.h"
+#include "Test.h"
+#include <random>
+#include <vector>
+
+//Instance Batch Test
+//Adds instances of several meshes and renderers in a random order, and checks that they're grouped
+//by mesh and renderer, with groups and instances in the order they were first added.
+//Ewan Burnett - 2022
+
+using namespace Engine;
+
+static constexpr uint32_t MESH_COUNT = 5;
+static constexpr uint32_t RENDERER_COUNT = 3;
+static constexpr uint32_t INSTANCE_COUNT = 2000;
+
+struct Added
+{
+    uint32_t Mesh;
+    uint32_t Renderer;
+};
+
+int main()
+{
+    std::vector<Primitives::Cube> meshes(MESH_COUNT);
+    std::vector<MeshRenderer> renderers(RENDERER_COUNT);
+
+    std::mt19937 rng(1);
+    std::vector<Added> added(INSTANCE_COUNT);
+    for (auto& a : added)
+    {
+        a = { (uint32_t)(rng() % MESH_COUNT), (uint32_t)(rng() % RENDERER_COUNT) };
+    }
+
+    InstanceBatch batch;
+    for (uint32_t frame = 0; frame < 2; frame++)
+    {
+        //Each instance's matrix records the order it was added in
+        batch.Begin();
+        for (uint32_t i = 0; i < INSTANCE_COUNT; i++)
+        {
+            Matrix4x4 world;
+            world._matrix._41 = (float)i;
+            batch.Add(meshes[added[i].Mesh], renderers[added[i].Renderer], world);
+        }
+        batch.End();
+
+        CHECK(batch.GetInstanceCount() == INSTANCE_COUNT);
+        CHECK(batch.GetInstances().size() == INSTANCE_COUNT);
+
+        //Every pair is used, so there's one group for each
+        const auto& groups = batch.GetGroups();
+        CHECK_MSG(groups.size() == MESH_COUNT * RENDERER_COUNT, "%zu groups", groups.size());
+
+        uint32_t next = 0;
+        float previousFirst = -1.0f;
+        for (size_t g = 0; g < groups.size(); g++)
+        {
+            const InstanceGroup& group = groups[g];
+            CHECK(group.FirstInstance == next);
+            CHECK(group.InstanceCount > 0);
+            next += group.InstanceCount;
+
+            for (size_t other = 0; other < g; other++)
+            {
+                CHECK(groups[other].Mesh != group.Mesh || groups[other].Renderer != group.Renderer);
+            }
+
+            //Groups are ordered by their first instance, and instances keep their order within a group
+            const Matrix4x4* instances = &batch.GetInstances()[group.FirstInstance];
+            CHECK(instances[0]._matrix._41 > previousFirst);
+            previousFirst = instances[0]._matrix._41;
+
+            for (uint32_t i = 0; i < group.InstanceCount; i++)
+            {
+                const uint32_t index = (uint32_t)instances[i]._matrix._41;
+                CHECK(&meshes[added[index].Mesh] == group.Mesh);
+                CHECK(&renderers[added[index].Renderer] == group.Renderer);
+                if (i > 0)
+                {
+                    CHECK(instances[i]._matrix._41 > instances[i - 1]._matrix._41);
+                }
+            }
+        }
+        CHECK(next == INSTANCE_COUNT);
+    }
+
+    //An empty frame has no groups
+    batch.Begin();
+    batch.End();
+    CHECK(batch.GetGroups().empty());
+    CHECK(batch.GetInstances().empty());
+
+    return Test::Failures;
+}
@@ -0,0 +1,242 @@
+#include "IO/LogFormat.h"
+#include "Test.h"
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <sstream>
+#include <vector>
+
+//Log Format Test
+//Checks that deferred arguments format as printf would have, that binary logs decode back to the text
+//they were written from, and that truncated or corrupt logs are rejected rather than misread.
+//Ewan Burnett - 2022
+
+using namespace Engine;
+
+/**
+ * \brief Encodes arguments, and checks they format the same as snprintf formats them directly.
+ */
+template<typename... Args>
+static void CheckFormat(const char* fmt, const Args&... args)
+{
+    uint8_t encoded[256];
+    const uint32_t size = LogFormat::Encode(encoded, sizeof(encoded), args...);
+
+    char expected[512];
+    snprintf(expected, sizeof(expected), fmt, args...);
+
+    const std::basic_string<char> formatted = LogFormat::Format(fmt, encoded, size);
+    CHECK_MSG(formatted == expected, "\"%s\" formatted as \"%s\", rather than \"%s\"", fmt, formatted.c_str(), expected);
+}
+
+static void TestFormat()
+{
+    CheckFormat("plain text");
+    CheckFormat("%d %i %u", -12, 34, 56u);
+    CheckFormat("%lld %llu %zu", (long long)INT64_MIN, (unsigned long long)UINT64_MAX, (size_t)12345);
+    CheckFormat("%x %X %o %08x %-5d|", 0xbeefu, 0xCAFEu, 8u, 0x12u, 7);
+    CheckFormat("%f %.3e %g %10.2f", 3.14159, 1e-7, 2.5f, -1.0);
+    CheckFormat("%s and %s", "first", "second");
+    CheckFormat("%c%c %5s|%-5s|", 'o', 'k', "ab", "cd");
+    CheckFormat("100%% %s", "done");
+
+    //Missing and mismatched arguments are marked, rather than read as something else
+    uint8_t encoded[64];
+    uint32_t size = LogFormat::Encode(encoded, sizeof(encoded), 1);
+    CHECK(LogFormat::Format("%d %d", encoded, size) == "1 <missing>");
+
+    size = LogFormat::Encode(encoded, sizeof(encoded), 1.5, 2);
+    CHECK(LogFormat::Format("%s %d", encoded, size) == "<bad argument> <missing>");
+
+    //Arguments after one which doesn't fit are left out too, rather than shifted into its place
+    size = LogFormat::Encode(encoded, 10, 1, 2.5, 3);
+    CHECK(size == 5);
+    CHECK(LogFormat::Format("%d %f %d", encoded, size) == "1 <missing> <missing>");
+}
+
+/**
+ * \brief Writes binary log records, remembering where each ends.
+ */
+struct LogBuilder
+{
+    std::basic_string<char> Data;
+    std::vector<size_t> Boundaries;     //Offsets at which a log may end
+
+    template<typename T>
+    void Write(const T& value)
+    {
+        Data.append((const char*)&value, sizeof(T));
+    }
+
+    void Header()
+    {
+        Data.append(LogFormat::BINARY_MAGIC, sizeof(LogFormat::BINARY_MAGIC));
+        Write(LogFormat::BINARY_VERSION);
+        Boundaries.push_back(Data.size());
+    }
+
+    void Format(uint32_t id, std::string_view format)
+    {
+        Write(LogFormat::EBinaryRecord::Format);
+        Write(id);
+        Write((uint16_t)format.size());
+        Data.append(format);
+        Boundaries.push_back(Data.size());
+    }
+
+    void Message(uint32_t id, const uint8_t* args, uint32_t size)
+    {
+        Write(LogFormat::EBinaryRecord::Message);
+        Write(id);
+        Write((uint16_t)size);
+        Data.append((const char*)args, size);
+        Boundaries.push_back(Data.size());
+    }
+
+    void Text(std::string_view text)
+    {
+        Write(LogFormat::EBinaryRecord::Text);
+        Write((uint16_t)text.size());
+        Data.append(text);
+        Boundaries.push_back(Data.size());
+    }
+
+    void Time(int64_t time)
+    {
+        Write(LogFormat::EBinaryRecord::Time);
+        Write(time);
+        Boundaries.push_back(Data.size());
+    }
+};
+
+static bool Decode(std::string_view data, std::basic_string<char>& text)
+{
+    std::istringstream in{ std::basic_string<char>(data) };
+    std::ostringstream out;
+    const bool decoded = LogFormat::Decode(in, out);
+    text = out.str();
+    return decoded;
+}
+
+static void TestDecode()
+{
+    const int64_t time = 1000000000;
+    uint8_t args[64];
+
+    LogBuilder log;
+    std::basic_string<char> expected;
+
+    log.Header();
+    log.Time(time);
+    expected += LogFormat::FormatTime((std::time_t)time);
+
+    log.Format(0, "Loaded %s in %.2fms\n");
+    log.Message(0, args, LogFormat::Encode(args, sizeof(args), "Cube.Asset", 1.25));
+    expected += "Loaded Cube.Asset in 1.25ms\n";
+
+    log.Text("Formatted by the caller\n");
+    expected += "Formatted by the caller\n";
+
+    //A later session restarts the format IDs
+    log.Header();
+    log.Format(0, "%d draws\n");
+    log.Message(0, args, LogFormat::Encode(args, sizeof(args), 42));
+    expected += "42 draws\n";
+
+    std::basic_string<char> text;
+    CHECK(Decode(log.Data, text));
+    CHECK_MSG(text == expected, "decoded \"%s\"", text.c_str());
+
+    //Logs cut short are only valid if they end between records
+    for (size_t length = 0; length < log.Data.size(); length++)
+    {
+        const bool boundary = std::find(log.Boundaries.begin(), log.Boundaries.end(), length) != log.Boundaries.end();
+        CHECK_MSG(Decode(std::string_view(log.Data).substr(0, length), text) == boundary, "truncated to %zu bytes", length);
+    }
+}
+
+static void TestCorrupt()
+{
+    std::basic_string<char> text;
+
+    //Bad headers
+    CHECK(!Decode("", text));
+    CHECK(!Decode("CLOX\x01\x00\x00\x00", text));
+    {
+        LogBuilder log;
+        log.Data.append(LogFormat::BINARY_MAGIC, sizeof(LogFormat::BINARY_MAGIC));
+        log.Write(LogFormat::BINARY_VERSION + 1);
+        CHECK(!Decode(log.Data, text));
+    }
+
+    //Unknown tags, and messages whose format was never written
+    {
+        LogBuilder log;
+        log.Header();
+        log.Write((uint8_t)0x7f);
+        CHECK(!Decode(log.Data, text));
+    }
+    {
+        LogBuilder log;
+        log.Header();
+        uint8_t args[16];
+        log.Message(3, args, LogFormat::Encode(args, sizeof(args), 1));
+        CHECK(!Decode(log.Data, text));
+    }
+
+    //Times which can't be represented
+    for (int64_t time : { INT64_MAX, INT64_MIN })
+    {
+        LogBuilder log;
+        log.Header();
+        log.Time(time);
+        CHECK(!Decode(log.Data, text));
+    }
+
+    //Garbage arguments are formatted as bad, rather than read past their end
+    {
+        std::mt19937 rng(1);
+        for (uint32_t i = 0; i < 1000; i++)
+        {
+            uint8_t garbage[32];
+            for (auto& byte : garbage)
+            {
+                byte = (uint8_t)rng();
+            }
+
+            LogBuilder log;
+            log.Header();
+            log.Format(0, "%d %s %f %p %llu %c\n");
+            log.Message(0, garbage, 1 + rng() % sizeof(garbage));
+            Decode(log.Data, text);
+        }
+    }
+
+    //Random corruption of a valid log never crashes
+    {
+        LogBuilder log;
+        log.Header();
+        log.Format(1, "%s %d\n");
+        uint8_t args[32];
+        log.Message(1, args, LogFormat::Encode(args, sizeof(args), "value", 7));
+        log.Text("text\n");
+        log.Time(0);
+
+        std::mt19937 rng(2);
+        for (uint32_t i = 0; i < 10000; i++)
+        {
+            std::basic_string<char> corrupt = log.Data;
+            corrupt[rng() % corrupt.size()] = (char)rng();
+            Decode(corrupt, text);
+        }
+    }
+}
+
+int main()
+{
+    TestFormat();
+    TestDecode();
+    TestCorrupt();
+
+    return Test::Failures;
+}
@@ -0,0 +1,78 @@
+#include "IO/Logger.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+//Logger Benchmark
+//Times the caller's side of formatted and deferred log calls, from one thread and from every hardware thread at once,
+//both when callers wait for a full queue to drain and when they drop the message.
+//Ewan Burnett - 2022
+
+using namespace Engine;
+
+static constexpr uint32_t CALL_COUNT = 100000;     //Per thread
+static constexpr uint32_t RUN_COUNT = 5;
+
+static void Run(const char* name, bool deferred, uint32_t threadCount, ELogOverflow overflow)
+{
+    SetLogOverflow(overflow);
+
+    double best = 1e9;
+    for (uint32_t run = 0; run < RUN_COUNT; run++)
+    {
+        std::vector<std::thread> threads;
+        const auto start = std::chrono::steady_clock::now();
+        for (uint32_t t = 0; t < threadCount; t++)
+        {
+            threads.emplace_back([deferred, t]
+            {
+                for (uint32_t i = 0; i < CALL_COUNT; i++)
+                {
+                    if (deferred)
+                    {
+                        LOG_DEFERRED("Frame %u: %u draws in %.3fms on thread %u\n", i, i * 3, i * 0.01, t);
+                    }
+                    else
+                    {
+                        Log("Frame %u: %u draws in %.3fms on thread %u\n", i, i * 3, i * 0.01, t);
+                    }
+                }
+            });
+        }
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+        const auto end = std::chrono::steady_clock::now();
+
+        //Drain the queue between runs, so that each run starts with it empty
+        FlushLog();
+        best = std::min(best, std::chrono::duration<double, std::milli>(end - start).count());
+    }
+
+    const double calls = (double)CALL_COUNT * threadCount;
+    printf("%s, %2u threads, %s: %.3fms for %.0f calls, %.1fns per call (best of %u)\n",
+        name, threadCount, overflow == ELogOverflow::Block ? "blocking" : "dropping", best, calls, best * 1e6 / calls, RUN_COUNT);
+}
+
+int main()
+{
+    //Written to a binary log, as the benchmark would otherwise time the writer's formatting rather than the callers
+    remove("Log.bin");
+    SetLogFormat(ELogFormat::Binary);
+
+    const uint32_t threadCount = std::max(std::thread::hardware_concurrency(), 2u);
+    printf("%u hardware threads\n", std::thread::hardware_concurrency());
+    for (ELogOverflow overflow : { ELogOverflow::Block, ELogOverflow::Drop })
+    {
+        for (uint32_t threads : { 1u, threadCount })
+        {
+            Run("Formatted", false, threads, overflow);
+            Run("Deferred", true, threads, overflow);
+        }
+    }
+
+    return 0;
+}
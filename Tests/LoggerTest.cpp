@@ -0,0 +1,156 @@
+#include "IO/Logger.h"
+#include "Test.h"
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+//Logger Test
+//Logs from several threads at once, then reads Log.txt back, checking that messages split across several
+//records are written whole, that messages dropped while the queue is full are counted and reported,
+//and that FlushLog() writes everything logged before it.
+//Ewan Burnett - 2022
+
+using namespace Engine;
+
+static constexpr uint32_t THREAD_COUNT = 4;
+static constexpr uint32_t LONG_MESSAGE_COUNT = 500;
+static constexpr uint32_t LONG_MESSAGE_LENGTH = 1800;      //Split across four records
+static constexpr uint32_t DEFERRED_MESSAGE_COUNT = 20000;
+
+/**
+ * \brief Returns everything written to Log.txt so far.
+ */
+static std::basic_string<char> ReadLog()
+{
+    FlushLog();
+
+    std::ifstream file("Log.txt", std::ios::binary);
+    std::stringstream contents;
+    contents << file.rdbuf();
+    return contents.str();
+}
+
+/**
+ * \brief Calls a function for each line of the log which starts with a prefix.
+ */
+template<typename Visit>
+static void ForEachLine(const std::basic_string<char>& log, const std::basic_string<char>& prefix, Visit&& visit)
+{
+    std::istringstream lines(log);
+    std::basic_string<char> line;
+    while (std::getline(lines, line))
+    {
+        if (line.compare(0, prefix.size(), prefix) == 0)
+        {
+            visit(line);
+        }
+    }
+}
+
+/**
+ * \brief Builds a long message, unique to its thread and index, ending in a newline.
+ */
+static std::basic_string<char> LongMessage(uint32_t thread, uint32_t index)
+{
+    std::basic_string<char> message = "long " + std::to_string(thread) + " " + std::to_string(index) + " ";
+    message.append(LONG_MESSAGE_LENGTH - message.size() - 1, (char)('a' + (index + thread) % 26));
+    message.push_back('\n');
+    return message;
+}
+
+static void TestContiguous()
+{
+    SetLogOverflow(ELogOverflow::Block);
+
+    std::vector<std::thread> threads;
+    for (uint32_t t = 0; t < THREAD_COUNT; t++)
+    {
+        threads.emplace_back([t]
+        {
+            for (uint32_t i = 0; i < LONG_MESSAGE_COUNT; i++)
+            {
+                Log("%s", LongMessage(t, i).c_str());
+            }
+        });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    //Every message is written whole, without another thread's records in the middle of it
+    std::unordered_set<uint32_t> found;
+    uint32_t broken = 0;
+    ForEachLine(ReadLog(), "long ", [&](const std::basic_string<char>& line)
+    {
+        uint32_t thread = 0;
+        uint32_t index = 0;
+        if (sscanf(line.c_str(), "long %u %u", &thread, &index) != 2 || thread >= THREAD_COUNT || index >= LONG_MESSAGE_COUNT || line + '\n' != LongMessage(thread, index))
+        {
+            broken++;
+            return;
+        }
+        found.insert(thread * LONG_MESSAGE_COUNT + index);
+    });
+
+    CHECK_MSG(broken == 0, "%u messages were split", broken);
+    CHECK_MSG(found.size() == THREAD_COUNT * LONG_MESSAGE_COUNT, "%zu of %u messages were written", found.size(), THREAD_COUNT * LONG_MESSAGE_COUNT);
+}
+
+static void TestDropped()
+{
+    SetLogOverflow(ELogOverflow::Drop);
+
+    //Deferred messages are encoded quickly, but formatting them is slow, so the writer falls behind and the queue fills
+    std::vector<std::thread> threads;
+    for (uint32_t t = 0; t < THREAD_COUNT; t++)
+    {
+        threads.emplace_back([t]
+        {
+            for (uint32_t i = 0; i < DEFERRED_MESSAGE_COUNT; i++)
+            {
+                const double d = i * 1.5;
+                LOG_DEFERRED("deferred %u %u %e %e %e %e %e %e %e %e %e %e %e %e %e %e %e %e\n", t, i, d, d, d, d, d, d, d, d, d, d, d, d, d, d, d, d);
+            }
+        });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    //A message queued after every drop, which can't be dropped, so the drops are reported before the flush completes
+    SetLogOverflow(ELogOverflow::Block);
+    Log("end\n");
+
+    const std::basic_string<char> log = ReadLog();
+    uint64_t written = 0;
+    uint64_t dropped = 0;
+    ForEachLine(log, "deferred ", [&](const std::basic_string<char>&) { written++; });
+    ForEachLine(log, "[Log queue full: ", [&](const std::basic_string<char>& line)
+    {
+        unsigned long long count = 0;
+        CHECK(sscanf(line.c_str(), "[Log queue full: %llu messages dropped]", &count) == 1);
+        dropped += count;
+    });
+
+    //Every message is either written, or counted as dropped
+    CHECK_MSG(dropped > 0, "the queue never filled, so nothing was dropped");
+    CHECK_MSG(written + dropped == (uint64_t)THREAD_COUNT * DEFERRED_MESSAGE_COUNT, "%llu written and %llu dropped, of %u", (unsigned long long)written, (unsigned long long)dropped, THREAD_COUNT * DEFERRED_MESSAGE_COUNT);
+    CHECK(log.find("\nend\n") != std::basic_string<char>::npos);
+}
+
+int main()
+{
+    //The log is appended to, so start from an empty one
+    remove("Log.txt");
+
+    TestContiguous();
+    TestDropped();
+
+    return Test::Failures;
+}
@@ -0,0 +1,227 @@
+#include "IO/MeshOptimizer.h"
+#include "Test.h"
+#include <algorithm>
+#include <cmath>
+
+//Mesh Optimizer Test
+//Simplifies procedural grids, and checks the triangle counts and errors of the results.
+//Splits grids into meshlets, and checks their limits, bounds and culling.
+//Ewan Burnett - 2022
+
+using namespace Engine;
+
+static constexpr float GRID_SIZE = 10.0f;
+static constexpr uint32_t GRID_VERTICES = 65;
+
+/**
+ * \brief Checks that a triangle list only refers to the mesh's vertices, and has no degenerate triangles.
+ */
+static bool IsValid(const MeshFilter& mesh, const std::vector<uint32_t>& indices)
+{
+    if (indices.size() % 3 != 0)
+    {
+        return false;
+    }
+
+    for (size_t i = 0; i < indices.size(); i += 3)
+    {
+        const uint32_t a = indices[i];
+        const uint32_t b = indices[i + 1];
+        const uint32_t c = indices[i + 2];
+        if (a >= mesh.Vertices.size() || b >= mesh.Vertices.size() || c >= mesh.Vertices.size() || a == b || b == c || a == c)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * \brief A grid, displaced into hills, so that simplifying it introduces error.
+ */
+static Primitives::Plane MakeHills()
+{
+    Primitives::Plane hills(GRID_SIZE, GRID_SIZE, GRID_VERTICES, GRID_VERTICES);
+    for (auto& v : hills.Vertices)
+    {
+        v.y = 0.5f * sinf(v.x) * cosf(v.z);
+    }
+
+    return hills;
+}
+
+static void TestFlatGrid()
+{
+    //A flat grid can be reduced to its target without moving the surface
+    Primitives::Plane flat(GRID_SIZE, GRID_SIZE, GRID_VERTICES, GRID_VERTICES);
+    const uint32_t target = (uint32_t)flat.Indices.size() / 12 * 3;
+
+    std::vector<uint32_t> output;
+    const float error = MeshOptimizer::Simplify(flat, flat.Indices, target, output);
+
+    CHECK(IsValid(flat, output));
+    CHECK_MSG(output.size() <= target && output.size() >= target * 9 / 10, "%zu indices, for a target of %u", output.size(), target);
+    CHECK_MSG(error <= GRID_SIZE * 0.002f, "error %f", error);
+}
+
+static void TestLODChain()
+{
+    Primitives::Plane hills = MakeHills();
+    const MeshOptimizer::LODSettings settings = {};
+    MeshOptimizer::GenerateLODs(hills, settings);
+
+    CHECK(hills.LODs.size() >= 3);
+
+    size_t previousIndices = hills.Indices.size();
+    float previousError = 0.0f;
+    for (const auto& lod : hills.LODs)
+    {
+        CHECK(IsValid(hills, lod.Indices));
+
+        //Each level is meaningfully coarser than the last, and no less erroneous
+        CHECK_MSG(lod.Indices.size() <= previousIndices * 9 / 10, "%zu indices after %zu", lod.Indices.size(), previousIndices);
+        CHECK_MSG(lod.Error >= previousError, "error %f after %f", lod.Error, previousError);
+        CHECK(lod.Error > 0.0f);
+
+        //Every level is within the error allowed against the original surface
+        CHECK_MSG(lod.Error <= settings.MaxError * GRID_SIZE, "error %f", lod.Error);
+
+        previousIndices = lod.Indices.size();
+        previousError = lod.Error;
+    }
+
+    //The first level reaches its target, as the hills are smooth at that scale
+    CHECK(!hills.LODs.empty() && hills.LODs[0].Indices.size() <= (size_t)(hills.Indices.size() / 3 * settings.Reduction) * 3);
+}
+
+static void TestMaxError()
+{
+    //A tighter error bound stops the chain early, rather than exceeding it
+    Primitives::Plane hills = MakeHills();
+    MeshOptimizer::LODSettings settings = {};
+    settings.MaxError = 0.01f;
+    MeshOptimizer::GenerateLODs(hills, settings);
+
+    CHECK(!hills.LODs.empty());
+    for (const auto& lod : hills.LODs)
+    {
+        CHECK_MSG(lod.Error <= settings.MaxError * GRID_SIZE, "error %f", lod.Error);
+    }
+}
+
+static void TestSelectLOD()
+{
+    Primitives::Plane hills = MakeHills();
+    MeshOptimizer::GenerateLODs(hills);
+
+    const Frustrum frustrum = {};
+    CHECK(MeshOptimizer::SelectLOD(hills, 0.0f, frustrum, 720.0f) == 0);
+    CHECK(MeshOptimizer::SelectLOD(hills, 100000.0f, frustrum, 720.0f) == hills.LODs.size());
+
+    //Selection only coarsens with distance
+    uint32_t previous = 0;
+    for (float distance = 1.0f; distance < 10000.0f; distance *= 1.5f)
+    {
+        const uint32_t lod = MeshOptimizer::SelectLOD(hills, distance, frustrum, 720.0f);
+        CHECK(lod >= previous);
+        previous = lod;
+    }
+}
+
+/**
+ * \brief Checks that a mesh's meshlets respect their limits, and reproduce its triangle list in order.
+ */
+static void CheckMeshlets(const MeshFilter& mesh, uint32_t maxVertices, uint32_t maxTriangles)
+{
+    size_t index = 0;
+    for (const auto& meshlet : mesh.Meshlets)
+    {
+        CHECK_MSG(meshlet.VertexCount <= maxVertices && meshlet.TriangleCount <= maxTriangles, "%u vertices, %u triangles", meshlet.VertexCount, meshlet.TriangleCount);
+        CHECK(meshlet.TriangleCount > 0);
+
+        for (uint32_t i = 0; i < meshlet.TriangleCount * 3; i++, index++)
+        {
+            const uint8_t local = mesh.MeshletTriangles[meshlet.TriangleOffset + i];
+            if (local >= meshlet.VertexCount || index >= mesh.Indices.size() || mesh.MeshletVertices[meshlet.VertexOffset + local] != mesh.Indices[index])
+            {
+                CHECK_MSG(false, "index %zu doesn't match the mesh", index);
+                return;
+            }
+        }
+
+        //Every vertex lies within the bounding sphere
+        float farthest = 0.0f;
+        for (uint32_t i = 0; i < meshlet.VertexCount; i++)
+        {
+            const Vector3f& v = mesh.Vertices[mesh.MeshletVertices[meshlet.VertexOffset + i]];
+            farthest = std::max(farthest, Math::VectorLength(v - meshlet.Bounds.Position));
+        }
+        CHECK_MSG(farthest <= meshlet.Bounds.Radius * 1.0001f + 1e-5f, "a vertex lies %f from the centre of a sphere of radius %f", farthest, meshlet.Bounds.Radius);
+    }
+    CHECK(index == mesh.Indices.size());
+}
+
+static void TestMeshletLimits()
+{
+    Primitives::Plane hills = MakeHills();
+
+    MeshOptimizer::BuildMeshlets(hills);
+    CHECK(hills.Meshlets.size() >= hills.Indices.size() / 3 / MeshOptimizer::MESHLET_MAX_TRIANGLES);
+    CheckMeshlets(hills, MeshOptimizer::MESHLET_MAX_VERTICES, MeshOptimizer::MESHLET_MAX_TRIANGLES);
+
+    //Narrow limits, where vertices run out before triangles
+    MeshOptimizer::BuildMeshlets(hills, 8, 124);
+    CheckMeshlets(hills, 8, 124);
+
+    //Limits beyond what 8-bit local indices can address are clamped
+    MeshOptimizer::BuildMeshlets(hills, 1000, 1000);
+    CHECK(!hills.Meshlets.empty() && hills.Meshlets[0].VertexCount == 256);
+    CheckMeshlets(hills, 256, 1000);
+}
+
+static void TestMeshletCulling()
+{
+    Primitives::Plane flat(GRID_SIZE, GRID_SIZE, GRID_VERTICES, GRID_VERTICES);
+    MeshOptimizer::BuildMeshlets(flat);
+
+    //Every meshlet of a flat grid faces the same way, so has a cone which can reject it
+    const float facing = flat.Meshlets.empty() ? 0.0f : flat.Meshlets[0].ConeAxis.y;
+    CHECK(fabsf(facing) > 0.99f);
+    for (const auto& meshlet : flat.Meshlets)
+    {
+        CHECK(meshlet.ConeCutoff < 1.0f && meshlet.ConeAxis.y == facing);
+    }
+
+    //The camera looks down +z from the origin. The grid lies ahead of it, either below or above the camera.
+    const Frustrum frustrum = {};
+    const Matrix4x4 view = {};
+    const uint32_t triangles = (uint32_t)flat.Indices.size() / 3;
+    std::vector<uint32_t> visible;
+    MeshOptimizer::MeshletCullStats stats;
+
+    //Seen from the side its triangles face, nothing is culled
+    const float front = facing > 0.0f ? -2.0f : 2.0f;
+    CHECK(MeshOptimizer::CullMeshlets(flat, Math::MatrixTranslation({ 0.0f, front, 10.0f }), view, {}, frustrum, visible, &stats) == flat.Meshlets.size());
+    CHECK(stats.Triangles == triangles && stats.CulledTriangles == 0);
+
+    //Seen from behind, every meshlet is rejected by its cone
+    CHECK(MeshOptimizer::CullMeshlets(flat, Math::MatrixTranslation({ 0.0f, -front, 10.0f }), view, {}, frustrum, visible, &stats) == 0);
+    CHECK(stats.BackfaceCulledMeshlets == flat.Meshlets.size() && stats.CulledTriangles == triangles);
+
+    //Behind the camera, every meshlet is rejected by the frustrum
+    CHECK(MeshOptimizer::CullMeshlets(flat, Math::MatrixTranslation({ 0.0f, front, -20.0f }), view, {}, frustrum, visible, &stats) == 0);
+    CHECK(stats.FrustrumCulledMeshlets == flat.Meshlets.size() && stats.CulledTriangles == triangles);
+}
+
+int main()
+{
+    TestFlatGrid();
+    TestLODChain();
+    TestMaxError();
+    TestSelectLOD();
+    TestMeshletLimits();
+    TestMeshletCulling();
+
+    return Test::Failures;
+}
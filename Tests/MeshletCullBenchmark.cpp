@@ -0,0 +1,135 @@
+#include "IO/MeshOptimizer.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <vector>
+
+//Meshlet Cull Benchmark
+//Splits procedural sample meshes into meshlets, then culls them from a ring of cameras around each mesh,
+//reporting the share of triangles rejected by the frustrum and by back-face cones, and the time to cull.
+//Ewan Burnett - 2022
+
+using namespace Engine;
+
+static constexpr float PI = 3.14159265f;
+static constexpr uint32_t VIEW_COUNT = 16;
+static constexpr uint32_t CULL_COUNT = 200;        //Per view
+
+/**
+ * \brief Builds a grid of rows x slices vertices, placed by a function of their row and slice.
+ * Triangles are wound as Primitives::Plane's, so they face along the cross product of the row and slice directions.
+ */
+static MeshFilter MakeGrid(const char* name, uint32_t rows, uint32_t slices, const std::function<Vector3f(float, float)>& position)
+{
+    MeshFilter mesh;
+    mesh.Name = name;
+    for (uint32_t i = 0; i < rows; i++)
+    {
+        for (uint32_t j = 0; j < slices; j++)
+        {
+            mesh.Vertices.emplace_back(position((float)i / (rows - 1), (float)j / (slices - 1)));
+        }
+    }
+
+    for (uint32_t i = 0; i < rows - 1; i++)
+    {
+        for (uint32_t j = 0; j < slices - 1; j++)
+        {
+            mesh.Indices.insert(mesh.Indices.end(), { i * slices + j, i * slices + j + 1, (i + 1) * slices + j });
+            mesh.Indices.insert(mesh.Indices.end(), { (i + 1) * slices + j, i * slices + j + 1, (i + 1) * slices + j + 1 });
+        }
+    }
+
+    return mesh;
+}
+
+/**
+ * \brief Sample meshes, each about two units across and centred on the origin.
+ */
+static std::vector<MeshFilter> MakeSamples()
+{
+    std::vector<MeshFilter> samples;
+
+    samples.emplace_back(MakeGrid("Sphere", 129, 257, [](float v, float u)
+    {
+        const float theta = v * PI;
+        const float phi = u * 2.0f * PI;
+        return Vector3f{ sinf(theta) * cosf(phi), cosf(theta), sinf(theta) * sinf(phi) };
+    }));
+
+    samples.emplace_back(MakeGrid("Torus", 257, 65, [](float u, float v)
+    {
+        const float phi = u * 2.0f * PI;
+        const float theta = v * 2.0f * PI;
+        const float ring = 0.75f + 0.25f * cosf(theta);
+        return Vector3f{ ring * cosf(phi), 0.25f * sinf(theta), ring * sinf(phi) };
+    }));
+
+    samples.emplace_back(MakeGrid("Hills", 257, 257, [](float z, float x)
+    {
+        const float px = x * 2.0f - 1.0f;
+        const float pz = 1.0f - z * 2.0f;
+        return Vector3f{ px, 0.1f * sinf(px * 10.0f) * cosf(pz * 10.0f), pz };
+    }));
+
+    return samples;
+}
+
+static void Run(MeshFilter& mesh)
+{
+    MeshOptimizer::BuildMeshlets(mesh);
+
+    const Frustrum frustrum = {};
+    const Matrix4x4 world = {};
+    std::vector<uint32_t> visible;
+
+    uint64_t triangles = 0;
+    uint64_t culledTriangles = 0;
+    uint64_t meshlets = 0;
+    uint64_t frustrumCulled = 0;
+    uint64_t backfaceCulled = 0;
+    double cullTime = 0.0;
+
+    //Orbit the mesh from above, alternating between views of the whole mesh, and close views past its edge
+    for (uint32_t view = 0; view < VIEW_COUNT; view++)
+    {
+        const float angle = view * 2.0f * PI / VIEW_COUNT;
+        const bool close = view % 2 == 1;
+        const float distance = close ? 1.5f : 4.0f;
+        const Vector3f position = { cosf(angle) * distance, distance * 0.5f, sinf(angle) * distance };
+        const Vector3f target = close ? position + Vector3f{ -sinf(angle), -0.5f, cosf(angle) } : Vector3f{};
+
+        Vector3f forward = Math::Normalize(target - position);
+        Vector3f up = { 0.0f, 1.0f, 0.0f };
+        Vector3f right = Math::Normalize(Math::Cross(up, forward));
+        const Matrix4x4 viewMatrix = Math::MatrixView(position, right, up, forward);
+
+        MeshOptimizer::MeshletCullStats stats;
+        const auto start = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < CULL_COUNT; i++)
+        {
+            MeshOptimizer::CullMeshlets(mesh, world, viewMatrix, position, frustrum, visible, &stats);
+        }
+        cullTime += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / CULL_COUNT;
+
+        triangles += stats.Triangles;
+        culledTriangles += stats.CulledTriangles;
+        meshlets += stats.Meshlets;
+        frustrumCulled += stats.FrustrumCulledMeshlets;
+        backfaceCulled += stats.BackfaceCulledMeshlets;
+    }
+
+    printf("%-6s %6zu triangles in %4zu meshlets: %5.1f%% of triangles culled. %5.1f%% of meshlets culled by the frustrum, %5.1f%% by cones. %.2fus per cull (mean of %u views)\n",
+        mesh.Name.c_str(), mesh.Indices.size() / 3, mesh.Meshlets.size(), 100.0 * culledTriangles / triangles,
+        100.0 * frustrumCulled / meshlets, 100.0 * backfaceCulled / meshlets, cullTime / VIEW_COUNT, VIEW_COUNT);
+}
+
+int main()
+{
+    for (auto& sample : MakeSamples())
+    {
+        Run(sample);
+    }
+    return 0;
+}
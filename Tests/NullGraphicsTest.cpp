@@ -0,0 +1,177 @@
+#include "Graphics/Backends/Null_GFX.h"
+#include "Test.h"
+#include <vector>
+
+//Null Graphics Test
+//Drives the headless backend through each of its draw paths, without a window, and checks the work it reports.
+//Ewan Burnett - 2022
+
+using namespace Engine;
+
+static constexpr uint32_t MESH_COUNT = 8;
+static constexpr uint32_t MATERIAL_COUNT = 4;
+static constexpr uint32_t DRAW_COUNT = 1000;
+
+int main()
+{
+    Null_GFX gfx;
+    CHECK(gfx.Init());
+
+    Camera camera;
+    camera.ComputeViewProjection();
+
+    std::vector<Primitives::Cube> meshes(MESH_COUNT);
+    std::vector<Blinn> materials(MATERIAL_COUNT);
+    std::vector<MeshRenderer> renderers(MATERIAL_COUNT);
+    for (uint32_t i = 0; i < MATERIAL_COUNT; i++)
+    {
+        renderers[i].shader = EShaderType::Blinn;
+        renderers[i].material = &materials[i];
+    }
+
+    std::vector<Matrix4x4> worlds(DRAW_COUNT);
+    for (uint32_t i = 0; i < DRAW_COUNT; i++)
+    {
+        worlds[i]._matrix._43 = (float)(i % 97);
+    }
+
+    //Immediate draws only upload each mesh once
+    RenderStats first;
+    for (uint32_t frame = 0; frame < 2; frame++)
+    {
+        for (uint32_t i = 0; i < DRAW_COUNT; i++)
+        {
+            gfx.Draw(worlds[i], meshes[i % MESH_COUNT], renderers[i % MATERIAL_COUNT], camera);
+        }
+        gfx.Present();
+
+        const RenderStats& stats = gfx.GetFrameStats();
+        CHECK(stats.DrawCalls == DRAW_COUNT);
+        if (frame == 0)
+        {
+            first = stats;
+            CHECK(stats.BytesUploaded > 0);
+        }
+        else
+        {
+            CHECK(stats.BytesUploaded == 0);
+        }
+    }
+
+    //Copies and moves of a mesh keep its buffers, wherever they live
+    std::vector<Primitives::Cube> moved(meshes.begin(), meshes.end());
+    moved.reserve(moved.capacity() * 2);
+    for (uint32_t i = 0; i < MESH_COUNT; i++)
+    {
+        gfx.Draw(worlds[i], moved[i], renderers[0], camera);
+    }
+    gfx.Present();
+    CHECK(gfx.GetFrameStats().DrawCalls == MESH_COUNT);
+    CHECK(gfx.GetFrameStats().BytesUploaded == 0);
+
+    //A mesh whose handle is reset is uploaded again
+    moved[0].Buffers = {};
+    gfx.Draw(worlds[0], moved[0], renderers[0], camera);
+    gfx.Present();
+    CHECK(gfx.GetFrameStats().BytesUploaded > 0);
+
+    //Repeated immediate draws of one material and world only set their state once. The first frame binds the mesh.
+    RenderStats single;
+    for (uint32_t frame = 0; frame < 2; frame++)
+    {
+        gfx.Draw(worlds[0], meshes[0], renderers[0], camera);
+        gfx.Present();
+        single = gfx.GetFrameStats();
+    }
+    for (uint32_t i = 0; i < DRAW_COUNT; i++)
+    {
+        gfx.Draw(worlds[0], meshes[0], renderers[0], camera);
+    }
+    gfx.Present();
+    CHECK_MSG(gfx.GetFrameStats().Binds == single.Binds, "%u binds, %u for one draw", gfx.GetFrameStats().Binds, single.Binds);
+
+    //Draws which only differ by their world matrix set it, and apply the pass, but keep the material
+    for (uint32_t i = 0; i < DRAW_COUNT; i++)
+    {
+        gfx.Draw(worlds[i], meshes[0], renderers[0], camera);
+    }
+    gfx.Present();
+    CHECK_MSG(gfx.GetFrameStats().Binds == single.Binds + 2 * (DRAW_COUNT - 1), "%u binds, %u for one draw", gfx.GetFrameStats().Binds, single.Binds);
+
+    //A sorted queue draws the same commands with fewer state changes
+    RenderQueue queue;
+    queue.Begin(camera.Position, camera.Forward);
+    for (uint32_t i = 0; i < DRAW_COUNT; i++)
+    {
+        queue.Submit(worlds[i], meshes[i % MESH_COUNT], renderers[i % MATERIAL_COUNT]);
+    }
+    queue.End();
+
+    gfx.Draw(queue, camera);
+    gfx.Present();
+    const RenderStats queued = gfx.GetFrameStats();
+    CHECK(queued.DrawCalls == DRAW_COUNT);
+    CHECK(queued.Binds < first.Binds);
+
+    //Recording on several threads replays the same draws
+    gfx.SetSubmissionThreads(4);
+    gfx.Draw(queue, camera);
+    gfx.Present();
+    CHECK(gfx.GetFrameStats().DrawCalls == DRAW_COUNT);
+    gfx.SetSubmissionThreads(1);
+
+    //Instances are drawn once per mesh and renderer
+    InstanceBatch instances;
+    instances.Begin();
+    for (uint32_t i = 0; i < DRAW_COUNT; i++)
+    {
+        instances.Add(meshes[i % MESH_COUNT], renderers[i % MATERIAL_COUNT], worlds[i]);
+    }
+    instances.End();
+
+    gfx.Draw(instances, camera);
+    gfx.Present();
+    CHECK(gfx.GetFrameStats().DrawCalls == instances.GetGroups().size());
+    CHECK(gfx.GetFrameStats().BytesUploaded == DRAW_COUNT * sizeof(Matrix4x4));
+
+    //Sprites are drawn once per batched range
+    std::vector<Sprite> sprites(16);
+    SpriteBatch batch;
+    batch.Begin();
+    for (const auto& sprite : sprites)
+    {
+        batch.Add(sprite);
+    }
+    batch.End();
+
+    gfx.Draw(batch, camera);
+    gfx.Present();
+    CHECK(batch.GetSpriteCount() == sprites.size());
+    CHECK(gfx.GetFrameStats().DrawCalls == batch.GetRanges().size());
+
+    //Text streams through the upload rings, every frame
+    Font font;
+    font.Size = { 256, 256 };
+    for (uint32_t c = 32; c < 127; c++)
+    {
+        font.AddGlyph(c, { 0.0f, 0.0f, 8, 12, 0, 0, 9 });
+    }
+
+    Text text("Score: 100", font, { 10, 10 });
+    Matrix4x4 identity;
+    for (uint32_t frame = 0; frame < 8; frame++)
+    {
+        gfx.Draw(identity, text, camera);
+        gfx.Present();
+        CHECK(gfx.GetFrameStats().DrawCalls == 1);
+        CHECK(gfx.GetFrameStats().BytesUploaded > 0);
+    }
+
+    //Released meshes are uploaded again
+    gfx.ReleaseResources();
+    gfx.Draw(worlds[0], meshes[0], renderers[0], camera);
+    gfx.Present();
+    CHECK(gfx.GetFrameStats().BytesUploaded > 0);
+
+    return Test::Failures;
+}
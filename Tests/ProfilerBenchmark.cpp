@@ -0,0 +1,116 @@
+#include "Core/Profiler.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <memory>
+
+//Profiler Benchmark
+//Times the overhead of a zone: ThreadBuffer::Begin() alone, Begin() with its End(), and a whole PROFILE_SCOPE()
+//when recording is enabled, disabled, and when the thread's buffer is full.
+//Ewan Burnett - 2022
+
+using namespace Engine;
+
+static constexpr uint32_t ZONE_COUNT = 30000;      //Per run. Fits in a buffer, with space kept for the ends.
+static constexpr uint32_t RUN_COUNT = 50;
+static constexpr double BEGIN_BUDGET = 20.0;       //Nanoseconds per enabled zone
+
+static const Profiler::Zone ZONE = { "Zone" };
+
+/**
+ * \brief Times ZONE_COUNT calls of a function, returning the best of several runs, in nanoseconds per call. The setup isn't timed.
+ */
+static double Time(const std::function<void()>& setup, const std::function<void()>& run)
+{
+    double best = 1e9;
+    for (uint32_t i = 0; i < RUN_COUNT; i++)
+    {
+        setup();
+        const auto start = std::chrono::steady_clock::now();
+        run();
+        best = std::min(best, std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / ZONE_COUNT);
+    }
+    return best;
+}
+
+static void Leaf()
+{
+    PROFILE_SCOPE("Leaf");
+}
+
+int main()
+{
+    //Standalone buffers, so that nothing needs to drain them
+    std::unique_ptr<Profiler::ThreadBuffer> buffer;
+    const auto reset = [&] { buffer = std::make_unique<Profiler::ThreadBuffer>(); };
+
+    const double ticks = Time([] {}, []
+    {
+        uint64_t sum = 0;
+        for (uint32_t i = 0; i < ZONE_COUNT; i++)
+        {
+            sum += Profiler::ReadTicks();
+        }
+        volatile uint64_t sink = sum;
+        (void)sink;
+    });
+
+    const double begin = Time(reset, [&]
+    {
+        for (uint32_t i = 0; i < ZONE_COUNT; i++)
+        {
+            buffer->Begin(&ZONE);
+        }
+    });
+
+    const double beginEnd = Time(reset, [&]
+    {
+        for (uint32_t i = 0; i < ZONE_COUNT; i++)
+        {
+            buffer->Begin(&ZONE);
+            buffer->End();
+        }
+    });
+
+    //Scopes record into the thread's registered buffer, which is drained between runs
+    const double enabled = Time([] { Profiler::EndFrame(); }, []
+    {
+        for (uint32_t i = 0; i < ZONE_COUNT; i++)
+        {
+            Leaf();
+        }
+    });
+
+    Profiler::SetEnabled(false);
+    const double disabled = Time([] {}, []
+    {
+        for (uint32_t i = 0; i < ZONE_COUNT; i++)
+        {
+            Leaf();
+        }
+    });
+    Profiler::SetEnabled(true);
+
+    //Fill the buffer without draining it, so that every timed zone is dropped
+    Profiler::EndFrame();
+    for (uint32_t i = 0; i < Profiler::ThreadBuffer::CAPACITY; i++)
+    {
+        Leaf();
+    }
+    const double full = Time([] {}, []
+    {
+        for (uint32_t i = 0; i < ZONE_COUNT; i++)
+        {
+            Leaf();
+        }
+    });
+    Profiler::EndFrame();
+
+    printf("ReadTicks: %.2fns\n", ticks);
+    printf("ThreadBuffer::Begin: %.2fns (budget %.0fns)%s\n", begin, BEGIN_BUDGET, begin > BEGIN_BUDGET ? " OVER BUDGET" : "");
+    printf("ThreadBuffer::Begin and End: %.2fns\n", beginEnd);
+    printf("PROFILE_SCOPE: %.2fns enabled, %.2fns disabled, %.2fns with a full buffer\n", enabled, disabled, full);
+    printf("(Per zone, best of %u runs of %u zones)\n", RUN_COUNT, ZONE_COUNT);
+    return 0;
+}
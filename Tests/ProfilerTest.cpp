@@ -0,0 +1,220 @@
+#include "Core/Profiler.h"
+#include "Test.h"
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+//Profiler Test
+//Records nested zones and checks their inclusive and exclusive times, records the same zones from several threads
+//and checks that they're merged by their position in the tree, and fills a thread's buffer, checking that zones
+//which don't fit are dropped whole, rather than leaving an unmatched begin or end.
+//Ewan Burnett - 2022
+
+using namespace Engine;
+
+static constexpr uint32_t THREAD_COUNT = 4;
+static constexpr uint32_t CALL_COUNT = 1000;       //Per thread
+static constexpr uint32_t FILL_COUNT = Profiler::ThreadBuffer::CAPACITY;   //Twice as many events as fit
+
+/**
+ * \brief Waits for a number of milliseconds without sleeping, so that the time is spent within the zone.
+ */
+static void Spin(double milliseconds)
+{
+    const auto start = std::chrono::steady_clock::now();
+    while (std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() < milliseconds)
+    {
+    }
+}
+
+/**
+ * \brief Finds a zone in the last frame's statistics, by its name and depth.
+ */
+static const Profiler::ZoneStats* Find(const std::vector<Profiler::ZoneStats>& stats, const char* name, uint32_t depth)
+{
+    for (const auto& zone : stats)
+    {
+        if (zone.Depth == depth && strcmp(zone.Name, name) == 0)
+        {
+            return &zone;
+        }
+    }
+    return nullptr;
+}
+
+static void Inner()
+{
+    PROFILE_SCOPE("Inner");
+    Spin(5.0);
+}
+
+static void Outer()
+{
+    PROFILE_SCOPE("Outer");
+    Spin(10.0);
+    Inner();
+    Inner();
+}
+
+static void TestNested()
+{
+    Profiler::EndFrame();
+
+    Outer();
+    Profiler::EndFrame();
+
+    const auto stats = Profiler::GetFrameStats();
+    const Profiler::ZoneStats* outer = Find(stats, "Outer", 0);
+    const Profiler::ZoneStats* inner = Find(stats, "Inner", 1);
+    CHECK(outer != nullptr && inner != nullptr);
+    if (outer == nullptr || inner == nullptr)
+    {
+        return;
+    }
+
+    //Children follow their parent
+    CHECK(inner == outer + 1);
+    CHECK(outer->Calls == 1);
+    CHECK(inner->Calls == 2);
+
+    //The spins give lower bounds. Preemption may only add to them.
+    CHECK_MSG(inner->Inclusive >= 9.0, "%.3fms", inner->Inclusive);
+    CHECK(inner->Exclusive == inner->Inclusive);
+    CHECK_MSG(outer->Exclusive >= 9.0, "%.3fms", outer->Exclusive);
+    CHECK_MSG(std::abs(outer->Exclusive - (outer->Inclusive - inner->Inclusive)) < 1e-6, "%.6fms exclusive, %.6fms inclusive, %.6fms in children",
+        outer->Exclusive, outer->Inclusive, inner->Inclusive);
+
+    //Nothing is recorded again in a frame without zones
+    Profiler::EndFrame();
+    CHECK(Profiler::GetFrameStats().empty());
+}
+
+static void Leaf()
+{
+    PROFILE_SCOPE("Leaf");
+}
+
+static void Branch()
+{
+    PROFILE_SCOPE("Branch");
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        Leaf();
+    }
+}
+
+static void TestMerge()
+{
+    Profiler::EndFrame();
+
+    //Leaf is also called outside of Branch, which is a separate position in the tree
+    std::vector<std::thread> threads;
+    for (uint32_t t = 0; t < THREAD_COUNT; t++)
+    {
+        threads.emplace_back([]
+        {
+            for (uint32_t i = 0; i < CALL_COUNT; i++)
+            {
+                Branch();
+                Leaf();
+            }
+        });
+    }
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    //The threads have exited, so their buffers are only drained by this
+    Profiler::EndFrame();
+
+    const auto stats = Profiler::GetFrameStats();
+    CHECK_MSG(stats.size() == 3, "%zu zones", stats.size());
+
+    const Profiler::ZoneStats* branch = Find(stats, "Branch", 0);
+    const Profiler::ZoneStats* nested = Find(stats, "Leaf", 1);
+    const Profiler::ZoneStats* leaf = Find(stats, "Leaf", 0);
+    CHECK(branch != nullptr && nested != nullptr && leaf != nullptr);
+    if (branch == nullptr || nested == nullptr || leaf == nullptr)
+    {
+        return;
+    }
+
+    CHECK(nested == branch + 1);
+    CHECK_MSG(branch->Calls == THREAD_COUNT * CALL_COUNT, "%u calls", branch->Calls);
+    CHECK_MSG(nested->Calls == THREAD_COUNT * CALL_COUNT * 3, "%u calls", nested->Calls);
+    CHECK_MSG(leaf->Calls == THREAD_COUNT * CALL_COUNT, "%u calls", leaf->Calls);
+    CHECK(branch->Inclusive >= nested->Inclusive);
+
+    //The exited threads' zones aren't counted again
+    Profiler::EndFrame();
+    CHECK(Profiler::GetFrameStats().empty());
+}
+
+static void TestFull()
+{
+    Profiler::EndFrame();
+
+    //Without a frame ending, the buffer fills part way through the loop
+    {
+        PROFILE_SCOPE("Fill");
+        for (uint32_t i = 0; i < FILL_COUNT; i++)
+        {
+            Leaf();
+        }
+    }
+    Profiler::EndFrame();
+
+    const auto stats = Profiler::GetFrameStats();
+    const Profiler::ZoneStats* fill = Find(stats, "Fill", 0);
+    const Profiler::ZoneStats* leaf = Find(stats, "Leaf", 1);
+    CHECK(fill != nullptr && leaf != nullptr);
+    if (fill == nullptr || leaf == nullptr)
+    {
+        return;
+    }
+
+    //The outer zone's end was kept, and each leaf which fit was kept whole, two events apiece
+    CHECK(fill->Calls == 1);
+    CHECK_MSG(leaf->Calls < FILL_COUNT && leaf->Calls >= FILL_COUNT / 2 - 2, "%u of %u leaves", leaf->Calls, FILL_COUNT);
+    CHECK(stats.size() == 2);
+
+    //Once drained, the buffer records everything again
+    {
+        PROFILE_SCOPE("Fill");
+        for (uint32_t i = 0; i < CALL_COUNT; i++)
+        {
+            Leaf();
+        }
+    }
+    Profiler::EndFrame();
+
+    const auto drained = Profiler::GetFrameStats();
+    leaf = Find(drained, "Leaf", 1);
+    CHECK(leaf != nullptr && leaf->Calls == CALL_COUNT);
+}
+
+static void TestDisabled()
+{
+    Profiler::EndFrame();
+
+    Profiler::SetEnabled(false);
+    Branch();
+    Profiler::SetEnabled(true);
+
+    Profiler::EndFrame();
+    CHECK(Profiler::GetFrameStats().empty());
+}
+
+int main()
+{
+    TestNested();
+    TestMerge();
+    TestFull();
+    TestDisabled();
+
+    return Test::Failures;
+}
@@ -0,0 +1,179 @@
+#include "Graphics/RenderQueue.h"
+#include "Test.h"
+#include <algorithm>
+#include <random>
+#include <vector>
+
+//Render Queue Test
+//Submits random commands across every layer, and checks the order they're sorted into, and that
+//partitioning the sorted commands covers them exactly once, in order, with boundaries on state changes.
+//Ewan Burnett - 2022
+
+using namespace Engine;
+
+static constexpr uint32_t COMMAND_COUNT = 4000;
+static constexpr uint32_t RENDERER_COUNT = 16;
+
+/**
+ * \brief Each command's world matrix records its submission index in x, and its depth in z.
+ */
+static uint32_t GetIndex(const RenderCommand& command)
+{
+    return (uint32_t)command.World._matrix._41;
+}
+
+static float GetDepth(const RenderCommand& command)
+{
+    return command.World._matrix._43;
+}
+
+static bool SameState(const RenderCommand& a, const RenderCommand& b)
+{
+    return a.Renderer->shader == b.Renderer->shader && a.Technique == b.Technique && a.Material == b.Material;
+}
+
+static ERenderLayer GetLayer(const RenderCommand& command)
+{
+    return (ERenderLayer)(command.Key >> (64 - RenderQueue::LAYER_BITS));
+}
+
+static void TestSort(const RenderQueue& queue)
+{
+    const auto& commands = queue.GetCommands();
+    CHECK(commands.size() == COMMAND_COUNT);
+
+    //Every command is drawn exactly once
+    std::vector<bool> seen(COMMAND_COUNT, false);
+    for (const auto& command : commands)
+    {
+        const uint32_t index = GetIndex(command);
+        CHECK(index < COMMAND_COUNT && !seen[index]);
+        seen[index % COMMAND_COUNT] = true;
+    }
+
+    for (size_t i = 1; i < commands.size(); i++)
+    {
+        const RenderCommand& a = commands[i - 1];
+        const RenderCommand& b = commands[i];
+
+        //Keys never decrease, and equal keys keep their submission order
+        CHECK(a.Key <= b.Key);
+        if (a.Key == b.Key)
+        {
+            CHECK(GetIndex(a) < GetIndex(b));
+        }
+
+        CHECK(GetLayer(a) <= GetLayer(b));
+        if (GetLayer(a) != GetLayer(b))
+        {
+            continue;
+        }
+
+        switch (GetLayer(b))
+        {
+        case ERenderLayer::Opaque:
+            //Front-to-back within each state
+            if (SameState(a, b))
+            {
+                CHECK(GetDepth(a) <= GetDepth(b));
+            }
+            break;
+        case ERenderLayer::Transparent:
+            CHECK(GetDepth(a) >= GetDepth(b));
+            break;
+        case ERenderLayer::Overlay:
+            CHECK(GetIndex(a) < GetIndex(b));
+            break;
+        }
+    }
+}
+
+static void TestPartition(const RenderQueue& queue)
+{
+    const auto& commands = queue.GetCommands();
+    const uint32_t count = (uint32_t)commands.size();
+    std::vector<CommandRange> ranges;
+
+    for (uint32_t maxRanges = 1; maxRanges <= 8; maxRanges++)
+    {
+        for (uint32_t minCommands : { 1u, 128u, 1000u, 100000u })
+        {
+            queue.Partition(maxRanges, minCommands, ranges);
+
+            //Ranges never exceed the limit, nor split the queue finer than the minimum
+            const uint32_t rangeCount = std::clamp(count / minCommands, 1u, maxRanges);
+            CHECK_MSG(!ranges.empty() && ranges.size() <= rangeCount, "%zu ranges, for %u at most", ranges.size(), rangeCount);
+
+            //Replaying the ranges in order replays the queue in order
+            uint32_t next = 0;
+            for (const auto& range : ranges)
+            {
+                CHECK(range.FirstCommand == next);
+                CHECK(range.CommandCount > 0);
+                next += range.CommandCount;
+            }
+            CHECK(next == count);
+
+            //Boundaries are on state changes, unless there's none within a quarter of a range after them
+            const uint32_t slack = count / rangeCount / 4;
+            for (size_t r = 1; r < ranges.size(); r++)
+            {
+                const uint32_t boundary = ranges[r].FirstCommand;
+                if (SameState(commands[boundary - 1], commands[boundary]))
+                {
+                    for (uint32_t b = boundary; b <= std::min(boundary + slack, count - 1); b++)
+                    {
+                        CHECK_MSG(SameState(commands[b - 1], commands[b]), "boundary %u skipped a state change at %u", boundary, b);
+                    }
+                }
+            }
+        }
+    }
+
+    queue.Partition(0, 1, ranges);
+    CHECK(ranges.empty());
+}
+
+int main()
+{
+    std::vector<Primitives::Cube> meshes(4);
+    std::vector<Basic> basics(RENDERER_COUNT);
+    std::vector<Blinn> blinns(RENDERER_COUNT);
+    std::vector<MeshRenderer> renderers(RENDERER_COUNT);
+    for (uint32_t i = 0; i < RENDERER_COUNT; i++)
+    {
+        renderers[i].shader = i % 2 == 0 ? EShaderType::Basic : EShaderType::Blinn;
+        renderers[i].material = i % 2 == 0 ? (MaterialData*)&basics[i] : (MaterialData*)&blinns[i];
+        renderers[i].technique = i % 4 < 2 ? "" : "High";
+    }
+
+    std::mt19937 rng(1);
+    RenderQueue queue;
+    for (uint32_t frame = 0; frame < 2; frame++)
+    {
+        queue.Begin({ 0, 0, -10 }, { 0, 0, 1 });
+        for (uint32_t i = 0; i < COMMAND_COUNT; i++)
+        {
+            Matrix4x4 world;
+            world._matrix._41 = (float)i;
+            world._matrix._43 = (float)(rng() % 100);
+
+            const uint32_t roll = rng() % 10;
+            const ERenderLayer layer = roll < 6 ? ERenderLayer::Opaque : (roll < 9 ? ERenderLayer::Transparent : ERenderLayer::Overlay);
+            queue.Submit(world, meshes[rng() % meshes.size()], renderers[rng() % RENDERER_COUNT], layer);
+        }
+        queue.End();
+
+        TestSort(queue);
+        TestPartition(queue);
+    }
+
+    //An empty queue has nothing to partition
+    std::vector<CommandRange> ranges;
+    queue.Begin({ 0, 0, 0 }, { 0, 0, 1 });
+    queue.End();
+    queue.Partition(4, 1, ranges);
+    CHECK(queue.GetCommands().empty() && ranges.empty());
+
+    return Test::Failures;
+}
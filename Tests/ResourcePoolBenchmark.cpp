@@ -0,0 +1,108 @@
+#include "IO/ResourcePool.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+//Resource Pool Benchmark
+//Times resolving texture handles from up to 16 threads at once, as when recording draws in parallel,
+//both on their own and while another thread keeps adding textures.
+//Built against the device stubs in Stubs/, so that it runs headless. Textures are stub views, which are
+//reference counted as the device's are, so resolving one costs what it costs with a device.
+//Ewan Burnett - 2022
+
+using namespace Engine;
+
+static constexpr uint32_t TEXTURE_COUNT = 1024;
+static constexpr uint32_t LOOKUP_COUNT = 1000000;
+static constexpr uint32_t RUN_COUNT = 5;
+
+/**
+ * \brief Creates a view of a 256x256 BC1 texture.
+ */
+static ResourcePool::texture CreateTexture()
+{
+    ID3D11Texture2D* texture = new ID3D11Texture2D({ 256, 256, 1, 1, DXGI_FORMAT_BC1_UNORM });
+    ResourcePool::texture view;
+    *view.GetAddressOf() = new ID3D11ShaderResourceView(texture);
+    texture->Release();
+    return view;
+}
+
+static void Run(const std::vector<TextureHandle>& handles, uint32_t threadCount, bool adding)
+{
+    double best = 1e9;
+    for (uint32_t run = 0; run < RUN_COUNT; run++)
+    {
+        std::atomic<bool> done = false;
+        std::atomic<uintptr_t> sink = 0;
+        std::vector<std::thread> threads;
+
+        //Keeps taking the pool's locks exclusively, as loading on a worker would
+        std::thread writer;
+        if (adding)
+        {
+            writer = std::thread([&]
+            {
+                for (uint32_t i = 0; !done; i++)
+                {
+                    ResourcePool::AddTexture(CreateTexture(), L"Resources\\Benchmark\\Added" + std::to_wstring(i % 64) + L".dds");
+                }
+            });
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        for (uint32_t t = 0; t < threadCount; t++)
+        {
+            threads.emplace_back([&, t]
+            {
+                //Each thread walks the textures from a different offset, as each records different draws
+                uintptr_t sum = 0;
+                for (uint32_t i = 0; i < LOOKUP_COUNT; i++)
+                {
+                    sum += (uintptr_t)ResourcePool::GetTexture(handles[(i + t * 61) % TEXTURE_COUNT]).Get();
+                }
+                sink += sum;
+            });
+        }
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+        const auto end = std::chrono::steady_clock::now();
+
+        done = true;
+        if (writer.joinable())
+        {
+            writer.join();
+        }
+
+        best = std::min(best, std::chrono::duration<double, std::milli>(end - start).count());
+    }
+
+    const double lookups = (double)LOOKUP_COUNT * threadCount;
+    printf("%2u threads%s: %.3fms for %.0f lookups, %.2fns per lookup, %.1fM lookups/s (best of %u)\n",
+        threadCount, adding ? ", adding" : "", best, lookups, best * 1e6 / lookups, lookups / best / 1e3, RUN_COUNT);
+}
+
+int main()
+{
+    std::vector<TextureHandle> handles;
+    for (uint32_t i = 0; i < TEXTURE_COUNT; i++)
+    {
+        handles.push_back(ResourcePool::AddTexture(CreateTexture(), L"Resources\\Benchmark\\Texture" + std::to_wstring(i) + L".dds"));
+    }
+
+    printf("%u hardware threads\n", std::thread::hardware_concurrency());
+    for (uint32_t threadCount : { 1u, 2u, 4u, 8u, 16u })
+    {
+        Run(handles, threadCount, false);
+    }
+    Run(handles, 16, true);
+
+    ResourcePool::Shutdown();
+    return 0;
+}
@@ -0,0 +1,69 @@
+#include "Graphics/Backends/Null_GFX.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+//Sprite Batch Benchmark
+//Times batching 100k sprites per frame, submitted both already grouped and interleaved across atlases
+//and techniques, and drawing the batch through the headless backend.
+//Ewan Burnett - 2022
+
+using namespace Engine;
+
+static const wchar_t* ATLASES[] = { L"Resources\\a.png", L"Resources\\b.png", L"Resources\\c.png", L"Resources\\d.png" };
+static constexpr uint32_t ATLAS_COUNT = 4;
+static constexpr uint32_t SPRITE_COUNT = 100000;
+static constexpr uint32_t FRAME_COUNT = 30;
+
+static void Run(const char* name, bool interleaved)
+{
+    std::vector<Sprite> sprites;
+    sprites.reserve(SPRITE_COUNT);
+    for (uint32_t i = 0; i < SPRITE_COUNT; i++)
+    {
+        const uint32_t atlas = interleaved ? (i * 7) % ATLAS_COUNT : i / (SPRITE_COUNT / ATLAS_COUNT);
+        Sprite sprite(ATLASES[atlas], { 8, 8 }, { (float)(i % 1000), (float)(i / 1000) }, { 0, 0, 1, 1 });
+        if (interleaved ? i % 3 == 0 : i >= SPRITE_COUNT / 2)
+        {
+            sprite.m_Renderer.technique = "Text";
+        }
+        sprites.push_back(sprite);
+    }
+
+    Null_GFX gfx;
+    gfx.Init();
+    Camera camera;
+
+    SpriteBatch batch;
+    double batchTime = 1e9;
+    double drawTime = 1e9;
+    for (uint32_t frame = 0; frame < FRAME_COUNT; frame++)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        batch.Begin();
+        for (const auto& sprite : sprites)
+        {
+            batch.Add(sprite);
+        }
+        batch.End();
+
+        const auto batched = std::chrono::steady_clock::now();
+        gfx.Draw(batch, camera);
+        gfx.Present();
+        const auto drawn = std::chrono::steady_clock::now();
+
+        batchTime = std::min(batchTime, std::chrono::duration<double, std::milli>(batched - start).count());
+        drawTime = std::min(drawTime, std::chrono::duration<double, std::milli>(drawn - batched).count());
+    }
+
+    printf("%s: %u sprites, %zu ranges, %u draw calls. Batched in %.3fms, drawn in %.3fms (best of %u frames)\n",
+        name, batch.GetSpriteCount(), batch.GetRanges().size(), gfx.GetFrameStats().DrawCalls, batchTime, drawTime, FRAME_COUNT);
+}
+
+int main()
+{
+    Run("Grouped", false);
+    Run("Interleaved", true);
+    return 0;
+}
@@ -0,0 +1,162 @@
+#include "Graphics/SpriteBatch.h"
+#include "Test.h"
+#include <vector>
+
+//Sprite Batch Test
+//Checks that batched sprites are grouped into one range per atlas and technique, in a stable order,
+//and that their quads are transformed as they would be drawn one at a time.
+//Ewan Burnett - 2022
+
+using namespace Engine;
+
+static const wchar_t* ATLASES[] = { L"Resources\\a.png", L"Resources\\b.png", L"Resources\\c.png", L"Resources\\d.png" };
+static constexpr uint32_t ATLAS_COUNT = 4;
+static constexpr uint32_t SPRITE_COUNT = 1000;
+
+/**
+ * \brief Recovers the index of the sprite a quad came from. Sprite i is created at x = i.
+ */
+static uint32_t GetSpriteIndex(const SpriteVertex* quad, const Sprite& sprite)
+{
+    const float corner = sprite.m_Sprite.Vertices[0].x * sprite.transform.Scale.x;
+    return (uint32_t)(quad[0].Position.x - corner + 0.5f);
+}
+
+static std::vector<Sprite> MakeSprites(bool interleaved)
+{
+    std::vector<Sprite> sprites;
+    sprites.reserve(SPRITE_COUNT);
+    for (uint32_t i = 0; i < SPRITE_COUNT; i++)
+    {
+        //Either cycle through the atlases and techniques, or submit them already grouped
+        const uint32_t atlas = interleaved ? (i * 7) % ATLAS_COUNT : i / (SPRITE_COUNT / ATLAS_COUNT);
+        const bool text = interleaved ? i % 3 == 0 : (i % (SPRITE_COUNT / ATLAS_COUNT)) >= SPRITE_COUNT / ATLAS_COUNT / 2;
+
+        Sprite sprite(ATLASES[atlas], { 8, 8 }, { (float)i, 0.0f }, { 0, 0, 1, 1 });
+        if (text)
+        {
+            sprite.m_Renderer.technique = "Text";
+        }
+        sprites.push_back(sprite);
+    }
+
+    return sprites;
+}
+
+static void TestGrouping(bool interleaved)
+{
+    const std::vector<Sprite> sprites = MakeSprites(interleaved);
+
+    SpriteBatch batch;
+    batch.Begin();
+    for (const auto& sprite : sprites)
+    {
+        batch.Add(sprite);
+    }
+    batch.End();
+
+    CHECK(batch.GetSpriteCount() == SPRITE_COUNT);
+    CHECK(batch.GetVertices().size() == SPRITE_COUNT * 4);
+    CHECK(batch.GetIndices().size() == SPRITE_COUNT * 6);
+
+    //One range per atlas and technique, covering every index, in (texture, technique) order
+    const auto& ranges = batch.GetRanges();
+    CHECK_MSG(ranges.size() == ATLAS_COUNT * 2, "%zu ranges", ranges.size());
+
+    uint32_t next = 0;
+    for (size_t r = 0; r < ranges.size(); r++)
+    {
+        const SpriteBatchRange& range = ranges[r];
+        CHECK(range.FirstIndex == next);
+        next += range.IndexCount;
+
+        if (r > 0)
+        {
+            const SpriteBatchRange& previous = ranges[r - 1];
+            CHECK(previous.Texture < range.Texture || (previous.Texture == range.Texture && previous.Technique < range.Technique));
+        }
+
+        //Sprites within a range keep the order they were added in
+        for (uint32_t quad = range.FirstIndex / 6 + 1; quad < (range.FirstIndex + range.IndexCount) / 6; quad++)
+        {
+            CHECK(GetSpriteIndex(&batch.GetVertices()[quad * 4], sprites[0]) > GetSpriteIndex(&batch.GetVertices()[(quad - 1) * 4], sprites[0]));
+        }
+    }
+    CHECK(next == batch.GetIndices().size());
+
+    //Each range's quads come from sprites with its atlas and technique
+    for (const auto& range : ranges)
+    {
+        const uint32_t quad = range.FirstIndex / 6;
+        const uint32_t index = GetSpriteIndex(&batch.GetVertices()[quad * 4], sprites[0]);
+        CHECK(index < SPRITE_COUNT);
+        const Sprite& sprite = sprites[index % SPRITE_COUNT];
+        CHECK(((const SpriteRenderer*)sprite.m_Renderer.material)->TextureAtlas == batch.GetTexture(range.Texture));
+        CHECK(sprite.m_Renderer.technique == batch.GetTechnique(range.Technique));
+    }
+
+    //Every index refers to its own quad
+    const auto& indices = batch.GetIndices();
+    for (uint32_t quad = 0; quad < SPRITE_COUNT; quad++)
+    {
+        for (uint32_t i = 0; i < 6; i++)
+        {
+            CHECK(indices[quad * 6 + i] / 4 == quad);
+        }
+    }
+}
+
+static void TestTransform()
+{
+    //Unrotated sprites take a shortcut, which must match the full world matrix
+    Sprite sprite(ATLASES[0], { 4, 2 }, { 10, 20 }, { 0, 0, 1, 1 });
+    const Matrix4x4 world = Math::MatrixMultiply(Math::MatrixScaling(sprite.transform.Scale), Math::MatrixTranslation(sprite.transform.Position));
+
+    SpriteBatch batch;
+    batch.Begin();
+    batch.Add(sprite);
+    batch.Add(world, sprite);
+    batch.End();
+
+    const auto& vertices = batch.GetVertices();
+    CHECK(vertices.size() == 8);
+    for (uint32_t i = 0; i < 4; i++)
+    {
+        CHECK(vertices[i].Position.x == vertices[i + 4].Position.x);
+        CHECK(vertices[i].Position.y == vertices[i + 4].Position.y);
+        CHECK(vertices[i].TexCoord.x == vertices[i + 4].TexCoord.x);
+        CHECK(vertices[i].TexCoord.y == vertices[i + 4].TexCoord.y);
+    }
+}
+
+static void TestReuse()
+{
+    //Begin() discards the previous frame, but keeps the interned atlases
+    const std::vector<Sprite> sprites = MakeSprites(true);
+
+    SpriteBatch batch;
+    batch.Begin();
+    for (const auto& sprite : sprites)
+    {
+        batch.Add(sprite);
+    }
+    batch.End();
+
+    batch.Begin();
+    batch.Add(sprites[1]);
+    batch.End();
+
+    CHECK(batch.GetSpriteCount() == 1);
+    CHECK(batch.GetRanges().size() == 1);
+    CHECK(batch.GetTexture(batch.GetRanges()[0].Texture) == ((const SpriteRenderer*)sprites[1].m_Renderer.material)->TextureAtlas);
+}
+
+int main()
+{
+    TestGrouping(true);
+    TestGrouping(false);
+    TestTransform();
+    TestReuse();
+
+    return Test::Failures;
+}
@@ -0,0 +1,181 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+//Direct3D 11 Stubs
+//Stand-ins for the device types the resource pool holds, so that the pool can be built and timed headless.
+//Only what the pool uses is declared. Objects are reference counted as COM objects are, and are created
+//with new, rather than by a device.
+//Ewan Burnett - 2022
+
+#ifdef _WIN32
+#include "../../Engine/inc/Framework.h"
+#else
+typedef unsigned int UINT;
+typedef long HRESULT;
+#define FAILED(hr) (((HRESULT)(hr)) < 0)
+#define S_OK ((HRESULT)0)
+#define E_NOINTERFACE ((HRESULT)0x80004002L)
+#endif
+
+enum DXGI_FORMAT
+{
+    DXGI_FORMAT_UNKNOWN = 0,
+    DXGI_FORMAT_R32G32B32A32_TYPELESS = 1,
+    DXGI_FORMAT_R32G32B32A32_FLOAT = 2,
+    DXGI_FORMAT_R32G32B32A32_UINT = 3,
+    DXGI_FORMAT_R32G32B32A32_SINT = 4,
+    DXGI_FORMAT_R32G32B32_TYPELESS = 5,
+    DXGI_FORMAT_R32G32B32_FLOAT = 6,
+    DXGI_FORMAT_R32G32B32_UINT = 7,
+    DXGI_FORMAT_R32G32B32_SINT = 8,
+    DXGI_FORMAT_R16G16B16A16_TYPELESS = 9,
+    DXGI_FORMAT_R16G16B16A16_FLOAT = 10,
+    DXGI_FORMAT_R16G16B16A16_UNORM = 11,
+    DXGI_FORMAT_R16G16B16A16_UINT = 12,
+    DXGI_FORMAT_R16G16B16A16_SNORM = 13,
+    DXGI_FORMAT_R16G16B16A16_SINT = 14,
+    DXGI_FORMAT_R32G32_TYPELESS = 15,
+    DXGI_FORMAT_R32G32_FLOAT = 16,
+    DXGI_FORMAT_R32G32_UINT = 17,
+    DXGI_FORMAT_R32G32_SINT = 18,
+    DXGI_FORMAT_R8G8B8A8_UNORM = 28,
+    DXGI_FORMAT_R8G8_TYPELESS = 48,
+    DXGI_FORMAT_R8G8_UNORM = 49,
+    DXGI_FORMAT_R8G8_UINT = 50,
+    DXGI_FORMAT_R8G8_SNORM = 51,
+    DXGI_FORMAT_R8G8_SINT = 52,
+    DXGI_FORMAT_R16_TYPELESS = 53,
+    DXGI_FORMAT_R16_FLOAT = 54,
+    DXGI_FORMAT_R16_UNORM = 56,
+    DXGI_FORMAT_R16_UINT = 57,
+    DXGI_FORMAT_R16_SNORM = 58,
+    DXGI_FORMAT_R16_SINT = 59,
+    DXGI_FORMAT_R8_TYPELESS = 60,
+    DXGI_FORMAT_R8_UNORM = 61,
+    DXGI_FORMAT_R8_UINT = 62,
+    DXGI_FORMAT_R8_SNORM = 63,
+    DXGI_FORMAT_R8_SINT = 64,
+    DXGI_FORMAT_A8_UNORM = 65,
+    DXGI_FORMAT_BC1_TYPELESS = 70,
+    DXGI_FORMAT_BC1_UNORM = 71,
+    DXGI_FORMAT_BC1_UNORM_SRGB = 72,
+    DXGI_FORMAT_BC2_TYPELESS = 73,
+    DXGI_FORMAT_BC2_UNORM = 74,
+    DXGI_FORMAT_BC2_UNORM_SRGB = 75,
+    DXGI_FORMAT_BC3_TYPELESS = 76,
+    DXGI_FORMAT_BC3_UNORM = 77,
+    DXGI_FORMAT_BC3_UNORM_SRGB = 78,
+    DXGI_FORMAT_BC4_TYPELESS = 79,
+    DXGI_FORMAT_BC4_UNORM = 80,
+    DXGI_FORMAT_BC4_SNORM = 81,
+    DXGI_FORMAT_BC5_TYPELESS = 82,
+    DXGI_FORMAT_BC5_UNORM = 83,
+    DXGI_FORMAT_BC5_SNORM = 84,
+    DXGI_FORMAT_B5G6R5_UNORM = 85,
+    DXGI_FORMAT_B5G5R5A1_UNORM = 86,
+    DXGI_FORMAT_BC6H_TYPELESS = 94,
+    DXGI_FORMAT_BC6H_UF16 = 95,
+    DXGI_FORMAT_BC6H_SF16 = 96,
+    DXGI_FORMAT_BC7_TYPELESS = 97,
+    DXGI_FORMAT_BC7_UNORM = 98,
+    DXGI_FORMAT_BC7_UNORM_SRGB = 99,
+    DXGI_FORMAT_B4G4R4A4_UNORM = 115,
+};
+
+/**
+ * \brief Reference counting, as IUnknown provides. Objects delete themselves when their last reference is released.
+ */
+class StubUnknown
+{
+public:
+    virtual ~StubUnknown() = default;
+
+    UINT AddRef()
+    {
+        return ++m_References;
+    }
+
+    UINT Release()
+    {
+        const UINT references = --m_References;
+        if (references == 0)
+        {
+            delete this;
+        }
+        return references;
+    }
+
+private:
+    std::atomic<UINT> m_References = 1;
+};
+
+struct D3D11_TEXTURE2D_DESC
+{
+    UINT Width;
+    UINT Height;
+    UINT MipLevels;
+    UINT ArraySize;
+    DXGI_FORMAT Format;
+};
+
+struct D3D11_BUFFER_DESC
+{
+    UINT ByteWidth;
+};
+
+class ID3D11Resource : public StubUnknown
+{
+};
+
+class ID3D11Texture2D : public ID3D11Resource
+{
+public:
+    ID3D11Texture2D(const D3D11_TEXTURE2D_DESC& desc) : m_Desc(desc) {}
+
+    void GetDesc(D3D11_TEXTURE2D_DESC* desc) { *desc = m_Desc; }
+
+private:
+    D3D11_TEXTURE2D_DESC m_Desc;
+};
+
+class ID3D11Buffer : public ID3D11Resource
+{
+public:
+    ID3D11Buffer(const D3D11_BUFFER_DESC& desc) : m_Desc(desc) {}
+
+    void GetDesc(D3D11_BUFFER_DESC* desc) { *desc = m_Desc; }
+
+private:
+    D3D11_BUFFER_DESC m_Desc;
+};
+
+class ID3D11ShaderResourceView : public StubUnknown
+{
+public:
+    /**
+     * \param resource The viewed resource. The view holds a reference to it.
+     */
+    ID3D11ShaderResourceView(ID3D11Resource* resource) : m_Resource(resource)
+    {
+        m_Resource->AddRef();
+    }
+
+    ~ID3D11ShaderResourceView()
+    {
+        m_Resource->Release();
+    }
+
+    void GetResource(ID3D11Resource** resource)
+    {
+        m_Resource->AddRef();
+        *resource = m_Resource;
+    }
+
+private:
+    ID3D11Resource* m_Resource;
+};
+
+class ID3D11InputLayout : public StubUnknown
+{
+};
@@ -0,0 +1,10 @@
+#pragma once
+#include "d3d11_1.h"
+
+//Effects 11 Stubs
+//A stand-in for the effect type the resource pool holds. See d3d11_1.h.
+//Ewan Burnett - 2022
+
+class ID3DX11Effect : public StubUnknown
+{
+};
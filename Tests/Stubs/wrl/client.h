@@ -0,0 +1,98 @@
+#pragma once
+#include "../d3d11_1.h"
+#include <cstddef>
+
+//WRL Stubs
+//A stand-in for ComPtr, holding a reference to one of the stubbed device types. See d3d11_1.h.
+//Ewan Burnett - 2022
+
+namespace Microsoft::WRL
+{
+    template<typename T>
+    class ComPtr
+    {
+    public:
+        ComPtr() = default;
+        ComPtr(std::nullptr_t) {}
+
+        template<typename U>
+        ComPtr(U* ptr) : m_Ptr(ptr)
+        {
+            InternalAddRef();
+        }
+
+        ComPtr(const ComPtr& other) : m_Ptr(other.m_Ptr)
+        {
+            InternalAddRef();
+        }
+
+        ComPtr(ComPtr&& other) noexcept : m_Ptr(other.m_Ptr)
+        {
+            other.m_Ptr = nullptr;
+        }
+
+        ~ComPtr()
+        {
+            InternalRelease();
+        }
+
+        ComPtr& operator=(ComPtr other)
+        {
+            T* ptr = m_Ptr;
+            m_Ptr = other.m_Ptr;
+            other.m_Ptr = ptr;
+            return *this;
+        }
+
+        T* Get() const { return m_Ptr; }
+        T* operator->() const { return m_Ptr; }
+
+        T** GetAddressOf() { return &m_Ptr; }
+
+        T** ReleaseAndGetAddressOf()
+        {
+            InternalRelease();
+            return &m_Ptr;
+        }
+
+        /**
+         * \brief Queries for another interface, as QueryInterface would.
+         */
+        template<typename U>
+        HRESULT As(ComPtr<U>* other) const
+        {
+            U* ptr = dynamic_cast<U*>(m_Ptr);
+            if (ptr == nullptr)
+            {
+                return E_NOINTERFACE;
+            }
+
+            *other = ComPtr<U>(ptr);
+            return S_OK;
+        }
+
+        bool operator==(std::nullptr_t) const { return m_Ptr == nullptr; }
+        explicit operator bool() const { return m_Ptr != nullptr; }
+
+    private:
+        void InternalAddRef()
+        {
+            if (m_Ptr != nullptr)
+            {
+                m_Ptr->AddRef();
+            }
+        }
+
+        void InternalRelease()
+        {
+            if (m_Ptr != nullptr)
+            {
+                T* ptr = m_Ptr;
+                m_Ptr = nullptr;
+                ptr->Release();
+            }
+        }
+
+        T* m_Ptr = nullptr;
+    };
+}
@@ -0,0 +1,15 @@
+#pragma once
+#include <cstdio>
+
+//Test
+//A minimal harness for the headless tests. Failed checks are reported with their location, and the test's
+//exit code is the number of failures, so that CTest reports the test as failed.
+//Ewan Burnett - 2022
+
+namespace Test
+{
+    inline int Failures = 0;
+}
+
+#define CHECK(x) { if(!(x)) { printf("%s(%d): CHECK(%s) failed\n", __FILE__, __LINE__, #x); Test::Failures++; } }
+#define CHECK_MSG(x, ...) { if(!(x)) { printf("%s(%d): CHECK(%s) failed: ", __FILE__, __LINE__, #x); printf(__VA_ARGS__); printf("\n"); Test::Failures++; } }
@@ -0,0 +1,116 @@
+#include "Graphics/Text.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <string>
+
+//Text Layout Benchmark
+//Times laying out a 10k character string into a new mesh, and again into the mesh's existing storage,
+//then times Text::SetText() rebuilding the string after edits at its end, middle and start,
+//with a proportional, kerned font and with a fixed-advance font.
+//Ewan Burnett - 2022
+
+using namespace Engine;
+
+static constexpr uint32_t CHARACTER_COUNT = 10000;
+static constexpr uint32_t RUN_COUNT = 50;
+
+/**
+ * \brief A font with a glyph for each printable ASCII character. Proportional fonts have varying advances and a few kerning pairs.
+ */
+static Font MakeFont(bool proportional)
+{
+    Font font;
+    font.Size = { 512.0f, 512.0f };
+    for (uint32_t id = 32; id < 127; id++)
+    {
+        const int16_t advance = proportional ? (int16_t)(6 + id % 7) : 8;
+        font.AddGlyph(id, { (id % 16) / 16.0f, (id / 16) / 16.0f, 1.0f / 16.0f, 1.0f / 16.0f, 0, 0, advance });
+    }
+
+    if (proportional)
+    {
+        for (const char* pair : { "AV", "AW", "Te", "To", "Ty", "VA", "Wa", "Yo", "av", "ye" })
+        {
+            font.AddKerning((uint8_t)pair[0], (uint8_t)pair[1], -1);
+        }
+    }
+
+    return font;
+}
+
+/**
+ * \brief Builds a string of words, as a paragraph of UI text would be.
+ */
+static std::basic_string<char> MakeString()
+{
+    static const char* WORDS[] = { "Tomorrow", "Yesterday", "AVAILABLE", "a", "wave", "of", "text", "eye", "To", "layout" };
+
+    std::basic_string<char> text;
+    for (uint32_t i = 0; text.length() < CHARACTER_COUNT; i++)
+    {
+        text.append(WORDS[(i * 7) % 10]);
+        text.push_back(' ');
+    }
+    text.resize(CHARACTER_COUNT);
+    return text;
+}
+
+/**
+ * \brief Times a function, returning the best of several runs, in microseconds. The setup isn't timed.
+ */
+static double Time(const std::function<void()>& setup, const std::function<void()>& run)
+{
+    double best = 1e9;
+    for (uint32_t i = 0; i < RUN_COUNT; i++)
+    {
+        setup();
+        const auto start = std::chrono::steady_clock::now();
+        run();
+        best = std::min(best, std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+    }
+    return best;
+}
+
+static void Run(const char* name, bool proportional)
+{
+    Font font = MakeFont(proportional);
+    const std::basic_string<char> text = MakeString();
+
+    //BuildMesh, into a new mesh and into one which already has the storage
+    MeshFilter mesh;
+    const double first = Time([&] { mesh = {}; }, [&] { Text::BuildMesh(font, text, { 0.0f, 0.0f }, mesh); });
+    const double rebuild = Time([] {}, [&] { Text::BuildMesh(font, text, { 0.0f, 0.0f }, mesh); });
+
+    //SetText, from an edit at each end and in the middle. Same length edits are rewritten in place by fixed-advance fonts.
+    std::basic_string<char> edited[3] = { text, text, text };
+    edited[0][CHARACTER_COUNT - 1] = '!';
+    edited[1][CHARACTER_COUNT / 2] = '!';
+    edited[2][0] = '!';
+
+    const double setFirst = Time([] {}, [&] { Text t(text, font, { 0.0f, 0.0f }); });
+
+    Text t(text, font, { 0.0f, 0.0f });
+    double setEdited[3];
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        setEdited[i] = Time([&] { t.SetText(text); }, [&] { t.SetText(edited[i]); });
+    }
+
+    //Appending a line, as a log or chat window would
+    const std::basic_string<char> appended = text + " and one more line";
+    const double setAppended = Time([&] { t.SetText(text); }, [&] { t.SetText(appended); });
+
+    printf("%s, %u characters, %zu glyphs:\n", name, CHARACTER_COUNT, mesh.Indices.size() / 6);
+    printf("    BuildMesh: %.1fus into a new mesh, %.1fus into the existing mesh\n", first, rebuild);
+    printf("    SetText: %.1fus to construct, %.1fus after editing the end, %.1fus the middle, %.1fus the start, %.1fus after appending (best of %u)\n",
+        setFirst, setEdited[0], setEdited[1], setEdited[2], setAppended, RUN_COUNT);
+}
+
+int main()
+{
+    Run("Proportional", true);
+    Run("Fixed advance", false);
+    return 0;
+}
@@ -0,0 +1,112 @@
+#include "Graphics/UploadRing.h"
+#include "Test.h"
+#include <random>
+#include <vector>
+
+//Upload Ring Test
+//Fuzzes the ring with random allocations over many frames, and checks that no allocation which is still
+//in flight is ever overlapped, and that every byte is freed once its frame is retired.
+//Ewan Burnett - 2022
+
+using namespace Engine;
+
+static constexpr uint64_t FRAME_COUNT = 5000;
+static constexpr uint64_t FRAMES_IN_FLIGHT = 3;
+
+struct Allocation
+{
+    uint32_t Offset;
+    uint32_t Size;
+    uint64_t Frame;
+};
+
+static void TestFuzz(uint32_t capacity, std::mt19937& rng)
+{
+    UploadRing ring(capacity);
+    std::vector<Allocation> live;
+    uint32_t allocated = 0;
+
+    for (uint64_t frame = 1; frame <= FRAME_COUNT; frame++)
+    {
+        const uint32_t count = rng() % 8;
+        for (uint32_t i = 0; i < count; i++)
+        {
+            //Strides needn't be powers of two
+            const uint32_t size = 1 + rng() % (capacity / 6);
+            const uint32_t alignment = rng() % 3 == 0 ? 20 : 4;
+
+            uint32_t offset = 0;
+            if (!ring.Allocate(size, alignment, offset))
+            {
+                continue;
+            }
+            allocated++;
+
+            CHECK_MSG(offset % alignment == 0, "offset %u, alignment %u", offset, alignment);
+            CHECK_MSG(offset + size <= capacity, "offset %u, size %u, capacity %u", offset, size, capacity);
+            for (const auto& other : live)
+            {
+                CHECK_MSG(offset >= other.Offset + other.Size || other.Offset >= offset + size,
+                    "[%u, %u) overlaps [%u, %u) from frame %llu", offset, offset + size, other.Offset, other.Offset + other.Size, (unsigned long long)other.Frame);
+            }
+
+            live.push_back({ offset, size, frame });
+        }
+
+        ring.EndFrame(frame);
+        if (frame > FRAMES_IN_FLIGHT)
+        {
+            const uint64_t retired = frame - FRAMES_IN_FLIGHT;
+            ring.Retire(retired);
+            std::erase_if(live, [retired](const Allocation& a) { return a.Frame <= retired; });
+        }
+
+        //Padding counts as used, so the ring never reports less than is live
+        uint32_t size = 0;
+        for (const auto& a : live)
+        {
+            size += a.Size;
+        }
+        CHECK(ring.GetUsed() >= size);
+    }
+
+    CHECK(allocated > FRAME_COUNT);
+
+    //Retiring every frame frees the whole ring
+    ring.Retire(UINT64_MAX);
+    CHECK_MSG(ring.GetUsed() == 0, "%u bytes leaked", ring.GetUsed());
+    CHECK(!ring.HasFramesInFlight());
+
+    uint32_t offset = 0;
+    CHECK(ring.Allocate(capacity, 1, offset));
+}
+
+static void TestLimits()
+{
+    UploadRing ring(100);
+    uint32_t offset = 0;
+
+    CHECK(!ring.Allocate(101, 1, offset));
+    CHECK(ring.Allocate(100, 1, offset) && offset == 0);
+    CHECK(!ring.Allocate(1, 1, offset));
+
+    //Space is only reused once its frame is retired
+    ring.EndFrame(1);
+    CHECK(ring.HasFramesInFlight() && ring.GetOldestFence() == 1);
+    CHECK(!ring.Allocate(60, 1, offset));
+    ring.Retire(1);
+    CHECK(ring.Allocate(60, 1, offset));
+}
+
+int main()
+{
+    std::mt19937 rng(1);
+    for (uint32_t capacity : { 1000u, 4096u, 65536u })
+    {
+        TestFuzz(capacity, rng);
+    }
+
+    TestLimits();
+
+    return Test::Failures;
+}
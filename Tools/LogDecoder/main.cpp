@@ -0,0 +1,39 @@
+//Log Decoder
+//Converts a binary log, written with ELogFormat::Binary, back into text.
+//Usage: LogDecoder [Log.bin] [Log.txt]. Writes to the console when no output is given.
+//Ewan Burnett - 2022
+
+#include "IO/LogFormat.h"
+#include <fstream>
+#include <iostream>
+
+int main(int argc, char** argv)
+{
+    const char* inputPath = argc > 1 ? argv[1] : "Log.bin";
+
+    std::ifstream input(inputPath, std::ios::binary);
+    if (!input)
+    {
+        std::cerr << "Unable to open " << inputPath << "\n";
+        return 1;
+    }
+
+    std::ofstream output;
+    if (argc > 2)
+    {
+        output.open(argv[2]);
+        if (!output)
+        {
+            std::cerr << "Unable to open " << argv[2] << "\n";
+            return 1;
+        }
+    }
+
+    if (!Engine::LogFormat::Decode(input, argc > 2 ? output : std::cout))
+    {
+        std::cerr << "\n" << inputPath << " is not a valid binary log, or is truncated\n";
+        return 1;
+    }
+
+    return 0;
+}